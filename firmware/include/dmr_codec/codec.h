@@ -32,6 +32,7 @@
 #include "hardware/HR-C6000.h"
 
 #include "functions/sound.h"
+#include "interfaces/clockManager.h"
 
 
 
@@ -53,6 +54,30 @@
 #define AMBE_ENCODE 0x00054F94;
 #define AMBE_ENCODE_ECC 0x0005534C;
 
+// Codec task: the HR-C6000 side only queues and dequeues whole DMR frames (3 AMBE blocks, AMBE_AUDIO_LENGTH bytes).
+#define CODEC_QUEUE_LENGTH                3
+#define CODEC_WAV_BUFFERS_PER_FRAME       6 // A DMR frame holds 60ms of audio
+#define CODEC_TASK_IDLE_WAIT_MS          20 // Longest wait for a request, so the watchdog sees the task alive
+#define CODEC_TASK_STACK_SIZE          5000 // Bytes. The codec ran on the 5000 bytes hrc6000 stack, see codecStats.stackFreeMin
+
+// Encode and decode cycle counts are per DMR frame, stored for the clock level in use (CLOCK_MANAGER_LEVEL_xxx)
+// Read by the CPS (CPS_ACCESS_CODEC_STATS)
+typedef struct
+{
+	uint32_t structVersion;
+	uint32_t encodedFrames;
+	uint32_t decodedFrames;
+	uint32_t decodeDrops;                                  // received frames discarded, decoding queue full
+	uint32_t encodeLastCycles[CLOCK_MANAGER_LEVELS_NUM];
+	uint32_t encodeMaxCycles[CLOCK_MANAGER_LEVELS_NUM];
+	uint32_t decodeLastCycles[CLOCK_MANAGER_LEVELS_NUM];
+	uint32_t decodeMaxCycles[CLOCK_MANAGER_LEVELS_NUM];
+	uint32_t stackFreeMin;                                 // bytes of the codec task stack never used so far
+} codecStats_t;
+
+extern Task_t codecTask;
+extern codecStats_t codecStats;
+
 extern uint8_t ambebuffer_decode[CODEC_DECODE_CONFIG_DATA_LENGTH];
 extern uint8_t ambebuffer_encode[CODEC_ENCODE_CONFIG_DATA_LENGTH];
 extern uint8_t ambebuffer_encode_ecc[CODEC_ECC_CONFIG_DATA_LENGTH];
@@ -65,4 +90,11 @@ void codecDecode(uint8_t *indata_ptr, int numbBlocks);
 void codecEncode(uint8_t *outdata_ptr, int numbBlocks);
 void codecEncodeBlock(uint8_t *outdata_ptr);
 
+bool codecInitTask(void);
+void codecFlushQueues(void);
+bool codecDecodeFramePut(const uint8_t *frame);
+int codecDecodeFramesPending(void);
+void codecEncodeRequest(void);
+bool codecEncodedFrameGet(uint8_t *frame);
+
 #endif /* _OPENGD77_CODEC_H_ */
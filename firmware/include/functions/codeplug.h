@@ -31,6 +31,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "functions/nameIndex.h"
 
 extern const int CODEPLUG_ADDR_CHANNEL_HEADER_EEPROM;
 
@@ -75,6 +76,7 @@ extern const int VFO_SWEEP_SCAN_RANGE_SAMPLE_STEP_TABLE[7];
 
 #define CODEPLUG_CONTACTS_MIN                                       1
 #define CODEPLUG_CONTACTS_MAX                                    1024
+#define CODEPLUG_CONTACTS_NAME_KEYS_MAX                             NAME_INDEX_KEYS_MAX // Name prefix length, in keypad keys, of the contacts names index
 
 #define CODEPLUG_RX_GROUPLIST_MAX                                  76
 
@@ -319,7 +321,8 @@ typedef enum
 	CODEPLUG_CUSTOM_DATA_TYPE_NONE = 0,
 	CODEPLUG_CUSTOM_DATA_TYPE_IMAGE,
 	CODEPLUG_CUSTOM_DATA_TYPE_BEEP,
-	CODEPLUG_CUSTOM_DATA_SATELLITE_TLE
+	CODEPLUG_CUSTOM_DATA_SATELLITE_TLE,
+	CODEPLUG_CUSTOM_DATA_TYPE_LANGUAGE_PACK
 } codeplugCustomDataType_t;
 
 /*
@@ -336,6 +339,8 @@ bool codeplugChannelIsFlagSet(struct_codeplugChannel_t *channelBuf, ChannelFlag_
 void codeplugChannelSetFlag(struct_codeplugChannel_t *channelBuf, ChannelFlag_t flag, bool enabled);
 void codeplugChannelGetDataWithOffsetAndLengthForIndex(int index, struct_codeplugChannel_t *channelBuf, uint8_t offset, int length);
 void codeplugChannelGetDataForIndex(int index, struct_codeplugChannel_t *channelBuf);
+void codeplugChannelCacheInvalidate(void);
+void codeplugChannelCacheGetStats(uint32_t *hits, uint32_t *misses);
 void codeplugUtilConvertBufToString(char *codeplugBuf,char *outBuf,int len);
 void codeplugUtilConvertStringToBuf(char *inBuf,char *outBuf,int len);
 uint32_t byteSwap32(uint32_t n);
@@ -345,6 +350,7 @@ uint16_t codeplugCSSToInt(uint16_t css);
 uint16_t codeplugIntToCSS(uint16_t i);
 
 bool codeplugRxGroupGetDataForIndex(int index, struct_codeplugRxGroup_t *rxGroupBuf);
+bool codeplugRxGroupContainsTG(int index, uint32_t tg, bool *isMember);
 
 bool codeplugContactGetDataForIndex(int index, struct_codeplugContact_t *contact);
 bool codeplugDTMFContactGetDataForIndex(int index, struct_codeplugDTMFContact_t *contact);
@@ -364,6 +370,8 @@ CodeplugCSSTypes_t codeplugGetCSSType(uint16_t tone);
 int codeplugDTMFContactsGetCount(void);
 int codeplugContactsGetCount(uint32_t callType);
 int codeplugContactGetDataForNumberInType(int number, uint32_t callType, struct_codeplugContact_t *contact);
+void codeplugContactsPrefetchWindowInType(int number, int count, uint32_t callType);
+int codeplugContactsFindNumberByNamePrefixInType(const char *keys, int numKeys, uint32_t callType);
 int codeplugDTMFContactGetDataForNumber(int number, struct_codeplugDTMFContact_t *contact);
 int codeplugContactIndexByTGorPCFromNumber(int number, uint32_t tgorpc, uint32_t callType, struct_codeplugContact_t *contact, uint8_t optionalTS);
 int codeplugContactIndexByTGorPC(uint32_t tgorpc, uint32_t callType, struct_codeplugContact_t *contact, uint8_t optionalTS);
@@ -373,9 +381,12 @@ int codeplugContactGetFreeIndex(void);
 bool codeplugContactGetRXGroup(int index);
 void codeplugInitChannelsPerZone(void);
 bool codeplugGetOpenGD77CustomData(codeplugCustomDataType_t dataType, uint8_t *dataBuf);
+bool codeplugFindNextOpenGD77CustomData(codeplugCustomDataType_t dataType, int *blockAddress, int *dataLength);
 
 void codeplugAllChannelsInitCache(void);
 void codeplugInitCaches(void);
+bool codeplugContactsCacheIsReady(void);
+bool codeplugContactsCacheBuildStep(int count);
 
 bool codeplugContactsContainsPC(uint32_t pc);
 bool codeplugGetGeneralSettings(struct_codeplugGeneralSettings_t *generalSettingsBuffer);
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _OPENGD77_NAME_INDEX_H_
+#define _OPENGD77_NAME_INDEX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Keypad name prefix index: a sorted array of 32 bits entries made of a group (e.g. the contact call type),
+// the keypad keys of the name prefix ('2' for 'a', 'b', 'c', ...; 4 bits per key, 0xF after the end of the name)
+// and an id (e.g. the contact index). As it's sorted, the ids of a group with a given prefix are contiguous.
+#define NAME_INDEX_KEYS_MAX                   4
+#define NAME_INDEX_GROUP_SHIFT               27 // 5 bits
+#define NAME_INDEX_KEYS_SHIFT                11
+#define NAME_INDEX_ID_MASK                0x7FF // 11 bits
+#define NAME_INDEX_KEY_NONE                0x0F
+
+typedef struct
+{
+	uint32_t *entries;
+	int       count;
+	int       capacity;
+} nameIndex_t;
+
+// Reads the name at position (in names order) of a sorted list, for nameIndexSearchSorted()
+typedef bool (*nameIndexReadName_t)(void *context, uint32_t position, char *name, int nameLength);
+
+uint32_t nameIndexCharToKey(char c);
+void nameIndexInit(nameIndex_t *index, uint32_t *entries, int capacity);
+bool nameIndexAdd(nameIndex_t *index, uint32_t group, const char *name, int id);
+void nameIndexRemove(nameIndex_t *index, int id);
+int nameIndexFindByKeys(const nameIndex_t *index, uint32_t group, const char *keys, int numKeys);
+int32_t nameIndexSearchSorted(uint32_t count, const char *prefix, nameIndexReadName_t readName, void *context);
+
+#endif /* _OPENGD77_NAME_INDEX_H_ */
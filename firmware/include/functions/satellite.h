@@ -50,6 +50,21 @@ typedef struct
 
 
 
+// Pass tracks are cached as a polyline of packed integer Az / El points, sampled every stepSecs from AOS
+#define SATELLITE_TRACK_MAX_POINTS				24
+#define SATELLITE_TRACK_MIN_STEP_SECS			30
+#define SATELLITE_TRACK_PACK_POINT(az, el)		((uint16_t)(((az) & 0x1FF) | (((el) & 0x7F) << 9)))
+#define SATELLITE_TRACK_POINT_AZ(p)				((p) & 0x1FF)
+#define SATELLITE_TRACK_POINT_EL(p)				(((p) >> 9) & 0x7F)
+
+typedef struct
+{
+	time_t_custom	passAOS;// AOS of the pass this track belongs to. 0 if no track is cached
+	uint16_t		stepSecs;
+	uint8_t			numPoints;
+	uint16_t		points[SATELLITE_TRACK_MAX_POINTS];
+} satelliteTrack_t;
+
 typedef struct
 {
 	uint32_t numPasses;
@@ -59,6 +74,7 @@ typedef struct
 	uint32_t selectedPassNumber;
 	bool 	isPredicting;
 	bool	isVisible;
+	satelliteTrack_t track;
 } satellitePredictions_t;
 
 
@@ -174,4 +190,13 @@ bool satelliteTLE2Native(const char *kep0,const char *kep1,const char *kep2,sate
 void satelliteCalculateForDateTimeSecs(const satelliteData_t *satelliteData, time_t_custom dateTimeSecs, satelliteResults_t *currentSatelliteData, satellitePredictionLevel_t predictionLevel);
 bool satellitePredictNextPassFromDateTimeSecs(predictionStateMachineData_t *stateData, const satelliteData_t *satelliteData, time_t startDateTimeSecs, time_t limitDateTimeSecs, int maxIterations, satellitePass_t *nextPass);
 uint16_t satelliteGetMaximumElevation(satelliteData_t *satelliteData, uint32_t passNumber);
+const satelliteTrack_t *satelliteGetPassTrack(const satelliteData_t *satelliteData, uint32_t passNumber);
+
+void satellitePredictionTaskStart(void);
+void satellitePredictionTaskLock(void);
+void satellitePredictionTaskUnlock(void);
+void satellitePredictionTaskReset(uint32_t numSatellites);
+void satellitePredictionTaskKeepAlive(void);
+uint32_t satellitePredictionTaskGetNumPredicted(void);
+bool satellitePredictionTaskHasUpdate(void);
 #endif
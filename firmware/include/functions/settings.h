@@ -122,7 +122,7 @@ typedef struct
 	uint8_t			scanStepTime;
 	uint8_t			currentVFONumber;
 	uint16_t		tsManualOverride;
-	uint8_t			languageIndex;
+	uint8_t			languageIndex;// Language ID, see LANGUAGE_SETTING_FROM_ID()
 	uint8_t			dmrDestinationFilter;
 	uint8_t			dmrCaptureTimeout;
 	uint8_t			dmrCcTsFilter;
@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#ifndef _OPENGD77_SQUELCH_H_
+#define _OPENGD77_SQUELCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Noise values are the AT1846S ones: the lower, the stronger the signal.
+#define SQUELCH_HYSTERESIS            4 // The squelch closes once the filtered noise is over level + hysteresis
+#define SQUELCH_FAST_MARGIN          12 // A raw sample that far from the thresholds acts immediately (no filtering)
+#define SQUELCH_CLOSE_SAMPLES         2 // Consecutive filtered samples over the close threshold needed to close
+#define SQUELCH_MARGINAL_MARGIN       6 // Filtered noise this close to the thresholds is considered as marginal
+
+typedef struct
+{
+	uint16_t noiseFiltered; // x4 fixed point
+	uint8_t  closeCount;
+	bool     primed;
+	bool     open;
+} squelchState_t;
+
+void squelchInit(squelchState_t *sq);
+bool squelchUpdate(squelchState_t *sq, uint8_t noise, uint8_t level);
+bool squelchIsOpen(const squelchState_t *sq);
+bool squelchIsMarginal(const squelchState_t *sq, uint8_t level);
+
+#endif /* _OPENGD77_SQUELCH_H_ */
@@ -36,6 +36,8 @@
 #include "functions/calibration.h"
 #include "functions/codeplug.h"
 
+//#define TRX_RETUNE_TIMING
+
 typedef struct
 {
 	int calTableMinFreq;
@@ -61,6 +63,28 @@ enum DMR_MODE { DMR_MODE_AUTO, DMR_MODE_DMO, DMR_MODE_RMO, DMR_MODE_SFR };
 enum RADIO_FREQUENCY_BAND_NAMES { RADIO_BAND_VHF = 0, RADIO_BAND_220MHz, RADIO_BAND_UHF, RADIO_BANDS_TOTAL_NUM };
 enum TRX_FREQ_BAND { TRX_RX_FREQ_BAND = 0, TRX_TX_FREQ_BAND };
 
+// AT1846S status registers fetched by the radio status sampler
+#define TRX_RADIO_STATUS_RSSI_NOISE   0x01 // reg 0x1b
+#define TRX_RADIO_STATUS_CSS_FLAGS    0x02 // reg 0x1c
+#define TRX_RADIO_STATUS_VOX_MIC      0x04 // reg 0x1a
+
+#define TRX_RADIO_STATUS_MIC_MAX_AGE  20 // ms, the mic level is refreshed on demand when older
+
+// Snapshot of the AT1846S status registers, published by the sampler (double buffered).
+// Values from registers that were not part of the last pass are carried over from the previous snapshot.
+typedef struct
+{
+	uint32_t timestamp;    // ticksGetMillis() of the pass
+	uint32_t sequence;     // incremented on each published snapshot
+	uint8_t  fields;       // TRX_RADIO_STATUS_xxx registers read during the last pass
+	uint8_t  rssi;
+	uint8_t  noise;
+	uint8_t  vox;
+	uint8_t  mic;          // 0.5dB unit
+	uint8_t  cssFlagsH;
+	uint8_t  cssFlagsL;
+} trxRadioStatus_t;
+
 extern const frequencyHardwareBand_t 	RADIO_HARDWARE_FREQUENCY_BANDS[RADIO_BANDS_TOTAL_NUM];
 extern const frequencyBand_t			DEFAULT_USER_FREQUENCY_BANDS[RADIO_BANDS_TOTAL_NUM];
 extern frequencyBand_t					USER_FREQUENCY_BANDS[RADIO_BANDS_TOTAL_NUM];
@@ -79,10 +103,6 @@ extern volatile bool trxTransmissionEnabled;
 extern volatile bool trxIsTransmitting;
 extern uint32_t trxTalkGroupOrPcId;
 extern uint32_t trxDMRID;
-extern volatile uint8_t trxRxSignal;
-extern volatile uint8_t trxRxNoise;
-extern volatile uint8_t trxTxVox;
-extern volatile uint8_t trxTxMic;
 extern calibrationPowerValues_t trxPowerSettings;
 extern int trxCurrentBand[2];
 extern volatile bool txPAEnabled;
@@ -99,6 +119,9 @@ bool trxGetBandwidthIs25kHz(void);
 int trxGetFrequency(void);
 void trxSetModeAndBandwidth(int mode, bool bandwidthIs25kHz);
 void trxSetFrequency(int fRx,int fTx, int dmrMode);
+#if defined(TRX_RETUNE_TIMING)
+void trxGetRetuneTiming(uint32_t *lastCycles, uint32_t *maxCycles);
+#endif
 void trxSetRX(void);
 void trxSetTX(void);
 void trxRxAndTxOff(bool critical);
@@ -120,9 +143,11 @@ bool trxCheckCSSFlag(uint16_t tone);
 bool trxCheckFrequencyInAmateurBand(int tmp_frequency);
 int trxGetBandFromFrequency(int frequency);
 int trxGetNextOrPrevBandFromFrequency(int frequency, bool nextBand);
-void trxReadVoxAndMicStrength(void);
+const trxRadioStatus_t *trxRadioStatusGet(void);
+void trxRadioStatusSample(uint8_t fields);
+bool trxRadioStatusSampleIfOlderThan(uint8_t fields, uint32_t maxAge);
+void trxRadioStatusSamplerTick(void);
 void trxPostponeReadRSSIAndNoise(uint32_t msOverride);
-void trxReadRSSIAndNoise(bool force);
 uint8_t trxGetCalibrationVoiceGainTx(void);
 void trxSelectVoiceChannel(uint8_t channel);
 void trxSetTone1(int toneFreq);
@@ -46,8 +46,6 @@
 void radioInit(void);
 void radioPostinit(void);
 void radioSetMode(void);
-void radioReadVoxAndMicStrength(void);
-void radioReadRSSIAndNoise(void);
 int radioSetClearReg2byteWithMask(uint8_t reg, uint8_t mask1, uint8_t mask2, uint8_t val1, uint8_t val2);
 status_t radioWriteReg2byte(uint8_t reg, uint8_t val1, uint8_t val2);
 status_t radioReadReg2byte(uint8_t reg, uint8_t *val1, uint8_t *val2);
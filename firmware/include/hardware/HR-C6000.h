@@ -56,6 +56,7 @@ extern Task_t hrc6000Task;
 
 extern volatile int slotState;
 extern volatile uint8_t DMR_frame_buffer[DMR_FRAME_BUFFER_SIZE];
+extern const uint8_t SILENCE_AUDIO[AMBE_AUDIO_LENGTH];
 extern volatile bool updateLastHeard;
 extern volatile int dmrMonitorCapturedTS;
 extern volatile ticksTimer_t readDMRRSSITimer;
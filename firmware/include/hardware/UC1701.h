@@ -76,6 +76,8 @@ typedef enum
 #define DISPLAY_SIZE_X                          128
 #define DISPLAY_NUMBER_OF_ROWS  (DISPLAY_SIZE_Y / 8)
 
+//#define DISPLAY_BENCHMARK
+
 
 
 void displayBegin(bool isInverted);
@@ -84,9 +86,13 @@ void displayClearRows(int16_t startRow, int16_t endRow, bool isInverted);
 void displayRenderWithoutNotification(void);
 void displayRender(void);
 void displayRenderRows(int16_t startRow, int16_t endRow);
+void displayInvalidateRows(int16_t startRow, int16_t endRow);
 void displayPrintCentered(uint16_t y, const char *text, ucFont_t fontSize);
 void displayPrintAt(uint16_t x, uint16_t y,const  char *text, ucFont_t fontSize);
 int displayPrintCore(int16_t x, int16_t y, const char *szMsg, ucFont_t fontSize, ucTextAlign_t alignment, bool isInverted);
+#if defined(DISPLAY_BENCHMARK)
+uint32_t displayBenchmarkTextRendering(uint32_t iterations);
+#endif
 
 int16_t displaySetPixel(int16_t x, int16_t y, bool color);
 
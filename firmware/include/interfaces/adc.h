@@ -33,16 +33,12 @@
 #include <task.h>
 #include "fsl_adc16.h"
 
-#define NO_ADC_CHANNEL_OVERRIDE    0
-
 extern const int CUTOFF_VOLTAGE_UPPER_HYST;
 extern const int CUTOFF_VOLTAGE_LOWER_HYST;
 extern const int BATTERY_MAX_VOLTAGE;
-extern const int TEMPERATURE_DECIMAL_RESOLUTION;
 
-void adcTriggerConversion(int channelOverride);
 void adcInit(void);
-void ADC0_IRQHandler(void);
+void adcTick(void);
 int adcGetBatteryVoltage(void);
 int getVOX(void);
 int getTemperature(void);
@@ -105,9 +105,44 @@ extern app_power_mode_t clockManagerCurrentRunMode;
  * */
 enum { CLOCK_MANAGER_SPEED_RUN = 0x0603	 ,CLOCK_MANAGER_SPEED_HS_RUN = 0x0205, CLOCK_MANAGER_RUN_SUSPEND_MODE = 0x1F00, CLOCK_MANAGER_RUN_ECO_POWER_MODE = 0x1F00};
 
+// Governor: while the requested run mode is the RUN one, the clock is raised to HSRUN
+// when a full speed lease (or the CPU load) needs it, then lowered back.
+//
+// As the main, HR-C6000 and beep tasks never block (they loop on vTaskDelay(0) at the same priority), the idle
+// task doesn't run and can't be used to measure the CPU load. Instead, the main, HR-C6000 and codec tasks
+// call clockManagerGovernorBusyBegin()/End() around their actual work, and the load is the part of the window
+// spent in that work (interrupts excluded).
+#define CLOCK_MANAGER_GOVERNOR_WINDOW_MS        200 // CPU load measurement window
+#define CLOCK_MANAGER_GOVERNOR_UP_LOAD           80 // % of load (measured) to switch to HSRUN
+#define CLOCK_MANAGER_GOVERNOR_DOWN_LOAD         65 // % of load (projected to the RUN clock) to switch back to RUN
+#define CLOCK_MANAGER_GOVERNOR_DOWN_WINDOWS       5 // consecutive windows under the DOWN load needed to switch back
+
+enum { CLOCK_MANAGER_LEASE_TX = 0, CLOCK_MANAGER_LEASE_SATELLITE, CLOCK_MANAGER_LEASES_NUM };
+enum { CLOCK_MANAGER_LEVEL_LOW_POWER = 0, CLOCK_MANAGER_LEVEL_RUN, CLOCK_MANAGER_LEVEL_HS_RUN, CLOCK_MANAGER_LEVELS_NUM };
+
+typedef struct
+{
+	uint32_t structVersion;
+	uint32_t switchCount;
+	uint32_t timeInLevel[CLOCK_MANAGER_LEVELS_NUM]; // milliseconds
+	uint32_t lastSwitchLatencyUs;
+	uint32_t maxSwitchLatencyUs;
+	uint8_t  level;                                 // current CLOCK_MANAGER_LEVEL_xxx
+	uint8_t  loadPercent;                           // CPU load of the last window
+	uint8_t  leases;                                // held leases bitmask
+	uint8_t  reserved;
+} clockManagerStats_t;
+
+extern clockManagerStats_t clockManagerStats;
+
 void clockManagerInit(void);
 void clockManagerSetRunMode(uint8_t targetConfigIndex, uint32_t clockSpeedSetting);
 uint32_t clockManagerGetRunMode(void);
+void clockManagerGovernorTick(void);
+void clockManagerGovernorBusyBegin(void);
+void clockManagerGovernorBusyEnd(void);
+void clockManagerLeaseFullSpeed(uint8_t lease, uint32_t durationMs);
+void clockManagerLeaseRelease(uint8_t lease);
 
 
 #endif /* _POWER_MANAGER_H_ */
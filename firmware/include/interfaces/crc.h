@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef _OPENGD77_CRC_H_
+#define _OPENGD77_CRC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// The MCU CRC module is used, unless CRC_SOFTWARE_BACKEND is defined (table driven).
+// Only one update can run at once, hence the CRC functions must not be called from an ISR.
+
+typedef enum
+{
+	CRC_TYPE_CCITT16 = 0, // CRC-16/CCITT-FALSE: poly 0x1021, init 0xFFFF, not reflected
+	CRC_TYPE_CRC32        // CRC-32 (IEEE 802.3, zlib): poly 0x04C11DB7, init 0xFFFFFFFF, reflected, final XOR
+} crcType_t;
+
+typedef struct
+{
+	crcType_t type;
+	uint32_t  value; // Running CRC, in the backend's own format
+} crcContext_t;
+
+void crcInit(void);
+void crcStart(crcContext_t *context, crcType_t type);
+void crcUpdate(crcContext_t *context, const uint8_t *data, uint32_t length);
+uint32_t crcFinish(crcContext_t *context);
+uint32_t crcCompute(crcType_t type, const uint8_t *data, uint32_t length);
+
+uint8_t crcDMREmbeddedLCChecksum(const uint8_t *data);
+
+#endif /* _OPENGD77_CRC_H_ */
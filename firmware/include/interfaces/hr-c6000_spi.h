@@ -149,6 +149,25 @@
 
 #endif
 
+#define SPI_ASYNC_MAX_LENGTH          32 // Data bytes, page and register excluded
+#define SPI_ASYNC_QUEUE_LENGTH         3
+
+typedef enum { SPI_BUS_0 = 0, SPI_BUS_1, SPI_BUSES_NUM } spiBus_t;
+
+// Called from the SPI interrupt (or from SPIAsyncFlush()) once the transfer is completed
+typedef void (*spiAsyncCallback_t)(status_t status, void *userData);
+
+typedef struct
+{
+	uint32_t transfers;
+	uint32_t bytes;
+	uint32_t collisions;  // Bus already in use (transfer refused), or blocking transfer waiting for the async queue
+	uint32_t queueFull;   // Async transfer had to wait for the queue to be drained
+	uint32_t busTimeUs;
+} spiBusStats_t;
+
+extern spiBusStats_t spiBusStats[SPI_BUSES_NUM];
+
 void SPIInit(void);
 
 int SPI0WritePageRegByte(uint8_t page, uint8_t reg, uint8_t val);
@@ -160,6 +179,9 @@ int SPI0ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values
 int SPI1WritePageRegByteArray(uint8_t page, uint8_t reg, const uint8_t *values, uint8_t length);
 int SPI1ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values, uint8_t length);
 
+int SPIWritePageRegByteArrayAsync(spiBus_t bus, uint8_t page, uint8_t reg, const uint8_t *values, uint8_t length, spiAsyncCallback_t callback, void *userData);
+void SPIAsyncFlush(spiBus_t bus);
+
 void SPI0Setup(void);
 void SPI1Setup(void);
 
@@ -34,6 +34,8 @@
 
 #include "fsl_pit.h"
 
+#define PIT_ADC_TRIGGER_PERIOD_US    333U // 3 ADC channels sampled every ms
+
 extern volatile uint32_t timer_maintask;
 extern volatile uint32_t timer_beeptask;
 extern volatile uint32_t timer_hrc6000task;
@@ -35,19 +35,64 @@
 
 #define TASK_FLAGGED_ALIVE  5
 
+#define WATCHDOG_REFRESH_PERIOD_MS    100
+#define WATCHDOG_DEADLINE_MS          (TASK_FLAGGED_ALIVE * WATCHDOG_REFRESH_PERIOD_MS) // The hardware watchdog isn't refreshed anymore past this delay
+#define WATCHDOG_SOFT_WARNING_MS       50 // Near-miss: alive interval long enough to break the audio
+#define WATCHDOG_HISTOGRAM_BINS        10
+#define WATCHDOG_MONITORED_TASKS        4
+#define WATCHDOG_TASK_NAME_LENGTH      16
+
+// Alive interval statistics (milliseconds)
+typedef struct
+{
+	uint32_t count;
+	uint32_t maxInterval;
+	uint32_t warnings;                             // intervals >= WATCHDOG_SOFT_WARNING_MS
+	uint32_t misses;                               // intervals >= WATCHDOG_DEADLINE_MS
+	uint32_t histogram[WATCHDOG_HISTOGRAM_BINS];   // see watchdogHistogramBinLimits[]
+} watchdogTaskStats_t;
+
 typedef struct
 {
 	TaskHandle_t   Handle;
 	volatile bool  Running; // Not Suspended
 	volatile uint8_t  AliveCount;
+	volatile uint32_t LastAliveTime;
+	watchdogTaskStats_t Stats;
 } Task_t;
 
+typedef struct
+{
+	char     name[WATCHDOG_TASK_NAME_LENGTH]; // Not NULL terminated if 16 chars long
+	uint32_t count;
+	uint32_t maxInterval;
+	uint32_t p99Interval;
+	uint32_t warnings;
+	uint32_t misses;
+	uint32_t histogram[WATCHDOG_HISTOGRAM_BINS];
+} watchdogTaskReport_t;
+
+// Read by the CPS (CPS_ACCESS_WATCHDOG_STATS)
+typedef struct
+{
+	uint32_t             structVersion;
+	uint16_t             histogramBinLimits[WATCHDOG_HISTOGRAM_BINS];
+	watchdogTaskReport_t tasks[WATCHDOG_MONITORED_TASKS];
+	char                 worstStallTaskName[WATCHDOG_TASK_NAME_LENGTH];
+	uint32_t             worstStallPC;
+	uint32_t             worstStallDuration;
+	uint32_t             worstStallTime;   // ticksGetMillis() when captured
+} watchdogReport_t;
+
 
 void watchdogInit(void);
 void watchdogRun(bool run);
 void watchdogReboot(void);
 void watchdogRebootNow(void);
 void watchdogTick(void);
+void watchdogTaskStart(Task_t *task);
+void watchdogTaskAlive(Task_t *task);
+void watchdogGetReport(watchdogReport_t *report);
 uint32_t GetTimerOutputValue(void);
 
 #endif /* _OPENGD77_WDOG_H_ */
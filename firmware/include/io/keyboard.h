@@ -90,7 +90,7 @@
 #define EVENT_KEY_NONE   0
 #define EVENT_KEY_CHANGE 1
 
-#define KEY_DEBOUNCE_COUNTER   20
+#define KEY_DEBOUNCE_DELAY     16 // ms, plus the 4ms of the matrix scan
 
 //#define KEYCHECK(keys,k) (((keys) & 0xffffff) == (k))
 //#define KEYCHECK_KEYMOD(keys, k, mask, mod) (((((keys) & 0xffffff) == (k)) && ((keys) & (mask)) == (mod)))
@@ -126,5 +126,8 @@ bool keyboardKeyIsDTMFKey(char key);
 uint32_t keyboardRead(void);
 void keyboardCheckKeyEvent(keyboardCode_t *keys, int *event);
 bool keyboardScanKey(uint32_t scancode, char *keycode);
+#if ! defined(PLATFORM_GD77S)
+void PORTB_IRQHandler(void);
+#endif
 
 #endif /* _OPENGD77_KEYBOARD_H_ */
@@ -38,7 +38,10 @@
 typedef unsigned int time_t_custom;     /* date/time in unix secs past 1-Jan-70 */
 
 #define MAX_ZONE_SCAN_NUISANCE_CHANNELS       16
-#define NUM_LASTHEARD_STORED                  32
+#define NUM_LASTHEARD_STORED                  96
+#define LASTHEARD_STRINGS_COUNT              192 // Interned strings (contacts, talkgroups and talker aliases) shared by the last heard entries
+#define LASTHEARD_STRINGS_ARENA_SIZE        2304
+#define LASTHEARD_TALKER_ALIAS_LENGTH         32
 
 #if defined(PLATFORM_RD5R)
 #define DISPLAY_H_EXTRA_PIXELS                 0
@@ -281,23 +284,27 @@ typedef struct
 } dmrIdDataStruct_t;
 
 
+// The texts are stored in the last heard strings pool, use lastheardGetContact(), lastheardGetTalkgroup(),
+// lastheardGetTalkerAlias() and lastheardGetLocation() to read them.
 typedef struct LinkItem
 {
     struct LinkItem 	*prev;
     uint32_t 			id;
     uint32_t 			talkGroupOrPcId;
-    char        		contact[MAX_DMR_ID_CONTACT_TEXT_LENGTH];
-    char        		talkgroup[17];
-    char 				talkerAlias[32];// 4 blocks of data. 6 bytes + 7 bytes + 7 bytes + 7 bytes . plus 1 for termination some more for safety.
-    double				locationLat;
-    double				locationLon;
     uint32_t			time;// current system time when this station was heard
+    int16_t				locationLat;// Fixed point, full scale is +/- 90 degrees, LASTHEARD_NO_LOCATION if unknown
+    int16_t				locationLon;// Fixed point, full scale is +/- 180 degrees
+    uint16_t			rxAGCGain;
+    uint8_t				contact;// Strings pool handles, 0 is an empty string
+    uint8_t				talkgroup;
+    uint8_t				talkerAlias;// 4 blocks of data. 6 bytes + 7 bytes + 7 bytes + 7 bytes, up to LASTHEARD_TALKER_ALIAS_LENGTH - 1 chars
     uint8_t				receivedTS;
     uint8_t				dmrMode;
-    uint16_t			rxAGCGain;
     struct LinkItem 	*next;
 } LinkItem_t;
 
+#define LASTHEARD_NO_LOCATION    INT16_MIN
+
 // MessageBox
 #define MESSAGEBOX_MESSAGE_LEN_MAX             ((16 * 3) + 2 /* \n */ + 1 /* \0 */) // Note: 14 char line length for MESSAGEBOX_DECORATION_FRAME
 
@@ -28,13 +28,20 @@
 #ifndef _OPENGD77_UILOCALISATION_H_
 #define _OPENGD77_UILOCALISATION_H_
 
+#include <stdint.h>
+#include <stdbool.h>
 
+// English (and Japanese, which needs its own font) are built in, the other languages are packs, stored
+// in the SPI Flash custom data area (written by the CPS) as CODEPLUG_CUSTOM_DATA_TYPE_LANGUAGE_PACK blocks.
 #if defined(LANGUAGE_BUILD_JAPANESE)
-#define NUM_LANGUAGES 2
+#define NUM_BUILTIN_LANGUAGES 2
 #else
-#define NUM_LANGUAGES 18
+#define NUM_BUILTIN_LANGUAGES 1
 #endif
 
+#define LANGUAGE_PACKS_MAX               24
+#define LANGUAGE_PACK_TEXTS_MAX_LENGTH 3072
+
 #define LANGUAGE_TEXTS_LENGTH 17
 
 typedef struct
@@ -271,36 +278,70 @@ typedef struct
    const char *ta_text;// "Text"
 } stringsTable_t;
 
-extern const stringsTable_t languages[];
-extern const stringsTable_t *currentLanguage;
+#define LANGUAGE_STRINGS_COUNT   (sizeof(stringsTable_t) / sizeof(const char *))
 
-enum languageNamesOrder
+/*
+ * Language IDs. They identify a language whatever the installed packs, and are saved in the settings.
+ * The values up to LANGUAGE_ID_CROATIAN are the indexes of the languages table of the firmwares
+ * which had all the languages built in. Never change the existing values, add new languages at the end.
+ */
+typedef enum
 {
-	englishLanguageName = 0,
-#if defined(LANGUAGE_BUILD_JAPANESE)
-	japaneseLanguageName,
-#else
-	catalanLanguageName,
-	danishLanguageName,
-	frenchLanguageName,
-	deutschGermanLanguageName,
-	italianLanguageName,
-	portuguesLanguageName,
-	spanishLanguageName,
-	suomiFinnishLanguageName,
-	polishLanguageName,
-	turkishLanguageName,
-	czechLanguageName,
-	nederlandsDutchLanguageName,
-	slovenianLanguageName,
-	portuguesBrazilLanguageName,
-	swedishLanguageName,
-	hungarianLanguageName,
-	croatianLanguageName
-#endif
-};
+	LANGUAGE_ID_ENGLISH = 0,
+	LANGUAGE_ID_CATALAN,
+	LANGUAGE_ID_DANISH,
+	LANGUAGE_ID_FRENCH,
+	LANGUAGE_ID_GERMAN,
+	LANGUAGE_ID_ITALIAN,
+	LANGUAGE_ID_PORTUGUESE,
+	LANGUAGE_ID_SPANISH,
+	LANGUAGE_ID_FINNISH,
+	LANGUAGE_ID_POLISH,
+	LANGUAGE_ID_TURKISH,
+	LANGUAGE_ID_CZECH,
+	LANGUAGE_ID_DUTCH,
+	LANGUAGE_ID_SLOVENIAN,
+	LANGUAGE_ID_PORTUGUESE_BRAZIL,
+	LANGUAGE_ID_SWEDISH,
+	LANGUAGE_ID_HUNGARIAN,
+	LANGUAGE_ID_CROATIAN,
+	LANGUAGE_ID_JAPANESE,
+	LANGUAGE_ID_MAX = 0x7F
+} languageId_t;
+
+// The settings hold the language ID with this flag set. Without it, the value was saved by an older firmware,
+// as an index in its languages table.
+#define LANGUAGE_SETTING_ID_FLAG             0x80
+#define LANGUAGE_SETTING_FROM_ID(id)         (LANGUAGE_SETTING_ID_FLAG | (id))
+
+/*
+ * Language pack format (little endian):
+ *  languagePackHeader_t
+ *  uint16_t offsets[stringsCount];  offset of each string (in stringsTable_t order) in the texts
+ *  char     texts[textsLength];     NULL terminated strings
+ *
+ * Strings missing from a pack (older pack, or offset out of range) are taken from English.
+ */
+#define LANGUAGE_PACK_MAGIC      "OGLP"
+
+typedef struct
+{
+	char     magic[4];
+	uint8_t  languageId;// languageId_t
+	uint8_t  reserved;
+	uint16_t stringsCount;
+	uint16_t textsLength;
+} languagePackHeader_t;
+
+extern const stringsTable_t *currentLanguage;
 
-extern const int LANGUAGE_DISPLAY_ORDER[];
+void languagesInit(void);
+int languagesGetCount(void);
+const char *languagesGetName(int index);
+bool languagesSetCurrent(int index);
+uint8_t languagesGetSetting(int index);
+uint8_t languagesSettingFromLegacy(uint8_t setting);
+int languagesGetIndexFromSetting(uint8_t setting);
 
 typedef enum
 {
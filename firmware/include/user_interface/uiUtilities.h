@@ -177,6 +177,7 @@ typedef struct
 	uint8_t				contactLength;
 	uint32_t			slices[ID_SLICES]; // [0] is min availabel ID, [ID_SLICES - 1] is max available ID
 	uint32_t			IDsPerSlice;
+	uint32_t			callsignIndexOffset; // Records area offset of the callsign index, 0 if the database has none
 } dmrIDsCache_t;
 
 
@@ -193,14 +194,21 @@ bool tsIsContactHasBeenOverriddenFromCurrentChannel(void);
 bool isQSODataAvailableForCurrentTalker(void);
 int alignFrequencyToStep(int freq, int step);
 char *chomp(char *str);
-int32_t getFirstSpacePos(char *str);
+int32_t getFirstSpacePos(const char *str);
 void dmrIDCacheInit(void);
+bool dmrIDCacheIsReady(void);
 bool dmrIDLookup(uint32_t targetId, dmrIdDataStruct_t *foundRecord);
+bool dmrIDLookupByCallsignPrefix(const char *prefix, dmrIdDataStruct_t *foundRecord);
 bool contactIDLookup(uint32_t id, uint32_t calltype, char *buffer);
 void uiUtilityRenderQSOData(void);
 void uiUtilityRenderHeader(bool isVFODualWatchScanning, bool isVFOSweepScanning);
 void uiUtilityRedrawHeaderOnly(bool isVFODualWatchScanning, bool isVFOSweepScanning);
 LinkItem_t *lastheardFindInList(uint32_t id);
+const char *lastheardGetContact(const LinkItem_t *item);
+const char *lastheardGetTalkgroup(const LinkItem_t *item);
+const char *lastheardGetTalkerAlias(const LinkItem_t *item);
+bool lastheardGetLocation(const LinkItem_t *item, int32_t *latitude, int32_t *longitude);
+void lastheardSetContact(LinkItem_t *item, const char *text);
 void lastheardInitList(void);
 void lastHeardClearWorkingTAData(void);
 bool lastHeardListUpdate(uint8_t *dmrDataBuffer, bool forceOnHotspot);
@@ -266,8 +274,9 @@ void resetOriginalSettingsData(void);
 struct tm *gmtime_r_Custom(const time_t_custom *__restrict tim_p, struct tm *__restrict res);
 time_t_custom mktime_custom(const struct tm * tb);
 
-uint8_t *coordsToMaidenhead(uint8_t *maidenheadBuffer, double latitude, double longitude);
+uint8_t *coordsToMaidenhead(uint8_t *maidenheadBuffer, int32_t latitude, int32_t longitude);
 double latLongFixedToDouble(uint32_t fixedVal);
-double distanceToLocation(double latitude, double longitude);
+int32_t latLongFixedToMicroDegrees(uint32_t fixedVal);
+uint32_t distanceToLocation(int32_t latitude, int32_t longitude);
 
 #endif
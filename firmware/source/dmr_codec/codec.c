@@ -1241,6 +1241,7 @@ void codecInit(bool fromVoicePrompts)
 	{
 		return;
 	}
+	codecFlushQueues();
 	codecInitInternalBuffers();
 	soundInit();
 }
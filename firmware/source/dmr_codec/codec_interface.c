@@ -30,7 +30,29 @@
 #include "functions/voicePrompts.h"
 #include <string.h>
 
-static uint16_t bitbuffer_encode[72];
+// The encoder outputs one bit per halfword, in bit 0. The words view allows the packing to read two bits per access.
+static union
+{
+	uint16_t bits[72];
+	uint32_t words[36];
+} bitbuffer_encode;
+
+// Packs the 72 encoder output bits, MSB first, into the 9 bytes of an AMBE block.
+// Each word holds two consecutive bits (bit 0 and bit 16, as the MCU is little endian): 4 words are gathered
+// into two nibbles, which are then interleaved.
+static inline void codecPackEncodedBits(const uint32_t *words, uint8_t *outdata_ptr)
+{
+	for (int i = 0; i < 9; i++)
+	{
+		uint32_t nibbles = ((words[0] & 0x00010001U) << 3) | ((words[1] & 0x00010001U) << 2) | ((words[2] & 0x00010001U) << 1) | (words[3] & 0x00010001U);
+
+		nibbles = (nibbles | (nibbles << 2)) & 0x00330033U;
+		nibbles = (nibbles | (nibbles << 1)) & 0x00550055U;
+		outdata_ptr[i] = (uint8_t)((nibbles << 1) | (nibbles >> 16));
+
+		words += 4;
+	}
+}
 
 void codecDecode(uint8_t *indata_ptr, int numbBlocks)
 {
@@ -98,13 +120,12 @@ void codecEncodeBlock(uint8_t *outdata_ptr)
 	register int r1 asm ("r1") __attribute__((unused));
 	register int r2 asm ("r2") __attribute__((unused));
 
-	memset((uint8_t *)outdata_ptr, 0, 9);// fills with zeros
-	memset(bitbuffer_encode, 0, sizeof(bitbuffer_encode));// faster to call memset as it will be compiled as optimised code
+	memset(bitbuffer_encode.bits, 0, sizeof(bitbuffer_encode.bits));// faster to call memset as it will be compiled as optimised code
 
 
 	soundRetrieveBuffer();// gets currentWaveBuffer pointer used as input r2 to the encoder
 
-	r0 = (int)bitbuffer_encode;
+	r0 = (int)bitbuffer_encode.bits;
 	r2 = (int)currentWaveBuffer;//tmp_wavbuffer;
 	r1 = (int)ambebuffer_encode;// seems to be a hard coded (defined) memory address of 0x1FFF6B60. I'm not sure why it has to be hard coded, since its passed as a paramater (register)
 
@@ -127,7 +148,7 @@ void codecEncodeBlock(uint8_t *outdata_ptr)
 
 	soundRetrieveBuffer();// gets currentWaveBuffer pointer used as input r2 to the encoder
 
-	r0 = (int)bitbuffer_encode;
+	r0 = (int)bitbuffer_encode.bits;
 	r2 = (int)currentWaveBuffer;//tmp_wavbuffer;
 	r1 = (int)ambebuffer_encode;
 
@@ -148,7 +169,7 @@ void codecEncodeBlock(uint8_t *outdata_ptr)
 		"POP {R4-R11}"
 	);
 
-	r0 = (int)bitbuffer_encode;
+	r0 = (int)bitbuffer_encode.bits;
 	r1 = (int)ambebuffer_encode_ecc;
 
 	asm volatile (
@@ -162,11 +183,5 @@ void codecEncodeBlock(uint8_t *outdata_ptr)
 		"POP {R4-R11}"
 	);
 
-	for (int i = 0; i < 72; i++)
-	{
-		if (bitbuffer_encode[i] & 1)
-		{
-			outdata_ptr[i >> 3] |= 128 >> (i & 7);
-		}
-	}
+	codecPackEncodedBits(bitbuffer_encode.words, outdata_ptr);
 }
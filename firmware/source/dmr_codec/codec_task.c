@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include "dmr_codec/codec.h"
+#include "functions/voicePrompts.h"
+#include <string.h>
+
+#define CODEC_REQUEST_DECODE   0x01
+#define CODEC_REQUEST_ENCODE   0x02
+
+typedef struct
+{
+	uint8_t      frames[CODEC_QUEUE_LENGTH][AMBE_AUDIO_LENGTH];
+	volatile int readIdx;
+	volatile int count;
+} codecQueue_t;
+
+Task_t codecTask;
+codecStats_t codecStats = { .structVersion = 0x02 };
+
+static __attribute__((section(".data.$RAM2"))) codecQueue_t decodeQueue;
+static __attribute__((section(".data.$RAM2"))) codecQueue_t encodeQueue;
+// Incremented on each flush, a frame that was being encoded at that time is discarded
+static volatile uint32_t queuesGeneration = 0;
+
+// DMR frame being encoded, one AMBE block (2 wave buffers) at a time
+static uint8_t encodeFrame[AMBE_AUDIO_LENGTH];
+static int encodeBlockCount = 0;
+static uint32_t encodeCycles = 0;
+static uint32_t encodeGeneration = 0;
+
+
+static void codecUpdateCycles(uint32_t *lastCycles, uint32_t *maxCycles, uint32_t cycles)
+{
+	uint8_t level = clockManagerStats.level;
+
+	lastCycles[level] = cycles;
+	if (cycles > maxCycles[level])
+	{
+		maxCycles[level] = cycles;
+	}
+}
+
+static void codecTaskDecode(void)
+{
+	bool hasFrame;
+
+	// Each frame is decoded in a critical section, as the timeslot ISR can re-initialise the codec buffers.
+	// It is left between the frames, so the interrupts are not held off for the whole queue.
+	do
+	{
+		taskENTER_CRITICAL();
+		hasFrame = (decodeQueue.count > 0);
+		if (hasFrame)
+		{
+			// voice prompts take priority over incoming DMR audio
+			if ((voicePromptsIsPlaying() == false) && (soundMelodyIsPlaying() == false))
+			{
+				uint32_t startCycles = DWT->CYCCNT;
+
+				codecDecode(decodeQueue.frames[decodeQueue.readIdx], 3);
+				codecUpdateCycles(codecStats.decodeLastCycles, codecStats.decodeMaxCycles, (DWT->CYCCNT - startCycles));
+				codecStats.decodedFrames++;
+			}
+
+			decodeQueue.readIdx = ((decodeQueue.readIdx + 1) % CODEC_QUEUE_LENGTH);
+			decodeQueue.count--;
+		}
+		soundTickRXBuffer();
+		taskEXIT_CRITICAL();
+	} while (hasFrame);
+}
+
+static void codecTaskEncode(void)
+{
+	while ((wavbuffer_count >= 2) && (encodeQueue.count < CODEC_QUEUE_LENGTH))
+	{
+		uint32_t generation = queuesGeneration;
+		uint32_t startCycles;
+
+		if (generation != encodeGeneration)
+		{
+			encodeGeneration = generation;
+			encodeBlockCount = 0;
+			encodeCycles = 0;
+		}
+
+		startCycles = DWT->CYCCNT;
+		codecEncodeBlock(&encodeFrame[encodeBlockCount * (AMBE_AUDIO_LENGTH / 3)]);
+		encodeCycles += (DWT->CYCCNT - startCycles);
+
+		if (++encodeBlockCount == 3)
+		{
+			taskENTER_CRITICAL();
+			if (generation == queuesGeneration)
+			{
+				memcpy(encodeQueue.frames[((encodeQueue.readIdx + encodeQueue.count) % CODEC_QUEUE_LENGTH)], encodeFrame, AMBE_AUDIO_LENGTH);
+				encodeQueue.count++;
+			}
+			taskEXIT_CRITICAL();
+
+			codecUpdateCycles(codecStats.encodeLastCycles, codecStats.encodeMaxCycles, encodeCycles);
+			codecStats.encodedFrames++;
+			encodeBlockCount = 0;
+			encodeCycles = 0;
+		}
+	}
+}
+
+static void codecTaskFunction(void *data)
+{
+	uint32_t requests;
+
+	while (1U)
+	{
+		watchdogTaskAlive(&codecTask);
+
+		if (xTaskNotifyWait(0U, UINT32_MAX, &requests, (CODEC_TASK_IDLE_WAIT_MS / portTICK_PERIOD_MS)) == pdTRUE)
+		{
+			clockManagerGovernorBusyBegin();
+
+			if (requests & CODEC_REQUEST_DECODE)
+			{
+				codecTaskDecode();
+			}
+
+			if (requests & CODEC_REQUEST_ENCODE)
+			{
+				codecTaskEncode();
+			}
+
+			clockManagerGovernorBusyEnd();
+
+			codecStats.stackFreeMin = uxTaskGetStackHighWaterMark(NULL) * sizeof(portSTACK_TYPE);
+		}
+	}
+}
+
+// Returns false if the task couldn't be created (not enough heap), DMR audio can't work then
+bool codecInitTask(void)
+{
+	if (xTaskCreate(codecTaskFunction,          /* pointer to the task */
+			"codecTask",                        /* task name for kernel awareness debugging */
+			CODEC_TASK_STACK_SIZE / sizeof(portSTACK_TYPE), /* task stack size */
+			NULL,                               /* optional task startup argument */
+			3U,                                 /* initial priority */
+			&codecTask.Handle                   /* optional task handle to create */
+	) != pdPASS)
+	{
+		return false;
+	}
+
+	codecTask.Running = true;
+	watchdogTaskStart(&codecTask);
+
+	return true;
+}
+
+// Called by codecInit(), from the tasks or the HR-C6000 ISR
+void codecFlushQueues(void)
+{
+	UBaseType_t savedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+	decodeQueue.readIdx = 0;
+	decodeQueue.count = 0;
+	encodeQueue.readIdx = 0;
+	encodeQueue.count = 0;
+	queuesGeneration++;
+
+	taskEXIT_CRITICAL_FROM_ISR(savedInterruptStatus);
+}
+
+// Queues a received DMR frame (AMBE_AUDIO_LENGTH bytes) for decoding
+bool codecDecodeFramePut(const uint8_t *frame)
+{
+	bool queued = false;
+
+	taskENTER_CRITICAL();
+	if (decodeQueue.count < CODEC_QUEUE_LENGTH)
+	{
+		memcpy(decodeQueue.frames[((decodeQueue.readIdx + decodeQueue.count) % CODEC_QUEUE_LENGTH)], frame, AMBE_AUDIO_LENGTH);
+		decodeQueue.count++;
+		queued = true;
+	}
+	else
+	{
+		codecStats.decodeDrops++;
+	}
+	taskEXIT_CRITICAL();
+
+	if (queued && (codecTask.Handle != NULL))
+	{
+		xTaskNotify(codecTask.Handle, CODEC_REQUEST_DECODE, eSetBits);
+	}
+
+	return queued;
+}
+
+int codecDecodeFramesPending(void)
+{
+	return decodeQueue.count;
+}
+
+// Asks for the pending audio to be encoded. It has to be called periodically while transmitting,
+// the encoding stops as soon as the requests stop.
+void codecEncodeRequest(void)
+{
+	if ((wavbuffer_count >= 2) && (codecTask.Handle != NULL))
+	{
+		xTaskNotify(codecTask.Handle, CODEC_REQUEST_ENCODE, eSetBits);
+	}
+}
+
+// Gets the next encoded DMR frame (AMBE_AUDIO_LENGTH bytes), if any
+bool codecEncodedFrameGet(uint8_t *frame)
+{
+	bool available = false;
+
+	taskENTER_CRITICAL();
+	if (encodeQueue.count > 0)
+	{
+		memcpy(frame, encodeQueue.frames[encodeQueue.readIdx], AMBE_AUDIO_LENGTH);
+		encodeQueue.readIdx = ((encodeQueue.readIdx + 1) % CODEC_QUEUE_LENGTH);
+		encodeQueue.count--;
+		available = true;
+	}
+	taskEXIT_CRITICAL();
+
+	return available;
+}
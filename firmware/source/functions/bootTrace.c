@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <string.h>
+#include "functions/bootTrace.h"
+#include "fsl_clock.h"
+
+bootTrace_t bootTrace = { .structVersion = 0x01, .count = 0 };
+
+static uint32_t lastCycles;
+static uint32_t elapsedMicroseconds;
+
+void bootTraceStart(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	lastCycles = 0;
+	elapsedMicroseconds = 0;
+	bootTrace.count = 0;
+
+	bootTraceMark("START");
+}
+
+void bootTraceMark(const char *name)
+{
+	uint32_t cycles = DWT->CYCCNT;
+
+	// The core clock is changed while booting, the elapsed time is accumulated between each mark
+	elapsedMicroseconds += ((cycles - lastCycles) / (CLOCK_GetFreq(kCLOCK_CoreSysClk) / 1000000U));
+	lastCycles = cycles;
+
+	if (bootTrace.count < BOOT_TRACE_MAX_ENTRIES)
+	{
+		strncpy(bootTrace.entries[bootTrace.count].name, name, BOOT_TRACE_NAME_LENGTH);
+		bootTrace.entries[bootTrace.count].timestamp = elapsedMicroseconds;
+		bootTrace.count++;
+	}
+}
@@ -43,7 +43,7 @@ const int CODEPLUG_ADDR_EX_ZONE_INUSE_PACKED_DATA = 0x8010;
 #define CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE  32
 const int CODEPLUG_ADDR_EX_ZONE_LIST = 0x8030;
 
-const int CODEPLUG_ZONE_MAX_COUNT = 250;
+#define CODEPLUG_ZONE_MAX_COUNT                 250
 const int CODEPLUG_ADDR_CHANNEL_EEPROM = 0x3790;
 const int CODEPLUG_ADDR_CHANNEL_HEADER_EEPROM = 0x3780; // CODEPLUG_ADDR_CHANNEL_EEPROM - 16
 const int CODEPLUG_ADDR_CHANNEL_FLASH = 0x7B1C0;
@@ -111,18 +111,99 @@ typedef struct
 	int numALLContacts;
 	int numDTMFContacts;
 	codeplugContactCache_t contactsLookupCache[CODEPLUG_CONTACTS_MAX];
+	uint16_t contactsRankIndex[CODEPLUG_CONTACTS_MAX]; // Contacts indexes grouped by call type (TG, PC, then ALL), each group sorted. The nth contact of a type is a direct access.
+	nameIndex_t nameIndex; // Call type as group, contact index as id
+	uint32_t contactsNameIndex[CODEPLUG_CONTACTS_MAX]; // nameIndex storage
 	codeplugDTMFContactCache_t contactsDTMFLookupCache[CODEPLUG_DTMF_CONTACTS_MAX];
 } codeplugContactsCache_t;
 
 __attribute__((section(".data.$RAM2"))) codeplugContactsCache_t codeplugContactsCache;
+static int codeplugContactsCacheBuildIndex = (CODEPLUG_CONTACTS_MAX + 1); // Next contact to read, (CODEPLUG_CONTACTS_MAX + 1) when complete
+
+#define CODEPLUG_CONTACTS_WINDOW_SIZE           16 // Max contacts held by the prefetch window (raw flash data)
+
+// Contiguous contacts span, prefetched in one flash read (see codeplugContactsPrefetchWindowInType())
+typedef struct
+{
+	int     firstIndex; // 0 when empty
+	int     numContacts;
+	uint8_t data[CODEPLUG_CONTACTS_WINDOW_SIZE * CODEPLUG_CONTACT_DATA_SIZE];
+} codeplugContactsWindow_t;
+
+__attribute__((section(".data.$RAM2"))) codeplugContactsWindow_t codeplugContactsWindow;
 
 __attribute__((section(".data.$RAM2"))) uint8_t codeplugRXGroupCache[CODEPLUG_RX_GROUPLIST_MAX];
 __attribute__((section(".data.$RAM2"))) uint8_t codeplugAllChannelsCache[128];
 __attribute__((section(".data.$RAM2"))) uint8_t codeplugZonesInUseCache[CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE];
 __attribute__((section(".data.$RAM2"))) uint16_t quickKeysCache[CODEPLUG_QUICKKEYS_SIZE];
 
+#define CODEPLUG_ZONES_CACHE_POOL_SIZE        4096 // Holds the names and channel lists of the zones, packed
+#define CODEPLUG_ZONES_CACHE_NOT_CACHED     0xFFFF
+
+typedef struct
+{
+	uint16_t poolOffset;// Offset of the zone name in the pool, followed by the channels. CODEPLUG_ZONES_CACHE_NOT_CACHED if it didn't fit
+	uint8_t  slot;// Index of the zone in the codeplug zones list
+	uint8_t  numChannels;
+} codeplugZoneCacheEntry_t;
+
+typedef struct
+{
+	int numZones;// Real zones, excluding 'All Channels'
+	int poolUsed;
+	uint8_t rank[CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE];// Number of zones in use before each byte of the in use table
+	codeplugZoneCacheEntry_t zones[CODEPLUG_ZONE_MAX_COUNT];// Indexed by zone number
+	uint8_t pool[CODEPLUG_ZONES_CACHE_POOL_SIZE];
+} codeplugZonesCache_t;
+
+__attribute__((section(".data.$RAM2"))) codeplugZonesCache_t codeplugZonesCache;
+
+// Set associative cache of the channels data, as stored in the codeplug (BCD frequencies, etc).
+// Consecutive channel indexes are spread over the sets.
+#define CODEPLUG_CHANNELS_CACHE_NUM_SETS         8
+#define CODEPLUG_CHANNELS_CACHE_NUM_WAYS         4
+
+typedef struct
+{
+	uint16_t index;// Channel index, 0 when the entry is empty
+	uint8_t  age;// LRU age, 0 is the most recently used way of the set
+	uint8_t  data[CODEPLUG_CHANNEL_DATA_STRUCT_SIZE];
+} codeplugChannelCacheEntry_t;
+
+typedef struct
+{
+	uint32_t hits;
+	uint32_t misses;
+	codeplugChannelCacheEntry_t entries[CODEPLUG_CHANNELS_CACHE_NUM_SETS][CODEPLUG_CHANNELS_CACHE_NUM_WAYS];
+} codeplugChannelsCache_t;
+
+__attribute__((section(".data.$RAM2"))) codeplugChannelsCache_t codeplugChannelsCache;
+
+// TGs of the RX groups, resolved from the contacts cache, sorted per group.
+#define CODEPLUG_RX_GROUPS_CACHE_POOL_SIZE     512
+#define CODEPLUG_RX_GROUPS_CACHE_NOT_CACHED    0xFFFF
+
+typedef struct
+{
+	uint16_t poolOffset;// Offset of the group TGs in the pool. CODEPLUG_RX_GROUPS_CACHE_NOT_CACHED if they didn't fit
+	uint16_t numTGs;
+} codeplugRxGroupCacheEntry_t;
+
+typedef struct
+{
+	bool isValid;// Only changed, and read, inside critical sections, see codeplugRxGroupsCacheSetValid()
+	int poolUsed;
+	codeplugRxGroupCacheEntry_t groups[CODEPLUG_RX_GROUPLIST_MAX];
+	uint32_t pool[CODEPLUG_RX_GROUPS_CACHE_POOL_SIZE];
+} codeplugRxGroupsCache_t;
+
+__attribute__((section(".data.$RAM2"))) codeplugRxGroupsCache_t codeplugRxGroupsCache;
+
 
 static bool codeplugContactGetReserve1ByteForIndex(int index, struct_codeplugContact_t *contact);
+static void codeplugContactsCacheEnsureReady(void);
+static uint32_t codeplugContactsCacheGetTGOrPC(int index);
+static void codeplugRxGroupsCacheBuild(void);
 
 uint32_t byteSwap32(uint32_t n)
 {
@@ -253,26 +334,150 @@ void codeplugUtilConvertStringToBuf(char *inBuf, char *outBuf, int len)
 	}
 }
 
-static void codeplugZonesInitCache(void)
+static void codeplugZonesCacheBuildRankTable(void)
 {
-	EEPROM_Read(CODEPLUG_ADDR_EX_ZONE_INUSE_PACKED_DATA, (uint8_t *)&codeplugZonesInUseCache, CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE);
+	int numZones = 0;
+
+	for(int i = 0; i < CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE; i++)
+	{
+		codeplugZonesCache.rank[i] = numZones;
+		numZones += __builtin_popcount(codeplugZonesInUseCache[i]);
+	}
+
+	codeplugZonesCache.numZones = numZones;
 }
 
-int codeplugZonesGetCount(void)
+// Returns the zone number of the zone stored in the given slot of the codeplug zones list, or -1 if the slot is not in use
+static int codeplugZonesCacheGetNumberForSlot(int slot)
+{
+	if ((slot >= 0) && (slot < CODEPLUG_ZONE_MAX_COUNT) && (((codeplugZonesInUseCache[slot / 8] >> (slot % 8)) & 0x01) == 0x01))
+	{
+		return (codeplugZonesCache.rank[slot / 8] + __builtin_popcount(codeplugZonesInUseCache[slot / 8] & ((1 << (slot % 8)) - 1)));
+	}
+
+	return -1;
+}
+
+// Reads a zone from the codeplug and computes its number of channels
+static bool codeplugZoneReadDataForSlot(int slot, struct_codeplugZone_t *returnBuf)
 {
-	int numZones = 1;// Add one extra zone to allow for the special 'All Channels' Zone
+	returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = slot;
 
-	for(int i = 0; i < CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE; i++)
+	// IMPORTANT. Write size is different from the size of the data, because it the zone struct contains properties not in the codeplug data
+	if (EEPROM_Read(CODEPLUG_ADDR_EX_ZONE_LIST + (slot * (16 + (sizeof(uint16_t) * codeplugChannelsPerZone))),
+			(uint8_t *)returnBuf, ((codeplugChannelsPerZone == 16) ? CODEPLUG_ZONE_DATA_ORIGINAL_STRUCT_SIZE : CODEPLUG_ZONE_DATA_OPENGD77_STRUCT_SIZE)))
 	{
-		numZones += __builtin_popcount(codeplugZonesInUseCache[i]);
+		for(int i = 0; i < codeplugChannelsPerZone; i++)
+		{
+			// Empty channels seem to be filled with zeros, and zone could be full of channels.
+			if ((returnBuf->channels[i] == 0) || (i == (codeplugChannelsPerZone - 1)))
+			{
+				returnBuf->NOT_IN_CODEPLUGDATA_highestIndex = returnBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone = (i + ((returnBuf->channels[i] == 0) ? 0 : 1));
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Stores (or resizes) the name and channel list of a zone in the cache pool.
+// If the pool is full the zone is left uncached, and will be read from the EEPROM instead.
+static void codeplugZonesCacheStoreZone(int zoneNum, struct_codeplugZone_t *zoneBuf)
+{
+	codeplugZoneCacheEntry_t *entry = &codeplugZonesCache.zones[zoneNum];
+	int newSize = sizeof(zoneBuf->name) + (zoneBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone * sizeof(uint16_t));
+
+	entry->slot = zoneBuf->NOT_IN_CODEPLUGDATA_indexNumber;
+
+	if (entry->poolOffset != CODEPLUG_ZONES_CACHE_NOT_CACHED)
+	{
+		int oldSize = sizeof(zoneBuf->name) + (entry->numChannels * sizeof(uint16_t));
+		int oldEnd = entry->poolOffset + oldSize;
+		int delta = newSize - oldSize;
+
+		if ((codeplugZonesCache.poolUsed + delta) > CODEPLUG_ZONES_CACHE_POOL_SIZE)
+		{
+			delta = -oldSize;// Can't grow it, so drop this zone from the pool
+			newSize = 0;
+		}
+
+		if (delta != 0)
+		{
+			// Note . Need to use memmove as the source and destination overlap.
+			memmove(&codeplugZonesCache.pool[oldEnd + delta], &codeplugZonesCache.pool[oldEnd], (codeplugZonesCache.poolUsed - oldEnd));
+			codeplugZonesCache.poolUsed += delta;
+
+			for (int i = 0; i < codeplugZonesCache.numZones; i++)
+			{
+				if ((codeplugZonesCache.zones[i].poolOffset != CODEPLUG_ZONES_CACHE_NOT_CACHED) && (codeplugZonesCache.zones[i].poolOffset >= oldEnd))
+				{
+					codeplugZonesCache.zones[i].poolOffset += delta;
+				}
+			}
+		}
+
+		if (newSize == 0)
+		{
+			entry->poolOffset = CODEPLUG_ZONES_CACHE_NOT_CACHED;
+		}
+	}
+	else
+	{
+		if ((codeplugZonesCache.poolUsed + newSize) <= CODEPLUG_ZONES_CACHE_POOL_SIZE)
+		{
+			entry->poolOffset = codeplugZonesCache.poolUsed;
+			codeplugZonesCache.poolUsed += newSize;
+		}
+	}
+
+	if (entry->poolOffset != CODEPLUG_ZONES_CACHE_NOT_CACHED)
+	{
+		entry->numChannels = zoneBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone;
+		memcpy(&codeplugZonesCache.pool[entry->poolOffset], zoneBuf->name, sizeof(zoneBuf->name));
+		memcpy(&codeplugZonesCache.pool[entry->poolOffset + sizeof(zoneBuf->name)], zoneBuf->channels, (entry->numChannels * sizeof(uint16_t)));
+	}
+}
+
+static void codeplugZonesInitCache(void)
+{
+	struct_codeplugZone_t zoneBuf;
+	int zoneNum = 0;
+
+	EEPROM_Read(CODEPLUG_ADDR_EX_ZONE_INUSE_PACKED_DATA, (uint8_t *)&codeplugZonesInUseCache, CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE);
+
+	codeplugZonesCacheBuildRankTable();
+	codeplugZonesCache.poolUsed = 0;
+	memset(codeplugZonesCache.zones, 0xFF, sizeof(codeplugZonesCache.zones));// All zones are uncached (CODEPLUG_ZONES_CACHE_NOT_CACHED)
+
+	for (int slot = 0; slot < CODEPLUG_ZONE_MAX_COUNT; slot++)
+	{
+		if (((codeplugZonesInUseCache[slot / 8] >> (slot % 8)) & 0x01) == 0x01)
+		{
+			codeplugZonesCache.zones[zoneNum].slot = slot;
+			codeplugZonesCache.zones[zoneNum].poolOffset = CODEPLUG_ZONES_CACHE_NOT_CACHED;
+
+			if (codeplugZoneReadDataForSlot(slot, &zoneBuf))
+			{
+				codeplugZonesCacheStoreZone(zoneNum, &zoneBuf);
+			}
+
+			zoneNum++;
+		}
 	}
 
-	return numZones;
+	// The in use table has more bits than there are zones, ignore the zones in the unused bits.
+	codeplugZonesCache.numZones = zoneNum;
+}
+
+int codeplugZonesGetCount(void)
+{
+	return (codeplugZonesCache.numZones + 1);// Add one extra zone to allow for the special 'All Channels' Zone
 }
 
 bool codeplugZoneGetDataForNumber(int zoneNum, struct_codeplugZone_t *returnBuf)
 {
-	if (zoneNum == (codeplugZonesGetCount() - 1)) //special case: return a special Zone called 'All Channels'
+	if (zoneNum == codeplugZonesCache.numZones) //special case: return a special Zone called 'All Channels'
 	{
 		int nameLen = SAFE_MIN(((int)sizeof(returnBuf->name)), ((int)strlen(currentLanguage->all_channels)));
 
@@ -288,59 +493,34 @@ bool codeplugZoneGetDataForNumber(int zoneNum, struct_codeplugZone_t *returnBuf)
 		returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = -1;// Set as -1 as this is not a real zone. Its the "All Channels" zone
 		return true;
 	}
-	else
+	else if ((zoneNum >= 0) && (zoneNum < codeplugZonesCache.numZones))
 	{
-		// Need to find the index into the Zones data for the specific Zone number.
-		// Because the Zones data is not guaranteed to be packed by the CPS (though we should attempt to make the CPS always pack the Zones)
-		int count = -1;// Need to start counting at -1 because the Zone number is zero indexed
-		int foundIndex = -1;
+		codeplugZoneCacheEntry_t *entry = &codeplugZonesCache.zones[zoneNum];
 
-		// Go though each byte in the In Use table
-		for(int i = 0; i < CODEPLUG_EX_ZONE_INUSE_PACKED_DATA_SIZE; i++)
+		// The zone number to index mapping comes from the cache, because the Zones data is not guaranteed to be packed by the CPS
+		if (entry->poolOffset != CODEPLUG_ZONES_CACHE_NOT_CACHED)
 		{
-			// Go though each binary bit, counting them one by one
-			for(int j = 0; j < 8; j++)
-			{
-				if (((codeplugZonesInUseCache[i] >> j) & 0x01) == 0x01)
-				{
-					count++;
+			memcpy(returnBuf->name, &codeplugZonesCache.pool[entry->poolOffset], sizeof(returnBuf->name));
+			memset(returnBuf->channels, 0, sizeof(returnBuf->channels));
+			memcpy(returnBuf->channels, &codeplugZonesCache.pool[entry->poolOffset + sizeof(returnBuf->name)], (entry->numChannels * sizeof(uint16_t)));
 
-					if (count == zoneNum)
-					{
-						// found it. So save the index before we exit the "for" loops
-						foundIndex = (i * 8) + j;
-						break;// Will break out of this loop, but the outer loop breaks becuase it also checks for foundIndex
-					}
-				}
-			}
+			// Save this in case we need to add channels to a zone and hence need the index number so it can be saved back to the codeplug memory
+			returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = entry->slot;
+			returnBuf->NOT_IN_CODEPLUGDATA_highestIndex = returnBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone = entry->numChannels;
+			return true;
 		}
 
-		if (foundIndex != -1)
+		// Didn't fit in the cache pool
+		if (codeplugZoneReadDataForSlot(entry->slot, returnBuf))
 		{
-			// Save this in case we need to add channels to a zone and hence need the index number so it can be saved back to the codeplug memory
-			returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = foundIndex;
-
-			// IMPORTANT. Write size is different from the size of the data, because it the zone struct contains properties not in the codeplug data
-			EEPROM_Read(CODEPLUG_ADDR_EX_ZONE_LIST + (foundIndex * (16 + (sizeof(uint16_t) * codeplugChannelsPerZone))),
-					(uint8_t *)returnBuf, ((codeplugChannelsPerZone == 16) ? CODEPLUG_ZONE_DATA_ORIGINAL_STRUCT_SIZE : CODEPLUG_ZONE_DATA_OPENGD77_STRUCT_SIZE));
-
-
-			for(int i = 0; i < codeplugChannelsPerZone; i++)
-			{
-				// Empty channels seem to be filled with zeros, and zone could be full of channels.
-				if ((returnBuf->channels[i] == 0) || (i == (codeplugChannelsPerZone - 1)))
-				{
-					returnBuf->NOT_IN_CODEPLUGDATA_highestIndex = returnBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone = (i + ((returnBuf->channels[i] == 0) ? 0 : 1));
-					return true;
-				}
-			}
+			return true;
 		}
-
-		memset(returnBuf->channels, 0, codeplugChannelsPerZone);
-		returnBuf->NOT_IN_CODEPLUGDATA_highestIndex = returnBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone = 0;
-		returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = -2; // we could not use '-1' on error, as -1 is All Channel zone
 	}
 
+	memset(returnBuf->channels, 0, codeplugChannelsPerZone);
+	returnBuf->NOT_IN_CODEPLUGDATA_highestIndex = returnBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone = 0;
+	returnBuf->NOT_IN_CODEPLUGDATA_indexNumber = -2; // we could not use '-1' on error, as -1 is All Channel zone
+
 	return false;
 }
 
@@ -348,12 +528,22 @@ bool codeplugZoneAddChannelToZoneAndSave(int channelIndex, struct_codeplugZone_t
 {
 	if ((zoneBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone < codeplugChannelsPerZone) && (zoneBuf->NOT_IN_CODEPLUGDATA_indexNumber != -1))
 	{
+		int zoneNum = codeplugZonesCacheGetNumberForSlot(zoneBuf->NOT_IN_CODEPLUGDATA_indexNumber);
+
 		zoneBuf->channels[zoneBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone++] = channelIndex;// add channel to zone, and increment numb channels in zone
 		zoneBuf->NOT_IN_CODEPLUGDATA_highestIndex = zoneBuf->NOT_IN_CODEPLUGDATA_numChannelsInZone;
 
 		// IMPORTANT. Write size is different from the size of the data, because it the zone struct contains properties not in the codeplug data
-		return EEPROM_Write(CODEPLUG_ADDR_EX_ZONE_LIST + (zoneBuf->NOT_IN_CODEPLUGDATA_indexNumber * (16 + (sizeof(uint16_t) * codeplugChannelsPerZone))),
-				(uint8_t *)zoneBuf, ((codeplugChannelsPerZone == 16) ? CODEPLUG_ZONE_DATA_ORIGINAL_STRUCT_SIZE : CODEPLUG_ZONE_DATA_OPENGD77_STRUCT_SIZE));
+		if (EEPROM_Write(CODEPLUG_ADDR_EX_ZONE_LIST + (zoneBuf->NOT_IN_CODEPLUGDATA_indexNumber * (16 + (sizeof(uint16_t) * codeplugChannelsPerZone))),
+				(uint8_t *)zoneBuf, ((codeplugChannelsPerZone == 16) ? CODEPLUG_ZONE_DATA_ORIGINAL_STRUCT_SIZE : CODEPLUG_ZONE_DATA_OPENGD77_STRUCT_SIZE)))
+		{
+			if (zoneNum >= 0)
+			{
+				codeplugZonesCacheStoreZone(zoneNum, zoneBuf);
+			}
+
+			return true;
+		}
 	}
 
 	return false;
@@ -592,8 +782,94 @@ void codeplugChannelSetFlag(struct_codeplugChannel_t *channelBuf, ChannelFlag_t
 	}
 }
 
+void codeplugChannelCacheInvalidate(void)
+{
+	for (int set = 0; set < CODEPLUG_CHANNELS_CACHE_NUM_SETS; set++)
+	{
+		for (int way = 0; way < CODEPLUG_CHANNELS_CACHE_NUM_WAYS; way++)
+		{
+			codeplugChannelsCache.entries[set][way].index = 0;
+			codeplugChannelsCache.entries[set][way].age = way;// The ages of a set are always a permutation of 0..(NUM_WAYS - 1)
+		}
+	}
+}
+
+void codeplugChannelCacheGetStats(uint32_t *hits, uint32_t *misses)
+{
+	*hits = codeplugChannelsCache.hits;
+	*misses = codeplugChannelsCache.misses;
+}
+
+// Makes the way the most recently used one of its set
+static void codeplugChannelCacheTouch(codeplugChannelCacheEntry_t *set, int way)
+{
+	for (int i = 0; i < CODEPLUG_CHANNELS_CACHE_NUM_WAYS; i++)
+	{
+		if (set[i].age < set[way].age)
+		{
+			set[i].age++;
+		}
+	}
+
+	set[way].age = 0;
+}
+
+static codeplugChannelCacheEntry_t *codeplugChannelCacheFind(int index)
+{
+	codeplugChannelCacheEntry_t *set = codeplugChannelsCache.entries[index % CODEPLUG_CHANNELS_CACHE_NUM_SETS];
+
+	for (int i = 0; i < CODEPLUG_CHANNELS_CACHE_NUM_WAYS; i++)
+	{
+		if (set[i].index == index)
+		{
+			codeplugChannelCacheTouch(set, i);
+			return &set[i];
+		}
+	}
+
+	return NULL;
+}
+
+// Stores the codeplug formatted channel data, replacing the least recently used way of the set if the channel isn't already cached
+static void codeplugChannelCacheStore(int index, uint8_t *data)
+{
+	codeplugChannelCacheEntry_t *set = codeplugChannelsCache.entries[index % CODEPLUG_CHANNELS_CACHE_NUM_SETS];
+	int way = 0;
+
+	for (int i = 0; i < CODEPLUG_CHANNELS_CACHE_NUM_WAYS; i++)
+	{
+		if (set[i].index == index)
+		{
+			way = i;
+			break;
+		}
+
+		// Use an empty way, otherwise the oldest one
+		if ((set[way].index != 0) && ((set[i].index == 0) || (set[i].age > set[way].age)))
+		{
+			way = i;
+		}
+	}
+
+	set[way].index = index;
+	memcpy(set[way].data, data, CODEPLUG_CHANNEL_DATA_STRUCT_SIZE);
+	codeplugChannelCacheTouch(set, way);
+}
+
 void codeplugChannelGetDataWithOffsetAndLengthForIndex(int index, struct_codeplugChannel_t *channelBuf, uint8_t offset, int length)
 {
+	codeplugChannelCacheEntry_t *entry = codeplugChannelCacheFind(index);
+	int channelIndex = index;
+
+	if (entry != NULL)
+	{
+		codeplugChannelsCache.hits++;
+		memcpy(((uint8_t *)channelBuf) + offset, &entry->data[offset], length);
+		return;
+	}
+
+	codeplugChannelsCache.misses++;
+
 	// lower 128 channels are in EEPROM. Remaining channels are in Flash ! (What a mess...)
 	index--; // I think the channel index numbers start from 1 not zero.
 	if (index < 128)
@@ -611,6 +887,12 @@ void codeplugChannelGetDataWithOffsetAndLengthForIndex(int index, struct_codeplu
 
 		SPI_Flash_read((flashReadPos + index * CODEPLUG_CHANNEL_DATA_STRUCT_SIZE) + offset, ((uint8_t *)channelBuf) + offset, length);
 	}
+
+	// Only whole channels are cached, partial reads (e.g. the scan flags) go straight to the memory
+	if ((offset == 0) && (length == CODEPLUG_CHANNEL_DATA_STRUCT_SIZE))
+	{
+		codeplugChannelCacheStore(channelIndex, (uint8_t *)channelBuf);
+	}
 }
 
 void codeplugChannelGetDataForIndex(int index, struct_codeplugChannel_t *channelBuf)
@@ -643,6 +925,7 @@ void codeplugChannelGetDataForIndex(int index, struct_codeplugChannel_t *channel
 bool codeplugChannelSaveDataForIndex(int index, struct_codeplugChannel_t *channelBuf)
 {
 	bool retVal = true;
+	int channelIndex = index;// index is altered below, but the cache needs the channel number
 #if defined(PLATFORM_MD9600)
 	bool outOfBandFlag = ((channelBuf->LibreDMR_flag1 & CODEPLUG_CHANNEL_LIBREDMR_FLAG1_OUT_OF_BAND) != 0);
 
@@ -657,6 +940,13 @@ bool codeplugChannelSaveDataForIndex(int index, struct_codeplugChannel_t *channe
 	channelBuf->txTone = codeplugIntToCSS(channelBuf->txTone);
 	channelBuf->rxTone = codeplugIntToCSS(channelBuf->rxTone);
 
+	// Write through the cache. The write below could fail halfway, hence the entry is dropped until it succeeds.
+	codeplugChannelCacheEntry_t *entry = codeplugChannelCacheFind(channelIndex);
+	if (entry != NULL)
+	{
+		entry->index = 0;
+	}
+
 	// lower 128 channels are in EEPROM. Remaining channels are in Flash ! (What a mess...)
 	index--; // I think the channel index numbers start from 1 not zero.
 	if (index < 128)
@@ -731,6 +1021,11 @@ bool codeplugChannelSaveDataForIndex(int index, struct_codeplugChannel_t *channe
 	}
 
 errorExit:
+	if (retVal)
+	{
+		codeplugChannelCacheStore(channelIndex, (uint8_t *)channelBuf);
+	}
+
 #if defined(PLATFORM_MD9600)
 	if (outOfBandFlag)
 	{
@@ -749,15 +1044,160 @@ errorExit:
 	return retVal;
 }
 
+// The RX groups cache is rebuilt by the main task, while the RX group filter (HR-C6000 task and ISR) may be reading it.
+// The filter only uses it inside a critical section, if it's valid. The rebuild flags it invalid before touching it.
+static void codeplugRxGroupsCacheSetValid(bool isValid)
+{
+	UBaseType_t savedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+	codeplugRxGroupsCache.isValid = isValid;
+	taskEXIT_CRITICAL_FROM_ISR(savedInterruptStatus);
+}
+
 static void codeplugRxGroupInitCache(void)
 {
+	codeplugRxGroupsCacheSetValid(false);
 	SPI_Flash_read(CODEPLUG_ADDR_RX_GROUP_LEN, (uint8_t*) &codeplugRXGroupCache[0], CODEPLUG_RX_GROUPLIST_MAX);
+
+	// The RX groups TGs need the contacts cache, otherwise they are built once it's complete.
+	if (codeplugContactsCacheIsReady())
+	{
+		codeplugRxGroupsCacheBuild();
+	}
+}
+
+static bool codeplugRxGroupsCacheTGsContain(const uint32_t *tgs, int numTGs, uint32_t tg)
+{
+	int low = 0;
+	int high = numTGs - 1;
+
+	while (low <= high)
+	{
+		int mid = (low + high) >> 1;
+
+		if (tgs[mid] == tg)
+		{
+			return true;
+		}
+		else if (tgs[mid] < tg)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	return false;
+}
+
+static void codeplugRxGroupsCacheInsertTG(uint32_t *tgs, int numTGs, uint32_t tg)
+{
+	int i = numTGs;
+
+	while ((i > 0) && (tgs[i - 1] > tg))
+	{
+		tgs[i] = tgs[i - 1];
+		i--;
+	}
+	tgs[i] = tg;
+}
+
+// Resolves, with the contacts cache, the TGs of all the RX groups (without duplicates), and sorts them.
+static void codeplugRxGroupsCacheBuild(void)
+{
+	uint16_t contacts[32];
+
+	codeplugRxGroupsCacheSetValid(false);
+	codeplugRxGroupsCache.poolUsed = 0;
+
+	for (int g = 0; g < CODEPLUG_RX_GROUPLIST_MAX; g++)
+	{
+		codeplugRxGroupCacheEntry_t *group = &codeplugRxGroupsCache.groups[g];
+
+		group->poolOffset = CODEPLUG_RX_GROUPS_CACHE_NOT_CACHED;
+		group->numTGs = 0;
+
+		if (codeplugRXGroupCache[g] == 0)
+		{
+			group->poolOffset = codeplugRxGroupsCache.poolUsed;// Empty
+		}
+		else if (SPI_Flash_read(CODEPLUG_ADDR_RX_GROUP + (g * CODEPLUG_RXGROUP_DATA_STRUCT_SIZE) + 16, (uint8_t *)contacts, sizeof(contacts))) // Skip the name
+		{
+			uint32_t *tgs = &codeplugRxGroupsCache.pool[codeplugRxGroupsCache.poolUsed];
+			int numTGs = 0;
+			bool fits = true;
+
+			for (int i = 0; i < 32; i++)
+			{
+				// Empty groups seem to be filled with zeros
+				if (contacts[i] == 0)
+				{
+					break;
+				}
+
+				uint32_t tg = codeplugContactsCacheGetTGOrPC(contacts[i]) & 0x00FFFFFF;
+
+				if ((tg == 0) || ((numTGs > 0) && codeplugRxGroupsCacheTGsContain(tgs, numTGs, tg)))
+				{
+					continue;
+				}
+
+				if ((codeplugRxGroupsCache.poolUsed + numTGs) >= CODEPLUG_RX_GROUPS_CACHE_POOL_SIZE)
+				{
+					fits = false;
+					break;
+				}
+
+				codeplugRxGroupsCacheInsertTG(tgs, numTGs, tg);
+				numTGs++;
+			}
+
+			if (fits)
+			{
+				group->poolOffset = codeplugRxGroupsCache.poolUsed;
+				group->numTGs = numTGs;
+				codeplugRxGroupsCache.poolUsed += numTGs;
+			}
+		}
+	}
+
+	codeplugRxGroupsCacheSetValid(true);
+}
+
+// Sets *isMember if the TG is in the RX group (index from 1), from the RX groups cache: no flash access. Can be called from an ISR.
+// Returns false if the answer isn't known (cache being rebuilt, or the group didn't fit in it), the caller must check the group data itself.
+bool codeplugRxGroupContainsTG(int index, uint32_t tg, bool *isMember)
+{
+	bool isKnown = false;
+
+	*isMember = false;
+
+	if ((index >= 1) && (index <= CODEPLUG_RX_GROUPLIST_MAX))
+	{
+		// A short binary search, the cache can't be rebuilt meanwhile
+		UBaseType_t savedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+
+		if (codeplugRxGroupsCache.isValid)
+		{
+			codeplugRxGroupCacheEntry_t *group = &codeplugRxGroupsCache.groups[index - 1];
+
+			if (group->poolOffset != CODEPLUG_RX_GROUPS_CACHE_NOT_CACHED)
+			{
+				*isMember = codeplugRxGroupsCacheTGsContain(&codeplugRxGroupsCache.pool[group->poolOffset], group->numTGs, tg);
+				isKnown = true;
+			}
+		}
+
+		taskEXIT_CRITICAL_FROM_ISR(savedInterruptStatus);
+	}
+
+	return isKnown;
 }
 
 bool codeplugRxGroupGetDataForIndex(int index, struct_codeplugRxGroup_t *rxGroupBuf)
 {
 	int i = 0;
-	struct_codeplugContact_t contactData;
 
 	if ((index >= 1) && (index <= CODEPLUG_RX_GROUPLIST_MAX))
 	{
@@ -768,15 +1208,15 @@ bool codeplugRxGroupGetDataForIndex(int index, struct_codeplugRxGroup_t *rxGroup
 			// Not our struct contains an extra property to hold the number of TGs in the group
 			SPI_Flash_read(CODEPLUG_ADDR_RX_GROUP + (index * CODEPLUG_RXGROUP_DATA_STRUCT_SIZE), (uint8_t *) rxGroupBuf, CODEPLUG_RXGROUP_DATA_STRUCT_SIZE);
 
+			// The TGs come from the contacts cache, instead of reading each contact
 			for (i = 0; i < 32; i++)
 			{
-				codeplugContactGetDataForIndex(rxGroupBuf->contacts[i], &contactData);
-				rxGroupBuf->NOT_IN_CODEPLUG_contactsTG[i] = contactData.tgNumber;
 				// Empty groups seem to be filled with zeros
 				if (rxGroupBuf->contacts[i] == 0)
 				{
 					break;
 				}
+				rxGroupBuf->NOT_IN_CODEPLUG_contactsTG[i] = codeplugContactsCacheGetTGOrPC(rxGroupBuf->contacts[i]) & 0x00FFFFFF;
 			}
 
 			rxGroupBuf->NOT_IN_CODEPLUG_numTGsInGroup = i;
@@ -791,11 +1231,181 @@ bool codeplugRxGroupGetDataForIndex(int index, struct_codeplugRxGroup_t *rxGroup
 
 int codeplugDTMFContactsGetCount(void)
 {
+	codeplugContactsCacheEnsureReady();
+
 	return codeplugContactsCache.numDTMFContacts;
 }
 
+// TG or PC number of a contact, with its call type in the upper byte. 0 if the contact doesn't exist.
+static uint32_t codeplugContactsCacheGetTGOrPC(int index)
+{
+	codeplugContactsCacheEnsureReady();
+
+	int low = 0;
+	int high = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts - 1;
+
+	while (low <= high)
+	{
+		int mid = (low + high) >> 1;
+
+		if (codeplugContactsCache.contactsLookupCache[mid].index == index)
+		{
+			return codeplugContactsCache.contactsLookupCache[mid].tgOrPCNum;
+		}
+		else if (codeplugContactsCache.contactsLookupCache[mid].index < index)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	return 0;
+}
+
+static int *codeplugContactsCacheTypeCounter(uint32_t callType)
+{
+	switch (callType)
+	{
+		case CONTACT_CALLTYPE_TG:
+			return &codeplugContactsCache.numTGContacts;
+			break;
+		case CONTACT_CALLTYPE_PC:
+			return &codeplugContactsCache.numPCContacts;
+			break;
+		case CONTACT_CALLTYPE_ALL:
+			return &codeplugContactsCache.numALLContacts;
+			break;
+	}
+
+	return NULL;
+}
+
+// Position of the first contact of this call type in the rank index
+static int codeplugContactsRankStart(uint32_t callType)
+{
+	switch (callType)
+	{
+		case CONTACT_CALLTYPE_PC:
+			return codeplugContactsCache.numTGContacts;
+			break;
+		case CONTACT_CALLTYPE_ALL:
+			return (codeplugContactsCache.numTGContacts + codeplugContactsCache.numPCContacts);
+			break;
+	}
+
+	return 0;
+}
+
+// Position of index in the call type group, or where it should be inserted
+static int codeplugContactsRankFind(int start, int count, int index)
+{
+	int low = start;
+	int high = start + count;
+
+	while (low < high)
+	{
+		int mid = (low + high) >> 1;
+
+		if (codeplugContactsCache.contactsRankIndex[mid] < index)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+// Counts the contact in its call type and adds it to the rank index
+static void codeplugContactsCacheTypeAdd(uint32_t callType, int index)
+{
+	int *counter = codeplugContactsCacheTypeCounter(callType);
+
+	if (counter != NULL)
+	{
+		int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
+		int pos = codeplugContactsRankFind(codeplugContactsRankStart(callType), *counter, index);
+
+		memmove(&codeplugContactsCache.contactsRankIndex[pos + 1], &codeplugContactsCache.contactsRankIndex[pos], (numContacts - pos) * sizeof(uint16_t));
+		codeplugContactsCache.contactsRankIndex[pos] = index;
+		(*counter)++;
+	}
+}
+
+static void codeplugContactsCacheTypeRemove(uint32_t callType, int index)
+{
+	int *counter = codeplugContactsCacheTypeCounter(callType);
+
+	if ((counter != NULL) && (*counter > 0))
+	{
+		int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
+		int pos = codeplugContactsRankFind(codeplugContactsRankStart(callType), *counter, index);
+
+		memmove(&codeplugContactsCache.contactsRankIndex[pos], &codeplugContactsCache.contactsRankIndex[pos + 1], (numContacts - 1 - pos) * sizeof(uint16_t));
+		(*counter)--;
+	}
+}
+
+static void codeplugContactsNameIndexAdd(uint32_t callType, const char *name, int index)
+{
+	if (callType <= CONTACT_CALLTYPE_ALL)
+	{
+		nameIndexAdd(&codeplugContactsCache.nameIndex, callType, name, index);
+	}
+}
+
+// Called once the lookup cache is complete, as its contacts are sorted by index, so are the groups.
+static void codeplugContactsRankBuild(void)
+{
+	int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
+	int pos[CONTACT_CALLTYPE_ALL + 1] = { 0, codeplugContactsCache.numTGContacts, (codeplugContactsCache.numTGContacts + codeplugContactsCache.numPCContacts) };
+
+	for (int i = 0; i < numContacts; i++)
+	{
+		uint32_t callType = codeplugContactsCache.contactsLookupCache[i].tgOrPCNum >> 24;
+
+		if (callType <= CONTACT_CALLTYPE_ALL)
+		{
+			codeplugContactsCache.contactsRankIndex[pos[callType]++] = codeplugContactsCache.contactsLookupCache[i].index;
+		}
+	}
+}
+
+// keys: keypad keys ('0' to '9') of the name prefix, see nameIndexCharToKey().
+// Returns the number (in the call type) of the first contact whose name starts with those keys, in keys order, or 0 if none.
+int codeplugContactsFindNumberByNamePrefixInType(const char *keys, int numKeys, uint32_t callType)
+{
+	codeplugContactsCacheEnsureReady();
+
+	int *counter = codeplugContactsCacheTypeCounter(callType);
+
+	if (counter == NULL)
+	{
+		return 0;
+	}
+
+	int index = nameIndexFindByKeys(&codeplugContactsCache.nameIndex, callType, keys, numKeys);
+
+	if (index >= 0)
+	{
+		int start = codeplugContactsRankStart(callType);
+
+		return ((codeplugContactsRankFind(start, *counter, index) - start) + 1);
+	}
+
+	return 0;
+}
+
 int codeplugContactsGetCount(uint32_t callType) // 0:TG 1:PC 2:ALL
 {
+	codeplugContactsCacheEnsureReady();
+
 	switch (callType)
 	{
 		case CONTACT_CALLTYPE_TG:
@@ -815,6 +1425,8 @@ int codeplugContactsGetCount(uint32_t callType) // 0:TG 1:PC 2:ALL
 // Returns contact's index, or 0 on failure.
 int codeplugDTMFContactGetDataForNumber(int number, struct_codeplugDTMFContact_t *contact)
 {
+	codeplugContactsCacheEnsureReady();
+
 	if ((number >= CODEPLUG_DTMF_CONTACTS_MIN) && (number <= CODEPLUG_DTMF_CONTACTS_MAX))
 	{
 		if (codeplugDTMFContactGetDataForIndex(codeplugContactsCache.contactsDTMFLookupCache[number - 1].index, contact))
@@ -829,30 +1441,75 @@ int codeplugDTMFContactGetDataForNumber(int number, struct_codeplugDTMFContact_t
 // Returns contact's index, or 0 on failure.
 int codeplugContactGetDataForNumberInType(int number, uint32_t callType, struct_codeplugContact_t *contact)
 {
-	int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
+	codeplugContactsCacheEnsureReady();
 
-	for (int i = 0; i < numContacts; i++)
+	int *counter = codeplugContactsCacheTypeCounter(callType);
+
+	if ((counter != NULL) && (number > 0) && (number <= *counter))
 	{
-		if ((codeplugContactsCache.contactsLookupCache[i].tgOrPCNum >> 24) == callType)
-		{
-			number--;
-		}
+		int index = codeplugContactsCache.contactsRankIndex[codeplugContactsRankStart(callType) + number - 1];
 
-		if (number == 0)
+		if (codeplugContactGetDataForIndex(index, contact))
 		{
-			if (codeplugContactGetDataForIndex(codeplugContactsCache.contactsLookupCache[i].index, contact))
-			{
-				return codeplugContactsCache.contactsLookupCache[i].index;
-			}
+			return index;
 		}
 	}
 
 	return 0;
 }
 
+// Reads, in one go, the flash span holding the count contacts of this type starting at number (e.g. a page of the contact list),
+// codeplugContactGetDataForIndex() will then get them from RAM. The span is truncated to CODEPLUG_CONTACTS_WINDOW_SIZE contacts.
+void codeplugContactsPrefetchWindowInType(int number, int count, uint32_t callType)
+{
+	codeplugContactsCacheEnsureReady();
+
+	int *counter = codeplugContactsCacheTypeCounter(callType);
+
+	if ((counter == NULL) || (number < 1) || (number > *counter) || (count < 1))
+	{
+		return;
+	}
+
+	int start = codeplugContactsRankStart(callType);
+	int lastNumber = number + count - 1;
+
+	if (lastNumber > *counter)
+	{
+		lastNumber = *counter;
+	}
+
+	int firstIndex = codeplugContactsCache.contactsRankIndex[start + number - 1];
+	int numContacts = (codeplugContactsCache.contactsRankIndex[start + lastNumber - 1] - firstIndex) + 1;
+
+	if (numContacts > CODEPLUG_CONTACTS_WINDOW_SIZE)
+	{
+		numContacts = CODEPLUG_CONTACTS_WINDOW_SIZE;
+	}
+
+	// Already there
+	if ((codeplugContactsWindow.firstIndex != 0) && (firstIndex >= codeplugContactsWindow.firstIndex) &&
+			((firstIndex + numContacts) <= (codeplugContactsWindow.firstIndex + codeplugContactsWindow.numContacts)))
+	{
+		return;
+	}
+
+	if (SPI_Flash_read(CODEPLUG_ADDR_CONTACTS + ((firstIndex - 1) * CODEPLUG_CONTACT_DATA_SIZE), codeplugContactsWindow.data, (numContacts * CODEPLUG_CONTACT_DATA_SIZE)))
+	{
+		codeplugContactsWindow.firstIndex = firstIndex;
+		codeplugContactsWindow.numContacts = numContacts;
+	}
+	else
+	{
+		codeplugContactsWindow.firstIndex = 0;
+	}
+}
+
 // optionalTS: 0 = no TS checking, 1..2 = TS
 int codeplugContactIndexByTGorPCFromNumber(int number, uint32_t tgorpc, uint32_t callType, struct_codeplugContact_t *contact, uint8_t optionalTS)
 {
+	codeplugContactsCacheEnsureReady();
+
 	int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 	int firstMatch = -1;
 
@@ -904,8 +1561,15 @@ int codeplugContactIndexByTGorPC(uint32_t tgorpc, uint32_t callType, struct_code
 	return codeplugContactIndexByTGorPCFromNumber(0, tgorpc, callType, contact, optionalTS);
 }
 
+// Called from the HR-C6000 interrupt (talkgroup filter), so the cache must never be built from here.
+// While it is not ready, let the call through.
 bool codeplugContactsContainsPC(uint32_t pc)
 {
+	if (codeplugContactsCacheIsReady() == false)
+	{
+		return true;
+	}
+
 	int numContacts =  codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 	pc = pc & 0x00FFFFFF;
 	pc = pc | (CONTACT_CALLTYPE_PC << 24);
@@ -920,18 +1584,34 @@ bool codeplugContactsContainsPC(uint32_t pc)
 	return false;
 }
 
+// The contacts cache is built in the background, a few contacts at a time (see codeplugContactsCacheBuildStep()).
 static void codeplugInitContactsCache(void)
 {
-	struct_codeplugContact_t contact;
-	uint8_t                  c;
-	int codeplugNumContacts = 0;
 	codeplugContactsCache.numTGContacts = 0;
 	codeplugContactsCache.numPCContacts = 0;
 	codeplugContactsCache.numALLContacts = 0;
 	codeplugContactsCache.numDTMFContacts = 0;
+	nameIndexInit(&codeplugContactsCache.nameIndex, codeplugContactsCache.contactsNameIndex, CODEPLUG_CONTACTS_MAX);
+	codeplugContactsCacheBuildIndex = 0;
+	codeplugContactsWindow.firstIndex = 0;
+}
+
+bool codeplugContactsCacheIsReady(void)
+{
+	return (codeplugContactsCacheBuildIndex > CODEPLUG_CONTACTS_MAX);
+}
+
+// Reads the next contacts (up to count), returns true when the cache is complete.
+bool codeplugContactsCacheBuildStep(int count)
+{
+	struct_codeplugContact_t contact;
+	uint8_t                  c;
+	int codeplugNumContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 
-	for(int i = 0; i < CODEPLUG_CONTACTS_MAX; i++)
+	for(; ((codeplugContactsCacheBuildIndex < CODEPLUG_CONTACTS_MAX) && (count > 0)); codeplugContactsCacheBuildIndex++, count--)
 	{
+		int i = codeplugContactsCacheBuildIndex;
+
 		if (SPI_Flash_read((CODEPLUG_ADDR_CONTACTS + (i * CODEPLUG_CONTACT_DATA_SIZE)), (uint8_t *)&contact, 16 + 4 + 1))// Name + TG/ID + Call type
 		{
 			if (contact.name[0] != 0xFF)
@@ -939,6 +1619,7 @@ static void codeplugInitContactsCache(void)
 				codeplugContactsCache.contactsLookupCache[codeplugNumContacts].tgOrPCNum = bcd2int(byteSwap32(contact.tgNumber));
 				codeplugContactsCache.contactsLookupCache[codeplugNumContacts].index = i + 1;// Contacts are numbered from 1 to 1024
 				codeplugContactsCache.contactsLookupCache[codeplugNumContacts].tgOrPCNum |= (contact.callType << 24);// Store the call type in the upper byte
+				codeplugContactsNameIndexAdd(contact.callType, contact.name, (i + 1));
 				if (contact.callType == CONTACT_CALLTYPE_PC)
 				{
 					codeplugContactsCache.numPCContacts++;
@@ -956,20 +1637,42 @@ static void codeplugInitContactsCache(void)
 		}
 	}
 
-	for (int i = 0; i < CODEPLUG_DTMF_CONTACTS_MAX; i++)
+	if (codeplugContactsCacheBuildIndex == CODEPLUG_CONTACTS_MAX)
 	{
-		if (EEPROM_Read(CODEPLUG_ADDR_DTMF_CONTACTS + (i * CODEPLUG_DTMF_CONTACT_DATA_STRUCT_SIZE), (uint8_t *)&c, 1))
+		codeplugContactsRankBuild();
+
+		for (int i = 0; i < CODEPLUG_DTMF_CONTACTS_MAX; i++)
 		{
-			if (c != 0xFF)
+			if (EEPROM_Read(CODEPLUG_ADDR_DTMF_CONTACTS + (i * CODEPLUG_DTMF_CONTACT_DATA_STRUCT_SIZE), (uint8_t *)&c, 1))
 			{
-				codeplugContactsCache.contactsDTMFLookupCache[codeplugContactsCache.numDTMFContacts++].index = i + 1; // Contacts are numbered from 1 to 32
+				if (c != 0xFF)
+				{
+					codeplugContactsCache.contactsDTMFLookupCache[codeplugContactsCache.numDTMFContacts++].index = i + 1; // Contacts are numbered from 1 to 32
+				}
 			}
 		}
+
+		codeplugContactsCacheBuildIndex++; // Complete
+
+		codeplugRxGroupsCacheBuild();
+	}
+
+	return codeplugContactsCacheIsReady();
+}
+
+// Cache not ready yet: the lookups can't return partial results, finish building it now.
+static void codeplugContactsCacheEnsureReady(void)
+{
+	if (codeplugContactsCacheIsReady() == false)
+	{
+		codeplugContactsCacheBuildStep(CODEPLUG_CONTACTS_MAX);
 	}
 }
 
 void codeplugContactsCacheUpdateOrInsertContactAt(int index, struct_codeplugContact_t *contact)
 {
+	codeplugContactsCacheEnsureReady();
+
 	int numContacts =  codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 	int numContactsMinus1 = numContacts - 1;
 
@@ -982,32 +1685,11 @@ void codeplugContactsCacheUpdateOrInsertContactAt(int index, struct_codeplugCont
 
 			if (callType != contact->callType)
 			{
-				switch (callType)
-				{
-					case CONTACT_CALLTYPE_TG:
-						codeplugContactsCache.numTGContacts--;
-						break;
-					case CONTACT_CALLTYPE_PC:
-						codeplugContactsCache.numPCContacts--;
-						break;
-					case CONTACT_CALLTYPE_ALL:
-						codeplugContactsCache.numALLContacts--;
-						break;
-				}
-
-				switch (contact->callType)
-				{
-					case CONTACT_CALLTYPE_TG:
-						codeplugContactsCache.numTGContacts++;
-						break;
-					case CONTACT_CALLTYPE_PC:
-						codeplugContactsCache.numPCContacts++;
-						break;
-					case CONTACT_CALLTYPE_ALL:
-						codeplugContactsCache.numALLContacts++;
-						break;
-				}
+				codeplugContactsCacheTypeRemove(callType, index);
+				codeplugContactsCacheTypeAdd(contact->callType, index);
 			}
+			nameIndexRemove(&codeplugContactsCache.nameIndex, index);
+			codeplugContactsNameIndexAdd(contact->callType, contact->name, index);
 			//update the
 			codeplugContactsCache.contactsLookupCache[i].tgOrPCNum = bcd2int(byteSwap32(contact->tgNumber));
 			codeplugContactsCache.contactsLookupCache[i].tgOrPCNum |= (contact->callType << 24);// Store the call type in the upper byte
@@ -1018,18 +1700,8 @@ void codeplugContactsCacheUpdateOrInsertContactAt(int index, struct_codeplugCont
 		{
 			if((i < numContactsMinus1) && (codeplugContactsCache.contactsLookupCache[i].index < index) && (codeplugContactsCache.contactsLookupCache[i + 1].index > index))
 			{
-				if (contact->callType == CONTACT_CALLTYPE_PC)
-				{
-					codeplugContactsCache.numPCContacts++;
-				}
-				else if (contact->callType == CONTACT_CALLTYPE_TG)
-				{
-					codeplugContactsCache.numTGContacts++;
-				}
-				else if (contact->callType == CONTACT_CALLTYPE_ALL)
-				{
-					codeplugContactsCache.numALLContacts++;
-				}
+				codeplugContactsCacheTypeAdd(contact->callType, index);
+				codeplugContactsNameIndexAdd(contact->callType, contact->name, index);
 
 				numContacts++;// Total contacts increases by 1
 
@@ -1046,18 +1718,8 @@ void codeplugContactsCacheUpdateOrInsertContactAt(int index, struct_codeplugCont
 
 	// Did not find the index in the cache or a gap between 2 existing indexes. So the new contact needs to be added to the end of the cache
 
-	if (contact->callType == CONTACT_CALLTYPE_PC)
-	{
-		codeplugContactsCache.numPCContacts++;
-	}
-	else if (contact->callType == CONTACT_CALLTYPE_TG)
-	{
-		codeplugContactsCache.numTGContacts++;
-	}
-	else if (contact->callType == CONTACT_CALLTYPE_ALL)
-	{
-		codeplugContactsCache.numALLContacts++;
-	}
+	codeplugContactsCacheTypeAdd(contact->callType, index);
+	codeplugContactsNameIndexAdd(contact->callType, contact->name, index);
 
 	// Note. We can use numContacts as the the index as the array is zero indexed but the number of contacts is starts from 1
 	// Hence is already in some ways pre incremented in terms of being an array index
@@ -1068,6 +1730,8 @@ void codeplugContactsCacheUpdateOrInsertContactAt(int index, struct_codeplugCont
 
 void codeplugContactsCacheRemoveContactAt(int index)
 {
+	codeplugContactsCacheEnsureReady();
+
 	int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 	for(int i = 0; i < numContacts; i++)
 	{
@@ -1075,18 +1739,8 @@ void codeplugContactsCacheRemoveContactAt(int index)
 		{
 			uint8_t callType = codeplugContactsCache.contactsLookupCache[i].tgOrPCNum >> 24;
 
-			if (callType == CONTACT_CALLTYPE_PC)
-			{
-				codeplugContactsCache.numPCContacts--;
-			}
-			else if (callType == CONTACT_CALLTYPE_TG)
-			{
-				codeplugContactsCache.numTGContacts--;
-			}
-			else if (callType == CONTACT_CALLTYPE_ALL)
-			{
-				codeplugContactsCache.numALLContacts--;
-			}
+			codeplugContactsCacheTypeRemove(callType, index);
+			nameIndexRemove(&codeplugContactsCache.nameIndex, index);
 			// Note memcpy should work here, because memcpy normally copys from the lowest memory location upwards
 			memcpy(&codeplugContactsCache.contactsLookupCache[i], &codeplugContactsCache.contactsLookupCache[i + 1], (numContacts - 1 - i) * sizeof(codeplugContactCache_t));
 			return;
@@ -1101,6 +1755,8 @@ uint32_t codeplugContactGetPackedId(struct_codeplugContact_t *contact)
 
 int codeplugContactGetFreeIndex(void)
 {
+	codeplugContactsCacheEnsureReady();
+
 	int numContacts = codeplugContactsCache.numTGContacts + codeplugContactsCache.numALLContacts + codeplugContactsCache.numPCContacts;
 	int lastIndex = 0;
 	int i;
@@ -1124,6 +1780,8 @@ int codeplugContactGetFreeIndex(void)
 
 bool codeplugDTMFContactGetDataForIndex(int index, struct_codeplugDTMFContact_t *contact)
 {
+	codeplugContactsCacheEnsureReady();
+
 	if ((codeplugContactsCache.numDTMFContacts > 0) &&  (index >= CODEPLUG_DTMF_CONTACTS_MIN) && (index <= CODEPLUG_DTMF_CONTACTS_MAX))
 	{
 		index--;
@@ -1151,13 +1809,24 @@ static bool codeplugContactGetReserve1ByteForIndex(int index, struct_codeplugCon
 
 bool codeplugContactGetDataForIndex(int index, struct_codeplugContact_t *contact)
 {
+	codeplugContactsCacheEnsureReady();
+
 	char buf[SCREEN_LINE_BUFFER_SIZE];
 
 	if (((codeplugContactsCache.numTGContacts > 0) || (codeplugContactsCache.numPCContacts > 0) || (codeplugContactsCache.numALLContacts > 0)) &&
 			(index >= CODEPLUG_CONTACTS_MIN) && (index <= CODEPLUG_CONTACTS_MAX))
 	{
-		index--;
-		SPI_Flash_read(CODEPLUG_ADDR_CONTACTS + index * CODEPLUG_CONTACT_DATA_SIZE, (uint8_t *)contact, CODEPLUG_CONTACT_DATA_SIZE);
+		if ((codeplugContactsWindow.firstIndex != 0) && (index >= codeplugContactsWindow.firstIndex) &&
+				(index < (codeplugContactsWindow.firstIndex + codeplugContactsWindow.numContacts)))
+		{
+			memcpy((uint8_t *)contact, &codeplugContactsWindow.data[(index - codeplugContactsWindow.firstIndex) * CODEPLUG_CONTACT_DATA_SIZE], CODEPLUG_CONTACT_DATA_SIZE);
+			index--;
+		}
+		else
+		{
+			index--;
+			SPI_Flash_read(CODEPLUG_ADDR_CONTACTS + index * CODEPLUG_CONTACT_DATA_SIZE, (uint8_t *)contact, CODEPLUG_CONTACT_DATA_SIZE);
+		}
 		contact->NOT_IN_CODEPLUGDATA_indexNumber = index + 1;
 		contact->tgNumber = bcd2int(byteSwap32(contact->tgNumber));
 		return true;
@@ -1183,6 +1852,7 @@ int codeplugContactSaveDataForIndex(int index, struct_codeplugContact_t *contact
 
 	index--;
 	contact->tgNumber = byteSwap32(int2bcd(contact->tgNumber));
+	codeplugContactsWindow.firstIndex = 0;
 
 
 	flashWritePos += index * CODEPLUG_CONTACT_DATA_SIZE;// go to the position of the specific index
@@ -1248,6 +1918,10 @@ int codeplugContactSaveDataForIndex(int index, struct_codeplugContact_t *contact
 		codeplugContactsCacheUpdateOrInsertContactAt(index + 1, contact);
 		//initCodeplugContactsCache();// Update the cache
 	}
+
+	// The RX groups may refer to this contact
+	codeplugRxGroupsCacheBuild();
+
 	return retVal;
 }
 
@@ -1388,6 +2062,52 @@ bool codeplugGetOpenGD77CustomData(codeplugCustomDataType_t dataType, uint8_t *d
 	return false;
 }
 
+// Iterates over the custom data blocks of dataType.
+// *blockAddress must be 0 on the first call, and is set to the block's data address (*dataLength to its length).
+bool codeplugFindNextOpenGD77CustomData(codeplugCustomDataType_t dataType, int *blockAddress, int *dataLength)
+{
+	uint8_t tmpBuf[12];
+	int dataHeaderAddress = 12;
+	const int MAX_BLOCK_ADDRESS = 0x10000;
+
+	if (*blockAddress != 0)
+	{
+		dataHeaderAddress = *blockAddress + *dataLength;
+	}
+	else
+	{
+		if ((SPI_Flash_read(0, tmpBuf, 12) == false) || (memcmp("OpenGD77", tmpBuf, 8) != 0))
+		{
+			return false;
+		}
+	}
+
+	codeplugCustomDataBlockHeader_t blockHeader;
+	while ((dataHeaderAddress + sizeof(codeplugCustomDataBlockHeader_t)) < MAX_BLOCK_ADDRESS)
+	{
+		if (SPI_Flash_read(dataHeaderAddress, (uint8_t *)&blockHeader, sizeof(codeplugCustomDataBlockHeader_t)) == false)
+		{
+			return false;
+		}
+
+		// Erased or invalid block
+		if ((blockHeader.dataLength <= 0) || (blockHeader.dataLength > MAX_BLOCK_ADDRESS))
+		{
+			return false;
+		}
+
+		if (blockHeader.dataType == dataType)
+		{
+			*blockAddress = dataHeaderAddress + sizeof(codeplugCustomDataBlockHeader_t);
+			*dataLength = blockHeader.dataLength;
+			return true;
+		}
+
+		dataHeaderAddress += sizeof(codeplugCustomDataBlockHeader_t) + blockHeader.dataLength;
+	}
+
+	return false;
+}
 
 bool codeplugGetGeneralSettings(struct_codeplugGeneralSettings_t *generalSettingsBuffer)
 {
@@ -1500,6 +2220,7 @@ void codeplugInitCaches(void)
 
 	codeplugAllChannelsInitCache();
 	allChannelsTotalNumOfChannels = codeplugAllChannelsGetCount();
+	codeplugChannelCacheInvalidate();
 
 	codeplugZonesInitCache();
 	codeplugRxGroupInitCache();
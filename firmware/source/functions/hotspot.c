@@ -52,6 +52,7 @@
 #include "usb/usb_com.h"
 #include "functions/rxPowerSaving.h"
 #include "user_interface/uiHotspot.h"
+#include "interfaces/crc.h"
 
 #define MMDVM_HEADER_LENGTH 4
 #define concat(a, b) a " GitID #" b ""
@@ -87,6 +88,7 @@ static bool embeddedDataGetRawData(uint8_t *outputData);
 static void embeddedDataSetLC(const DMRLC_t *lc);
 static bool hasTXOverflow(void);
 static bool hasRXOverflow(void);
+static int jitterBufferGetTargetDepth(void);
 
 
 extern LinkItem_t *LinkHead;
@@ -97,9 +99,6 @@ static const uint8_t MS_SOURCED_AUDIO_SYNC[]   = { 0x07, 0xF7, 0xD5, 0xDD, 0x57,
 static const uint8_t SYNC_MASK[]               = { 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 };
 static const uint8_t MMDVM_VOICE_SYNC_PATTERN = 0x20;
 static const int EMBEDDED_DATA_OFFSET = 13;
-static const int TX_BUFFER_MIN_BEFORE_TRANSMISSION = 4;
-static const uint8_t START_FRAME_PATTERN[]  = { 0xFF,0x57,0xD7,0x5D,0xF5,0xD9 };
-static const uint8_t END_FRAME_PATTERN[]    = { 0x5D,0x7F,0x77,0xFD,0x75,0x79 };
 static const uint8_t VOICE_LC_SYNC_FULL[]       = { 0x04, 0x6D, 0x5D, 0x7F, 0x77, 0xFD, 0x75, 0x7E, 0x30 };
 static const uint8_t TERMINATOR_LC_SYNC_FULL[]  = { 0x04, 0xAD, 0x5D, 0x7F, 0x77, 0xFD, 0x75, 0x79, 0x60 };
 static const uint8_t LC_SYNC_MASK_FULL[]        = { 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 };
@@ -199,6 +198,32 @@ static int txStopDelay = 0;
 static int netRXDataTimer = 0;
 static bool rxLCFrameSent = false;
 
+// Network jitter buffer. The prefill depth (number of frames buffered before the transmission starts) follows
+// the interarrival jitter of the voice frames coming from MMDVMHost, and is raised after each underrun.
+static const uint32_t JITTER_BUFFER_FRAME_PERIOD = 60; // One voice frame every 60ms
+static const uint32_t JITTER_BUFFER_MAX_INTERARRIVAL = 1000; // Longer gaps are not jitter (stream boundaries, pauses)
+static const int JITTER_BUFFER_MIN_DEPTH = 3;
+static const int JITTER_BUFFER_MAX_DEPTH = 24;
+static const int JITTER_BUFFER_MAX_DEPTH_BIAS = 4; // At most 240ms added by the underruns
+static const uint8_t JITTER_BUFFER_SEQUENCE_UNKNOWN = 0xFF;
+
+typedef struct
+{
+	uint32_t lastArrivalTime; // ticksGetMillis() value (ms) of the last voice frame arrival
+	bool     hasLastArrival;
+	uint32_t jitterX16; // Interarrival jitter estimate (as RFC 3550), ms * 16
+	int      depthBias; // Extra prefill frames, added on underruns, removed after a clean stream
+	uint8_t  lastVoiceSequence; // 0..5 in the voice superframe
+	bool     streamEnded; // Voice terminator received
+	bool     inUnderrun;
+	uint16_t underrunsAtStreamStart;
+	uint16_t underruns;
+	uint16_t overruns;
+	uint16_t concealedFrames;
+} jitterBuffer_t;
+
+static jitterBuffer_t jitterBuffer;
+
 
 typedef enum
 {
@@ -922,16 +947,14 @@ static void embeddedDataDecodeEmbeddedData(void)
 
 static uint32_t CRC_encodeFiveBit(const bool *in)
 {
-	uint32_t total = 0;
+	uint8_t lc[9];
 
-	for (int i = 0; i < 72; i += 8)
+	for (int i = 0; i < 9; i++)
 	{
-		total += BooleanBitsArrayToByte(in + i);
+		lc[i] = BooleanBitsArrayToByte(in + (i * 8));
 	}
 
-	total %= 31;
-
-	return total;
+	return crcDMREmbeddedLCChecksum(lc);
 }
 
 static void byteToBooleanBitsArray(uint8_t byteIn, bool *bitsOut)
@@ -1763,8 +1786,10 @@ static void swapWithFakeTA(uint8_t *lc)
 
 static void setRSSIToFrame(uint8_t *frameData)
 {
-	frameData[DMR_FRAME_LENGTH_BYTES + MMDVM_HEADER_LENGTH]     = (trxRxSignal >> 8) & 0xFF;
-	frameData[DMR_FRAME_LENGTH_BYTES + MMDVM_HEADER_LENGTH + 1] = (trxRxSignal >> 0) & 0xFF;
+	uint8_t rssi = trxRadioStatusGet()->rssi;
+
+	frameData[DMR_FRAME_LENGTH_BYTES + MMDVM_HEADER_LENGTH]     = 0;
+	frameData[DMR_FRAME_LENGTH_BYTES + MMDVM_HEADER_LENGTH + 1] = rssi;
 }
 
 static bool hotspotSendVoiceFrame(volatile const uint8_t *receivedDMRDataAndAudio)
@@ -1972,20 +1997,116 @@ static bool getEmbeddedData(volatile const uint8_t *comBuffer)
 	return false;
 }
 
-static void storeNetFrame(volatile const uint8_t *comBuffer)
+static void jitterBufferReset(void)
 {
-	bool foundEmbedded;
+	memset(&jitterBuffer, 0, sizeof(jitterBuffer_t));
+	jitterBuffer.lastVoiceSequence = JITTER_BUFFER_SEQUENCE_UNKNOWN;
+}
 
-	if (memcmp((uint8_t *)&comBuffer[18], END_FRAME_PATTERN, 6) == 0)
+static void jitterBufferStreamStart(void)
+{
+	// Lower the prefill again after a stream without underrun
+	if ((jitterBuffer.depthBias > 0) && (jitterBuffer.underruns == jitterBuffer.underrunsAtStreamStart))
 	{
-		return;
+		jitterBuffer.depthBias--;
+	}
+
+	jitterBuffer.underrunsAtStreamStart = jitterBuffer.underruns;
+	jitterBuffer.hasLastArrival = false;
+	jitterBuffer.lastVoiceSequence = JITTER_BUFFER_SEQUENCE_UNKNOWN;
+	jitterBuffer.streamEnded = false;
+}
+
+static void jitterBufferUpdateArrival(void)
+{
+	uint32_t now = ticksGetMillis();
+
+	if (jitterBuffer.hasLastArrival)
+	{
+		uint32_t interArrival = now - jitterBuffer.lastArrivalTime;
+
+		if (interArrival < JITTER_BUFFER_MAX_INTERARRIVAL)
+		{
+			uint32_t deviation = ((interArrival > JITTER_BUFFER_FRAME_PERIOD) ? (interArrival - JITTER_BUFFER_FRAME_PERIOD) : (JITTER_BUFFER_FRAME_PERIOD - interArrival));
+
+			// J = J + (|D| - J) / 16
+			jitterBuffer.jitterX16 = jitterBuffer.jitterX16 + deviation - ((jitterBuffer.jitterX16 + 8) >> 4);
+		}
 	}
 
-	if (memcmp((uint8_t *)&comBuffer[18], START_FRAME_PATTERN, 6) == 0)
+	jitterBuffer.lastArrivalTime = now;
+	jitterBuffer.hasLastArrival = true;
+	jitterBuffer.streamEnded = false;
+}
+
+// Number of frames to buffer before starting the transmission: enough to absorb twice the jitter
+static int jitterBufferGetTargetDepth(void)
+{
+	int jitter = (jitterBuffer.jitterX16 >> 4);
+	int depth = JITTER_BUFFER_MIN_DEPTH + (((2 * jitter) + (JITTER_BUFFER_FRAME_PERIOD - 1)) / JITTER_BUFFER_FRAME_PERIOD) + jitterBuffer.depthBias;
+
+	return SAFE_MIN(depth, JITTER_BUFFER_MAX_DEPTH);
+}
+
+// Called while transmitting, the HR-C6000 sends silence when the buffer is empty.
+static void jitterBufferCheckUnderrun(void)
+{
+	if (wavbuffer_count == 0)
+	{
+		// Running out of frames at the end of the stream is expected
+		if ((jitterBuffer.streamEnded == false) && (jitterBuffer.inUnderrun == false))
+		{
+			jitterBuffer.inUnderrun = true;
+			jitterBuffer.underruns++;
+
+			if (jitterBuffer.depthBias < JITTER_BUFFER_MAX_DEPTH_BIAS)
+			{
+				jitterBuffer.depthBias++;
+			}
+		}
+	}
+	else
+	{
+		jitterBuffer.inUnderrun = false;
+	}
+}
+
+// Appends a voice frame, or a silence frame if comBuffer is NULL, to the hotspot buffer
+static void jitterBufferWriteFrame(volatile const uint8_t *comBuffer)
+{
+	if (wavbuffer_count >= HOTSPOT_BUFFER_COUNT)
 	{
+		// Buffer overflow, the frame is dropped
+		jitterBuffer.overruns++;
 		return;
 	}
 
+	taskENTER_CRITICAL();
+	if (comBuffer != NULL)
+	{
+		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH], (uint8_t *)comBuffer + 4, 13);//copy the first 13, whole bytes of audio
+		audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH + 13] = (comBuffer[17] & 0xF0) | (comBuffer[23] & 0x0F);
+		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH + 14], (uint8_t *)&comBuffer[24], 13);//copy the last 13, whole bytes of audio
+	}
+	else
+	{
+		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH], SILENCE_AUDIO, AMBE_AUDIO_LENGTH);
+	}
+
+	memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx], hotspotTxLC, 9);// copy the current LC into the data (mainly for use with the embedded data);
+	wavbuffer_count++;
+	wavbuffer_write_idx = ((wavbuffer_write_idx + 1) % HOTSPOT_BUFFER_COUNT);
+	taskEXIT_CRITICAL();
+}
+
+// Only called for voice frames, data frames (header, terminator, etc) have been filtered out using the MMDVM control byte
+static void storeNetFrame(volatile const uint8_t *comBuffer)
+{
+	bool foundEmbedded;
+	uint8_t voiceSequence = (comBuffer[MMDVM_HEADER_LENGTH - 1] & 0x0F);// 0 for the voice sync frame (MMDVM_VOICE_SYNC_PATTERN)
+
+	jitterBufferUpdateArrival();
+
 	foundEmbedded = getEmbeddedData(comBuffer);
 
 	if ((foundEmbedded || (nonVolatileSettings.hotspotType == HOTSPOT_TYPE_BLUEDV)) &&
@@ -2000,26 +2121,31 @@ static void storeNetFrame(volatile const uint8_t *comBuffer)
 		hotspotState == HOTSPOT_STATE_TX_SHUTDOWN  ||
 		hotspotState == HOTSPOT_STATE_TX_START_BUFFERING)
 	{
-		if (wavbuffer_count >= HOTSPOT_BUFFER_COUNT)
+		// Conceal one or two lost frames with silence, which keeps the voice superframe sequence.
+		// Bigger gaps (or duplicates) are more likely a new stream, or a resync.
+		if (jitterBuffer.lastVoiceSequence != JITTER_BUFFER_SEQUENCE_UNKNOWN)
 		{
-			// Buffer overflow
-		}
+			int lostFrames = ((voiceSequence + 6 - jitterBuffer.lastVoiceSequence - 1) % 6);
 
-		taskENTER_CRITICAL();
-		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH], (uint8_t *)comBuffer + 4, 13);//copy the first 13, whole bytes of audio
-		audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH + 13] = (comBuffer[17] & 0xF0) | (comBuffer[23] & 0x0F);
-		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx][LC_DATA_LENGTH + 14], (uint8_t *)&comBuffer[24], 13);//copy the last 13, whole bytes of audio
+			if (lostFrames <= 2)
+			{
+				while (lostFrames-- > 0)
+				{
+					jitterBufferWriteFrame(NULL);
+					jitterBuffer.concealedFrames++;
+				}
+			}
+		}
 
-		memcpy((uint8_t *)&audioAndHotspotDataBuffer.hotspotBuffer[wavbuffer_write_idx], hotspotTxLC, 9);// copy the current LC into the data (mainly for use with the embedded data);
-		wavbuffer_count++;
-		wavbuffer_write_idx = ((wavbuffer_write_idx + 1) % HOTSPOT_BUFFER_COUNT);
-		taskEXIT_CRITICAL();
+		jitterBufferWriteFrame(comBuffer);
 	}
+
+	jitterBuffer.lastVoiceSequence = voiceSequence;
 }
 
 static uint8_t hotspotModeReceiveNetFrame(const uint8_t *comBuffer, uint8_t timeSlot)
 {
-	DMRLC_t lc;
+	uint8_t control = comBuffer[MMDVM_HEADER_LENGTH - 1];
 
 	if (!hotspotMmdvmHostIsConnected)
 	{
@@ -2030,32 +2156,44 @@ static uint8_t hotspotModeReceiveNetFrame(const uint8_t *comBuffer, uint8_t time
 
 	netRXDataTimer = RX_NET_FRAME_TIMEOUT;
 
-	lc.srcId = 0;// zero these values as they are checked later in the function, but only updated if the data type is DT_VOICE_LC_HEADER
-	lc.dstId = 0;
-
-	voiceLCHeaderDecode((uint8_t *)comBuffer + MMDVM_HEADER_LENGTH, DT_VOICE_LC_HEADER, &lc);// Need to decode the frame to get the source and destination
-
-	// update the src and destination ID's if valid
-	if 	((lc.srcId != 0) && (lc.dstId != 0))
+	// Classify the frame first, using the MMDVM control byte (sync type and data type or voice sequence),
+	// so the costly BPTC(196,96) LC decoding is only done on the voice LC headers.
+	if ((control & DMR_SYNC_DATA) == 0)
+	{
+		// Voice frame (the embedded data is handled by storeNetFrame())
+		storeNetFrame(comBuffer);
+	}
+	else if ((control & 0x0F) == DT_VOICE_LC_HEADER)
 	{
-		trxTalkGroupOrPcId = lc.dstId | (lc.FLCO << 24);
-		trxDMRID = lc.srcId;
+		DMRLC_t lc;
+
+		jitterBufferStreamStart();
 
-		if (hotspotState != HOTSPOT_STATE_TX_START_BUFFERING)
+		// Need to decode the frame to get the source and destination
+		if (voiceLCHeaderDecode((uint8_t *)comBuffer + MMDVM_HEADER_LENGTH, DT_VOICE_LC_HEADER, &lc) &&
+				((lc.srcId != 0) && (lc.dstId != 0)))
 		{
-			memcpy(hotspotTxLC, lc.rawData, 9);//Hotspot uses LC Data bytes rather than the src and dst ID's for the embed data
+			trxTalkGroupOrPcId = lc.dstId | (lc.FLCO << 24);
+			trxDMRID = lc.srcId;
 
-			lastHeardListUpdate(hotspotTxLC, true);
+			if (hotspotState != HOTSPOT_STATE_TX_START_BUFFERING)
+			{
+				memcpy(hotspotTxLC, lc.rawData, 9);//Hotspot uses LC Data bytes rather than the src and dst ID's for the embed data
+
+				lastHeardListUpdate(hotspotTxLC, true);
 
-			// the Src and Dst Id's have been sent, and we are in RX mode then an incoming Net normally arrives next
-			timeoutCounter = TX_BUFFERING_TIMEOUT;
-			hotspotState = HOTSPOT_STATE_TX_START_BUFFERING;
+				// the Src and Dst Id's have been sent, and we are in RX mode then an incoming Net normally arrives next
+				timeoutCounter = TX_BUFFERING_TIMEOUT;
+				hotspotState = HOTSPOT_STATE_TX_START_BUFFERING;
+			}
 		}
 	}
-	else
+	else if ((control & 0x0F) == DT_TERMINATOR_WITH_LC)
 	{
-		storeNetFrame(comBuffer);
+		// The buffer is expected to run dry from now on
+		jitterBuffer.streamEnded = true;
 	}
+	// Other data frames (CSBK, idle, ...) carry no audio, and their LC isn't used, hence they are dropped, as the terminator.
 
 	return 0;
 }
@@ -2439,7 +2577,8 @@ void hotspotStateMachine(void)
 			}
 			else
 			{
-				if (wavbuffer_count > TX_BUFFER_MIN_BEFORE_TRANSMISSION)
+				// A short over may end before the prefill depth is reached, send what has been received
+				if ((wavbuffer_count >= jitterBufferGetTargetDepth()) || (jitterBuffer.streamEnded && (wavbuffer_count > 0)))
 				{
 					if (hotspotCwKeying == false)
 					{
@@ -2464,6 +2603,8 @@ void hotspotStateMachine(void)
 			break;
 
 		case HOTSPOT_STATE_TRANSMITTING:
+			jitterBufferCheckUnderrun();
+
 			// Stop transmitting when there is no data in the buffer or if MMDVMHost sends the idle command
 			if (((wavbuffer_count == 0) && (--netRXDataTimer <= 0)) || (hotspotModemState == STATE_IDLE))
 			{
@@ -2602,6 +2743,8 @@ void hotspotInit(void)
 
 	rxLCFrameSent = false;
 
+	jitterBufferReset();
+
 	// Clear RF buffers
 	rfFrameBufCount = 0;
 	rfFrameBufReadIdx = 0;
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include <string.h>
+#include "functions/nameIndex.h"
+
+// This code doesn't access any hardware, the index storage is given by the caller.
+
+#define NAME_INDEX_SEARCH_NAME_LENGTH    16
+
+// Keypad key of a character, as in the alpha entry ('2' for 'a', 'b', 'c', ...): 0 for space, 1 for the others
+uint32_t nameIndexCharToKey(char c)
+{
+	static const char lettersKeys[] = "22233344455566677778889999";
+
+	if ((c >= 'a') && (c <= 'z'))
+	{
+		return (lettersKeys[c - 'a'] - '0');
+	}
+	else if ((c >= 'A') && (c <= 'Z'))
+	{
+		return (lettersKeys[c - 'A'] - '0');
+	}
+	else if ((c >= '0') && (c <= '9'))
+	{
+		return (c - '0');
+	}
+
+	return ((c == ' ') ? 0 : 1);
+}
+
+// name ends with a NUL or a 0xFF (codeplug buffers are 0xFF filled)
+static uint32_t nameIndexEntry(uint32_t group, const char *name, int id)
+{
+	uint32_t keys = 0;
+	bool nameEnded = false;
+
+	for (int i = 0; i < NAME_INDEX_KEYS_MAX; i++)
+	{
+		if ((nameEnded == false) && ((name[i] == 0) || ((uint8_t)name[i] == 0xFF)))
+		{
+			nameEnded = true;
+		}
+
+		keys = (keys << 4) | (nameEnded ? NAME_INDEX_KEY_NONE : nameIndexCharToKey(name[i]));
+	}
+
+	return ((group << NAME_INDEX_GROUP_SHIFT) | (keys << NAME_INDEX_KEYS_SHIFT) | (id & NAME_INDEX_ID_MASK));
+}
+
+// Position of the first entry >= entry
+static int nameIndexFind(const nameIndex_t *index, uint32_t entry)
+{
+	int low = 0;
+	int high = index->count;
+
+	while (low < high)
+	{
+		int mid = (low + high) >> 1;
+
+		if (index->entries[mid] < entry)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	return low;
+}
+
+void nameIndexInit(nameIndex_t *index, uint32_t *entries, int capacity)
+{
+	index->entries = entries;
+	index->count = 0;
+	index->capacity = capacity;
+}
+
+bool nameIndexAdd(nameIndex_t *index, uint32_t group, const char *name, int id)
+{
+	if (index->count >= index->capacity)
+	{
+		return false;
+	}
+
+	uint32_t entry = nameIndexEntry(group, name, id);
+	int pos = nameIndexFind(index, entry);
+
+	memmove(&index->entries[pos + 1], &index->entries[pos], (index->count - pos) * sizeof(uint32_t));
+	index->entries[pos] = entry;
+	index->count++;
+
+	return true;
+}
+
+void nameIndexRemove(nameIndex_t *index, int id)
+{
+	for (int i = 0; i < index->count; i++)
+	{
+		if ((index->entries[i] & NAME_INDEX_ID_MASK) == (uint32_t)id)
+		{
+			index->count--;
+			memmove(&index->entries[i], &index->entries[i + 1], (index->count - i) * sizeof(uint32_t));
+			return;
+		}
+	}
+}
+
+// keys: keypad keys ('0' to '9') of the name prefix.
+// Returns the id of the first entry of the group with that prefix, in keys then id order, or -1 if none.
+int nameIndexFindByKeys(const nameIndex_t *index, uint32_t group, const char *keys, int numKeys)
+{
+	uint32_t prefix = 0;
+
+	if ((numKeys < 1) || (numKeys > NAME_INDEX_KEYS_MAX))
+	{
+		return -1;
+	}
+
+	for (int i = 0; i < numKeys; i++)
+	{
+		prefix = (prefix << 4) | ((keys[i] - '0') & 0x0F);
+	}
+
+	int unusedBits = (((NAME_INDEX_KEYS_MAX - numKeys) * 4) + NAME_INDEX_KEYS_SHIFT);
+	uint32_t lowEntry = (group << NAME_INDEX_GROUP_SHIFT) | (prefix << unusedBits);
+	int pos = nameIndexFind(index, lowEntry);
+
+	if ((pos < index->count) && ((index->entries[pos] >> unusedBits) == (lowEntry >> unusedBits)))
+	{
+		return (index->entries[pos] & NAME_INDEX_ID_MASK);
+	}
+
+	return -1;
+}
+
+static int nameIndexCompareNoCase(const char *name, const char *prefix, int prefixLength)
+{
+	for (int i = 0; i < prefixLength; i++)
+	{
+		char a = (((name[i] >= 'a') && (name[i] <= 'z')) ? (name[i] - ('a' - 'A')) : name[i]);
+		char b = (((prefix[i] >= 'a') && (prefix[i] <= 'z')) ? (prefix[i] - ('a' - 'A')) : prefix[i]);
+
+		if (a != b)
+		{
+			return ((uint8_t)a - (uint8_t)b);
+		}
+
+		if (a == 0)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
+
+// Binary search of a name prefix (case insensitive) in a list of count names sorted in that order, read with readName().
+// Returns the position of the first name starting with prefix, or -1 if none (or on read failure).
+// It needs about log2(count) name reads.
+int32_t nameIndexSearchSorted(uint32_t count, const char *prefix, nameIndexReadName_t readName, void *context)
+{
+	char name[NAME_INDEX_SEARCH_NAME_LENGTH + 1];
+	int prefixLength = strlen(prefix);
+	uint32_t low = 0;
+	uint32_t high = count;
+
+	if ((prefixLength == 0) || (prefixLength > NAME_INDEX_SEARCH_NAME_LENGTH))
+	{
+		return -1;
+	}
+
+	while (low < high)
+	{
+		uint32_t mid = (low + high) >> 1;
+
+		memset(name, 0, sizeof(name));
+		if (readName(context, mid, name, NAME_INDEX_SEARCH_NAME_LENGTH) == false)
+		{
+			return -1;
+		}
+
+		if (nameIndexCompareNoCase(name, prefix, prefixLength) < 0)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if (low < count)
+	{
+		memset(name, 0, sizeof(name));
+		if (readName(context, low, name, NAME_INDEX_SEARCH_NAME_LENGTH) && (nameIndexCompareNoCase(name, prefix, prefixLength) == 0))
+		{
+			return low;
+		}
+	}
+
+	return -1;
+}
@@ -66,10 +66,10 @@ static void resumeBeepAndC6000Tasks(void)
 {
 	vTaskResume(hrc6000Task.Handle);
 	hrc6000Task.Running = true;
-	hrc6000Task.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&hrc6000Task);
 	vTaskResume(beepTask.Handle);
 	beepTask.Running = true;
-	beepTask.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&beepTask);
 }
 
 static void suspendBeepAndC6000Tasks(void)
@@ -31,10 +31,14 @@
 #include <ctype.h>
 #include <math.h>
 #include "functions/satellite.h"
+#include "functions/ticks.h"
 #include "interfaces/pit.h"
 #include "user_interface/uiGlobals.h"
 #include "user_interface/menuSystem.h"
 #include "user_interface/uiUtilities.h"
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
 
 #if defined(USING_EXTERNAL_DEBUGGER)
 #include "SeggerRTT/RTT/SEGGER_RTT.h"
@@ -107,6 +111,30 @@ satelliteObserver_t observerData;
 satelliteData_t *currentActiveSatellite;
 static const int MAX_TOTAL_ITERATIONS = 1000;
 
+// Prediction worker task. All the firmware tasks run at the same priority and never block, hence this task can't
+// run at a lower priority without being starved, it instead does a small amount of work then blocks for a tick.
+#define SATELLITE_PREDICTION_ITERATIONS_PER_STEP   100
+#define SATELLITE_PREDICTION_KEEP_ALIVE_MS         2000
+#define SATELLITE_PREDICTION_IDLE_DELAY_MS         100
+
+typedef struct
+{
+	TaskHandle_t					handle;
+	SemaphoreHandle_t				mutex;
+	predictionStateMachineData_t	stateData;
+	ticksTimer_t					keepAliveTimer;
+	uint32_t						numSatellites;
+	uint32_t						currentSatellite;
+	volatile uint32_t				numPredicted;
+	volatile bool					hasUpdate;
+	bool							findSelectedPass;
+	time_t_custom					selectedPassAOS;
+} satellitePredictionWorker_t;
+
+static satellitePredictionWorker_t predictionWorker = { .handle = NULL, .mutex = NULL };
+
+static void satellitePredictionTaskFunction(void *data);
+
 
 float satelliteGetElement(const char *gstr,int gstart,int gstop)
 {
@@ -676,3 +704,349 @@ uint16_t satelliteGetMaximumElevation(satelliteData_t *satelliteData, uint32_t p
 
 	return pass->satelliteMaxElevation;
 }
+
+static void satelliteCalculatePassTrack(const satelliteData_t *satelliteData, const satellitePass_t *pass, satelliteTrack_t *track)
+{
+	satelliteResults_t results;
+	time_t_custom t = pass->satelliteAOS;
+
+	track->stepSecs = (pass->satellitePassDuration + (SATELLITE_TRACK_MAX_POINTS - 2)) / (SATELLITE_TRACK_MAX_POINTS - 1);
+	if (track->stepSecs < SATELLITE_TRACK_MIN_STEP_SECS)
+	{
+		track->stepSecs = SATELLITE_TRACK_MIN_STEP_SECS;
+	}
+
+	track->numPoints = 0;
+	while (track->numPoints < SATELLITE_TRACK_MAX_POINTS)
+	{
+		if (t > pass->satelliteLOS)
+		{
+			t = pass->satelliteLOS;// always finish the track at LOS
+		}
+
+		satelliteCalculateForDateTimeSecs(satelliteData, t, &results, SATELLITE_PREDICTION_LEVEL_TIME_EL_AND_AZ);
+		track->points[track->numPoints++] = SATELLITE_TRACK_PACK_POINT(results.azimuthAsInteger, MAX(results.elevationAsInteger, 0));
+
+		if (t == pass->satelliteLOS)
+		{
+			break;
+		}
+		t += track->stepSecs;
+	}
+
+	track->passAOS = pass->satelliteAOS;
+}
+
+// Returns the cached track for the pass, or NULL if the track has not been calculated yet
+const satelliteTrack_t *satelliteGetPassTrack(const satelliteData_t *satelliteData, uint32_t passNumber)
+{
+	const satellitePass_t *pass = &satelliteData->predictions.passes[passNumber];
+
+	if ((pass->valid == PREDICTION_RESULT_OK) && (satelliteData->predictions.track.passAOS == pass->satelliteAOS) && (satelliteData->predictions.track.numPoints > 0))
+	{
+		return &satelliteData->predictions.track;
+	}
+
+	return NULL;
+}
+
+// Calculate the track of the selected pass of the active satellite, as well as the next pass of each satellite once it has been predicted.
+static void satelliteUpdatePassTrack(satelliteData_t *satellite, uint32_t passNumber)
+{
+	satelliteTrack_t track;
+	satellitePass_t *pass = &satellite->predictions.passes[passNumber];
+
+	if ((pass->valid != PREDICTION_RESULT_OK) || (satellite->predictions.track.passAOS == pass->satelliteAOS))
+	{
+		return;
+	}
+
+	satelliteCalculatePassTrack(satellite, pass, &track);
+
+	taskENTER_CRITICAL();
+	memcpy(&satellite->predictions.track, &track, sizeof(satelliteTrack_t));
+	taskEXIT_CRITICAL();
+}
+
+// Returns true once the prediction of a pass has completed, or the prediction limit has been reached.
+static bool satellitePredictionCalculateStep(satelliteData_t *satellite)
+{
+	satelliteResults_t results;
+	bool isVisible = ((uiDataGlobal.dateTimeSecs >= satellite->predictions.passes[0].satelliteAOS) && (uiDataGlobal.dateTimeSecs <= satellite->predictions.passes[0].satelliteLOS));
+
+	if (satellite->predictions.isVisible != isVisible)
+	{
+		satellite->predictions.isVisible = isVisible;
+		predictionWorker.hasUpdate = true;
+	}
+
+	// Force rebuilding of the prediction if the the time is after the LOS of the first predicted pass
+	if ((satellite->predictions.numPasses > 0) && (uiDataGlobal.dateTimeSecs > satellite->predictions.passes[0].satelliteLOS) && !satellite->predictions.isPredicting)
+	{
+		predictionWorker.findSelectedPass = false;
+		if (satellite->predictions.selectedPassNumber != 0)
+		{
+			predictionWorker.selectedPassAOS = satellite->predictions.passes[satellite->predictions.selectedPassNumber].satelliteAOS;
+			if (predictionWorker.selectedPassAOS >= uiDataGlobal.dateTimeSecs)
+			{
+				predictionWorker.findSelectedPass = true;
+			}
+		}
+
+		// find passes which are in the past
+		int passNum;
+		for(passNum = 0; passNum < satellite->predictions.numPasses; passNum++)
+		{
+			if (!(uiDataGlobal.dateTimeSecs > satellite->predictions.passes[passNum].satelliteLOS))
+			{
+				break;
+			}
+		}
+		int numPassesToMove = satellite->predictions.numPasses - passNum;
+		int numPassesToClear = NUM_SATELLITE_PREDICTIONS - numPassesToMove;
+
+		// The UI reads the passes while they are being shifted
+		taskENTER_CRITICAL();
+		memmove(&satellite->predictions.passes[0], &satellite->predictions.passes[passNum], numPassesToMove * sizeof(satellitePass_t));
+		memset(&satellite->predictions.passes[numPassesToMove], 0x00, (numPassesToClear) * sizeof(satellitePass_t));// clear all predictions for this satellite
+
+		satellite->predictions.numPasses = numPassesToMove;
+		satellite->predictions.numPassBeingPredicted = numPassesToMove;
+		satellite->predictions.listDisplayPassSearchStartIndex = 0;
+		satellite->predictions.selectedPassNumber = 0;
+		satellite->predictions.isPredicting = true;
+		satellite->predictions.isVisible = false;
+		taskEXIT_CRITICAL();
+
+		if (predictionWorker.numPredicted > 0)
+		{
+			predictionWorker.numPredicted--;
+		}
+		predictionWorker.hasUpdate = true;
+	}
+
+	if (satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid == PREDICTION_RESULT_NONE)
+	{
+		time_t_custom predictionStartTime;
+		uint32_t passNumber = satellite->predictions.numPassBeingPredicted;
+		satellitePass_t *pass = &satellite->predictions.passes[passNumber];
+
+		if ((passNumber == 0) && (predictionWorker.stateData.state == PREDICTION_STATE_NONE))
+		{
+			satelliteCalculateForDateTimeSecs(satellite, uiDataGlobal.dateTimeSecs, &results, SATELLITE_PREDICTION_LEVEL_TIME_AND_ELEVATION_ONLY);
+
+			if (results.elevation < 0)
+			{
+				predictionStartTime = uiDataGlobal.dateTimeSecs;
+			}
+			else
+			{
+				predictionStartTime = uiDataGlobal.dateTimeSecs - (30 * 60);// If satellite is currently visible. Change prediction start back  30 mins
+			}
+		}
+		else if (passNumber == 0)
+		{
+			predictionStartTime = 0;// not used once the state machine has been initialised
+		}
+		else
+		{
+			predictionStartTime = satellite->predictions.passes[passNumber - 1].satelliteAOS +
+					satellite->predictions.passes[passNumber - 1].satellitePassDuration + 30 * 60;// 30 minutes after the last pass
+		}
+
+		if (predictionWorker.stateData.state == PREDICTION_STATE_NONE)
+		{
+			predictionWorker.stateData.state = PREDICTION_STATE_INIT_AOS;// Start the prediction
+		}
+
+		if (!satellitePredictNextPassFromDateTimeSecs(&predictionWorker.stateData, satellite, predictionStartTime, (uiDataGlobal.dateTimeSecs + (24 * 60 * 60)),
+				SATELLITE_PREDICTION_ITERATIONS_PER_STEP, pass))
+		{
+			pass->valid = PREDICTION_RESULT_NONE;
+		}
+
+		switch(predictionWorker.stateData.state)
+		{
+			case PREDICTION_STATE_COMPLETE:
+				if (pass->satelliteAOS != 0)
+				{
+					if ((satellite->predictions.numPasses + 1) < (NUM_SATELLITE_PREDICTIONS - 1))
+					{
+						pass->valid = PREDICTION_RESULT_OK;
+						satellite->predictions.numPasses++;
+
+						if (predictionWorker.findSelectedPass && (predictionWorker.selectedPassAOS == pass->satelliteAOS))
+						{
+							satellite->predictions.selectedPassNumber = passNumber;
+							predictionWorker.findSelectedPass = false;
+						}
+
+						if (passNumber == 0)
+						{
+							satelliteUpdatePassTrack(satellite, 0);
+						}
+
+						satellite->predictions.numPassBeingPredicted++;
+					}
+					else
+					{
+						pass->valid = PREDICTION_RESULT_LIMIT;
+						satellite->predictions.isPredicting = false;
+					}
+				}
+				predictionWorker.stateData.state = PREDICTION_STATE_NONE;
+				break;
+
+			case PREDICTION_STATE_ITERATION_LIMIT:
+				// Do something. There has been a problem while computing the predictions
+			case PREDICTION_STATE_LIMIT:
+				pass->valid = PREDICTION_RESULT_LIMIT;
+				predictionWorker.stateData.state = PREDICTION_STATE_NONE;
+				satellite->predictions.isPredicting = false;
+				predictionWorker.findSelectedPass = false;
+				return true;
+				break;
+
+			case PREDICTION_STATE_NONE:
+			case PREDICTION_STATE_INIT_AOS:
+			case PREDICTION_STATE_FIND_AOS:
+			case PREDICTION_STATE_INIT_LOS:
+			case PREDICTION_STATE_FIND_LOS:
+				pass->valid = PREDICTION_RESULT_NONE;// move on to next pass
+				return false;
+				break;
+		}
+	}
+	return true;
+}
+
+static void satellitePredictionWorkerStep(void)
+{
+	satelliteData_t *satellite = &satelliteDataNative[predictionWorker.currentSatellite];
+
+	if (satellitePredictionCalculateStep(satellite))
+	{
+		if (predictionWorker.numPredicted < predictionWorker.numSatellites)
+		{
+			if (satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid == PREDICTION_RESULT_LIMIT)
+			{
+				predictionWorker.currentSatellite = (predictionWorker.currentSatellite + 1) % predictionWorker.numSatellites;
+				predictionWorker.numPredicted++;
+				predictionWorker.hasUpdate = true;
+			}
+		}
+		else
+		{
+			// keep sweeping in case any of the satellites goes LOS and the predictions need to be re-run.
+			predictionWorker.currentSatellite = (predictionWorker.currentSatellite + 1) % predictionWorker.numSatellites;
+		}
+	}
+
+	if ((currentActiveSatellite != NULL) && (currentActiveSatellite->predictions.numPasses > 0))
+	{
+		satelliteUpdatePassTrack(currentActiveSatellite, currentActiveSatellite->predictions.selectedPassNumber);
+	}
+}
+
+static void satellitePredictionTaskFunction(void *data)
+{
+	while (1U)
+	{
+		bool isActive = false;
+
+		if (xSemaphoreTakeRecursive(predictionWorker.mutex, portMAX_DELAY) == pdTRUE)
+		{
+			isActive = ((predictionWorker.numSatellites > 0) && !ticksTimerHasExpired(&predictionWorker.keepAliveTimer));
+
+			if (isActive)
+			{
+				satellitePredictionWorkerStep();
+			}
+
+			xSemaphoreGiveRecursive(predictionWorker.mutex);
+		}
+
+		vTaskDelay(((isActive ? 1 : SATELLITE_PREDICTION_IDLE_DELAY_MS) / portTICK_PERIOD_MS));
+	}
+}
+
+static bool satellitePredictionTaskCreateMutex(void)
+{
+	if (predictionWorker.mutex == NULL)
+	{
+		predictionWorker.mutex = xSemaphoreCreateRecursiveMutex();
+	}
+
+	return (predictionWorker.mutex != NULL);
+}
+
+void satellitePredictionTaskStart(void)
+{
+	satellitePredictionTaskKeepAlive();
+
+	if ((predictionWorker.handle != NULL) || (satellitePredictionTaskCreateMutex() == false))
+	{
+		return;
+	}
+
+	xTaskCreate(satellitePredictionTaskFunction,  /* pointer to the task */
+			"satelliteTask",                      /* task name for kernel awareness debugging */
+			2000L / sizeof(portSTACK_TYPE),       /* task stack size */
+			NULL,                                 /* optional task startup argument */
+			3U,                                   /* initial priority */
+			&predictionWorker.handle              /* optional task handle to create */
+	);
+}
+
+// Must be held while the satellite data or the predictions are changed outside of the worker task (e.g. TLE reload, date/time or location change),
+// and while the passes or the track are read by the UI. It's recursive, so the UI can take it around code which also takes it.
+void satellitePredictionTaskLock(void)
+{
+	if (satellitePredictionTaskCreateMutex())
+	{
+		xSemaphoreTakeRecursive(predictionWorker.mutex, portMAX_DELAY);
+	}
+}
+
+void satellitePredictionTaskUnlock(void)
+{
+	if (predictionWorker.mutex != NULL)
+	{
+		xSemaphoreGiveRecursive(predictionWorker.mutex);
+	}
+}
+
+// Restart the predictions from scratch. The predictions of all the satellites must already have been cleared.
+void satellitePredictionTaskReset(uint32_t numSatellites)
+{
+	memset(&predictionWorker.stateData, 0x00, sizeof(predictionStateMachineData_t));
+	predictionWorker.stateData.state = PREDICTION_STATE_NONE;
+	predictionWorker.numSatellites = numSatellites;
+	predictionWorker.currentSatellite = 0;
+	predictionWorker.numPredicted = 0;
+	predictionWorker.findSelectedPass = false;
+	predictionWorker.hasUpdate = true;
+}
+
+// The worker only runs while the satellite screen keeps it alive
+void satellitePredictionTaskKeepAlive(void)
+{
+	ticksTimerStart(&predictionWorker.keepAliveTimer, SATELLITE_PREDICTION_KEEP_ALIVE_MS);
+}
+
+uint32_t satellitePredictionTaskGetNumPredicted(void)
+{
+	return predictionWorker.numPredicted;
+}
+
+// Returns true (once) if the predictions or the visibility of a satellite have changed since the last call
+bool satellitePredictionTaskHasUpdate(void)
+{
+	if (predictionWorker.hasUpdate)
+	{
+		predictionWorker.hasUpdate = false;
+		return true;
+	}
+
+	return false;
+}
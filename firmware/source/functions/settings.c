@@ -37,10 +37,12 @@
 #include "functions/rxPowerSaving.h"
 
 
-#define STORAGE_MAGIC_NUMBER          0x4768 // NOTE: never use 0xDEADBEEF, it's reserved value
+#define STORAGE_MAGIC_NUMBER          0x4769 // NOTE: never use 0xDEADBEEF, it's reserved value
+#define STORAGE_MAGIC_NUMBER_NO_CRC   0x4768 // Same layout, saved without the storage CRC trailer
 // 0x4764: moves location at the top of the struct, make it upgradable.
 // 0x4767: adds apo entry, upgradable.
 // 0x4768: settings struct reorg
+// 0x4769: adds the storage CRC trailer, upgradable.
 
 const uint32_t SETTINGS_UNITIALISED_LOCATION_LAT = 0x7F000000;
 
@@ -96,6 +98,12 @@ bool settingsLoadSettings(void)
 		nonVolatileSettings.magicNumber = 0;// flag settings could not be loaded
 	}
 
+	// Only the storage trailer has been added since, it will be written on the next save
+	if (nonVolatileSettings.magicNumber == STORAGE_MAGIC_NUMBER_NO_CRC)
+	{
+		nonVolatileSettings.magicNumber = STORAGE_MAGIC_NUMBER;
+	}
+
 	if (nonVolatileSettings.magicNumber != STORAGE_MAGIC_NUMBER)
 	{
 		hasRestoredDefaultsettings = settingsRestoreDefaultSettings();
@@ -150,9 +158,11 @@ bool settingsLoadSettings(void)
 	}
 	//codeplugGetGeneralSettings(&settingsCodeplugGeneralSettings);
 
-	if (nonVolatileSettings.languageIndex >= NUM_LANGUAGES)
+	// Older firmwares saved the position in their languages table, the language ID is saved now
+	uint8_t languageSetting = languagesSettingFromLegacy(nonVolatileSettings.languageIndex);
+	if (languageSetting != nonVolatileSettings.languageIndex)
 	{
-		nonVolatileSettings.languageIndex = 0U; // Reset to English
+		nonVolatileSettings.languageIndex = languageSetting;
 		settingsSetDirty();
 	}
 	else
@@ -160,7 +170,13 @@ bool settingsLoadSettings(void)
 		settingsDirty = false;
 	}
 
-	currentLanguage = &languages[nonVolatileSettings.languageIndex];
+	// The language pack may have been removed since the settings were saved. English is used, but the setting
+	// is kept, so the language comes back with its pack.
+	int languageIndex = languagesGetIndexFromSetting(nonVolatileSettings.languageIndex);
+	if ((languageIndex == -1) || (languagesSetCurrent(languageIndex) == false))
+	{
+		languagesSetCurrent(0);
+	}
 
 	soundBeepVolumeDivider = nonVolatileSettings.beepVolumeDivider;
 
@@ -289,7 +305,7 @@ bool settingsRestoreDefaultSettings(void)
 	nonVolatileSettings.dmrCaptureTimeout = 10U;// Default to holding 10 seconds after a call ends
 	nonVolatileSettings.analogFilterLevel = ANALOG_FILTER_CSS;
 	trxSetAnalogFilterLevel(nonVolatileSettings.analogFilterLevel);
-	nonVolatileSettings.languageIndex = 0U;
+	nonVolatileSettings.languageIndex = LANGUAGE_SETTING_FROM_ID(LANGUAGE_ID_ENGLISH);
 	nonVolatileSettings.scanDelay = 5U;// 5 seconds
 	nonVolatileSettings.scanStepTime = 0;// 30ms
 	nonVolatileSettings.scanModePause = SCAN_MODE_HOLD;
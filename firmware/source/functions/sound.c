@@ -225,7 +225,7 @@ void soundInitBeepTask(void)
 	);
 
 	beepTask.Running = true;
-	beepTask.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&beepTask);
 }
 
 void soundInit(void)
@@ -487,7 +487,7 @@ static void soundBeepTaskFunction(void *data)
 	{
 		if (timer_beeptask == 0)
 		{
-			beepTask.AliveCount = TASK_FLAGGED_ALIVE;
+			watchdogTaskAlive(&beepTask);
 
 			if (sine_beep_duration > 0)
 			{
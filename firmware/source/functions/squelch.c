@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+#include "functions/squelch.h"
+
+// Squelch decision from the AT1846S noise samples.
+//
+// This code doesn't access any hardware, it's only fed with the samples.
+//
+// The noise is low-pass filtered (exponential average, 1/2 weight to the new sample) and compared
+// to separate open (level) and close (level + SQUELCH_HYSTERESIS) thresholds, so a noisy signal
+// hovering around the level doesn't make the squelch chatter. A raw sample far below the level
+// opens the squelch right away (strong signal), and a raw sample far above the close threshold
+// closes it right away (signal gone).
+//
+// Only the noise decides: the squelch level setting is a noise value, the RSSI reading isn't calibrated
+// (it varies with the band and the radio), and the CSS tone is checked by trx.c once the squelch is open.
+
+#define SQUELCH_FILTER_SHIFT     2
+
+void squelchInit(squelchState_t *sq)
+{
+	sq->noiseFiltered = (255 << SQUELCH_FILTER_SHIFT);
+	sq->closeCount = 0;
+	sq->primed = false;
+	sq->open = false;
+}
+
+// Feed a new noise sample, returns the squelch state (true: open)
+bool squelchUpdate(squelchState_t *sq, uint8_t noise, uint8_t level)
+{
+	int closeLevel = level + SQUELCH_HYSTERESIS;
+	int filtered;
+
+	if (sq->primed)
+	{
+		filtered = sq->noiseFiltered;
+		filtered += (((int)noise << SQUELCH_FILTER_SHIFT) - filtered) / 2;
+	}
+	else
+	{
+		filtered = ((int)noise << SQUELCH_FILTER_SHIFT);
+		sq->primed = true;
+	}
+	sq->noiseFiltered = (uint16_t)filtered;
+
+	if (sq->open)
+	{
+		if ((noise >= (closeLevel + SQUELCH_FAST_MARGIN)) ||
+				((filtered >> SQUELCH_FILTER_SHIFT) >= closeLevel))
+		{
+			sq->closeCount++;
+
+			if ((noise >= (closeLevel + SQUELCH_FAST_MARGIN)) || (sq->closeCount >= SQUELCH_CLOSE_SAMPLES))
+			{
+				sq->open = false;
+				sq->closeCount = 0;
+				// Forget the signal, next opening shouldn't be delayed by the filter history
+				sq->noiseFiltered = ((int)noise << SQUELCH_FILTER_SHIFT);
+			}
+		}
+		else
+		{
+			sq->closeCount = 0;
+		}
+	}
+	else
+	{
+		if (((noise + SQUELCH_FAST_MARGIN) < level) || ((filtered >> SQUELCH_FILTER_SHIFT) < level))
+		{
+			sq->open = true;
+			sq->closeCount = 0;
+			// Same here, start the average from this sample.
+			sq->noiseFiltered = ((int)noise << SQUELCH_FILTER_SHIFT);
+		}
+	}
+
+	return sq->open;
+}
+
+bool squelchIsOpen(const squelchState_t *sq)
+{
+	return sq->open;
+}
+
+// True if the filtered noise is close enough to the thresholds for the next sample to change the state,
+// the radio status sampler then speeds up.
+bool squelchIsMarginal(const squelchState_t *sq, uint8_t level)
+{
+	int noise = (sq->noiseFiltered >> SQUELCH_FILTER_SHIFT);
+
+	return (sq->primed && (noise >= (level - SQUELCH_MARGINAL_MARGIN)) && (noise <= (level + SQUELCH_HYSTERESIS + SQUELCH_MARGINAL_MARGIN)));
+}
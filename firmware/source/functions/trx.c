@@ -35,6 +35,7 @@
 #include "functions/settings.h"
 #include "functions/trx.h"
 #include "functions/rxPowerSaving.h"
+#include "functions/squelch.h"
 #include "user_interface/menuSystem.h"
 #include "user_interface/uiUtilities.h"
 #include <FreeRTOS.h>
@@ -160,13 +161,19 @@ enum CAL_DEV_TONE_INDEXES { CAL_DEV_DTMF = 0, CAL_DEV_TONE = 1, CAL_DEV_CTCSS_WI
 
 const uint32_t RSSI_NOISE_SAMPLE_PERIOD_PIT = 25;// 25 milliseconds
 
+// Radio status sampler periods, in milliseconds
+#define TRX_RADIO_STATUS_PERIOD_FAST     10 // Scanning, or noise close to the squelch level
+#define TRX_RADIO_STATUS_PERIOD_ECO      50 // Eco mode, with the squelch closed
+
 static uint16_t txDACDrivePower;
 static int txPowerLevel = -1;
 static bool analogSignalReceived = false;
 static bool analogTriggeredAudio = false;
 static bool digitalSignalReceived = false;
 static ticksTimer_t trxNextRssiNoiseSampleTimer = { 0, 0 };
-static ticksTimer_t trxNextSquelchCheckingTimer = { 0, 0 };
+static ticksTimer_t trxCssHoldTimer = { 0, 0 };
+static squelchState_t trxSquelch;
+static uint32_t trxSquelchLastSequence = 0;
 
 static uint8_t trxCssMeasureCount = 0;
 
@@ -176,7 +183,7 @@ static int currentRxFrequency = -1;
 static int currentTxFrequency = -1;
 static uint8_t currentCC = 1;
 
-#define CTCSS_HOLD_DELAY            6
+#define CTCSS_HOLD_DELAY_MS       150
 #define SQUELCH_CLOSE_DELAY         1
 
 #define SIZE_OF_FILL_BUFFER       128 // Tested by Jose EA5SW, and it's needed, 64 makes the beeps and audio to disappear.
@@ -197,10 +204,8 @@ static uint8_t tx_fl_h;
 static uint8_t tx_fh_l;
 static uint8_t tx_fh_h;
 
-volatile uint8_t trxRxSignal = 0;
-volatile uint8_t trxRxNoise = 255;
-volatile uint8_t trxTxVox;
-volatile uint8_t trxTxMic;
+static trxRadioStatus_t trxRadioStatusBuffers[2] = { { .noise = 255 }, { .noise = 255 } };
+static volatile uint8_t trxRadioStatusPublished = 0;
 
 static uint8_t trxSaveVoiceGainTx = 0xff;
 static uint16_t trxSaveDeviation = 0xff;
@@ -231,6 +236,47 @@ static bool powerUpDownState = true;
 
 static uint8_t padrv_ibit;// Tx Drive of AT1846S
 
+// Tuning profiles hold the calibration dependent HR-C6000 and AT1846S register values for a band/frequency offset/mode/bandwidth,
+// so scanning and dual watch don't need to compute them on each frequency change.
+#define TRX_TUNING_PROFILES_CACHE_SIZE  4
+
+typedef struct
+{
+	bool     valid;
+	uint8_t  calBand;
+	uint8_t  freqOffset;
+	uint8_t  mode;
+	bool     bandwidthIs25kHz;
+	// HR-C6000
+#if false
+	uint8_t  dacDataShift;
+#endif
+	uint8_t  mod2Offset;
+	uint8_t  phaseReduce;
+	uint16_t twoPointMod;
+	// AT1846S
+	uint8_t  pgaGain;
+	uint8_t  voiceGainTx;
+	uint8_t  gainTx;
+	uint8_t  padrvIbit;
+	uint8_t  dacVGainAnalog;
+	uint8_t  volumeAnalog;
+	uint16_t xmitterDev;
+	uint16_t noise1Th;
+	uint16_t noise2Th;
+	uint16_t rssi3Th;
+	uint16_t squelchTh;
+} trxTuningProfile_t;
+
+static trxTuningProfile_t trxTuningProfiles[TRX_TUNING_PROFILES_CACHE_SIZE];
+static int trxTuningProfilesNextSlot = 0;
+static trxTuningProfile_t trxAT1846SImage = { .valid = false };// Values currently set in the AT1846S
+
+#if defined(TRX_RETUNE_TIMING)
+static uint32_t trxRetuneLastCycles = 0;
+static uint32_t trxRetuneMaxCycles = 0;
+#endif
+
 static uint8_t trxAnalogFilterLevel = ANALOG_FILTER_CSS;
 
 volatile bool trxDMRSynchronisedRSSIReadPending = false;
@@ -239,6 +285,7 @@ static uint16_t convertCSSNative2BinaryCodedOctal(uint16_t nativeCSS);
 static uint32_t dcsGetBitPatternFromCode(uint16_t dcs);
 static void trxUpdateC6000Calibration(void);
 static void trxUpdateAT1846SCalibration(void);
+static void trxTuningImageInvalidate(void);
 
 //
 // =================================================================
@@ -274,8 +321,8 @@ void trxSetModeAndBandwidth(int mode, bool bandwidthIs25kHz)
 
 	digitalSignalReceived = false;
 	analogSignalReceived = false;
+	squelchInit(&trxSquelch);
 	ticksTimerStart(&trxNextRssiNoiseSampleTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
-	ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 	trxCssMeasureCount = 0;
 	//rxCSSTriggerCount = 0;
 
@@ -298,6 +345,7 @@ void trxSetModeAndBandwidth(int mode, bool bandwidthIs25kHz)
 				soundTerminateSound();
 				HRC6000TerminateDigital();
 				radioSetMode(); // Set to digital (as fallback)
+				trxTuningImageInvalidate();
 				trxUpdateC6000Calibration();
 				trxUpdateAT1846SCalibration();
 				break;
@@ -309,12 +357,14 @@ void trxSetModeAndBandwidth(int mode, bool bandwidthIs25kHz)
 				//GPIO_PinWrite(GPIO_RX_audio_mux, Pin_RX_audio_mux, 1); // connect AT1846S audio to speaker
 				HRC6000TerminateDigital();
 				radioSetMode();
+				trxTuningImageInvalidate();
 				trxUpdateC6000Calibration();
 				trxUpdateAT1846SCalibration();
 				break;
 			case RADIO_MODE_DIGITAL:
 				currentBandWidthIs25kHz = BANDWIDTH_12P5KHZ;// DMR bandwidth is 12.5kHz
 				radioSetMode();// Also sets the bandwidth to 12.5kHz which is the standard for DMR
+				trxTuningImageInvalidate();
 				trxUpdateC6000Calibration();
 				trxUpdateAT1846SCalibration();
 				GPIO_PinWrite(GPIO_TX_audio_mux, Pin_TX_audio_mux, 1); // Connect mic to MIC_P input of HR-C6000
@@ -415,70 +465,203 @@ bool trxCheckFrequencyInAmateurBand(int frequency)
 	return true;// Setting must be BAND_LIMITS_NONE
 }
 
-void trxReadVoxAndMicStrength(void)
+// Squelch level the noise value is compared to (the channel's one is only used in analog)
+static uint8_t trxGetSquelchLevel(void)
+{
+	if ((currentMode == RADIO_MODE_ANALOG) && (currentChannelData->sql != 0))
+	{
+		return (TRX_SQUELCH_MAX - (((currentChannelData->sql - 1) * 11) >> 2));
+	}
+
+	return (TRX_SQUELCH_MAX - (((nonVolatileSettings.squelchDefaults[trxCurrentBand[TRX_RX_FREQ_BAND]]) * 11) >> 2));
+}
+
+// Latest published radio status snapshot.
+// It's written by the sampler in the other buffer, hence the returned pointer should not be kept.
+const trxRadioStatus_t *trxRadioStatusGet(void)
+{
+	return &trxRadioStatusBuffers[trxRadioStatusPublished];
+}
+
+// Reads the requested AT1846S status registers in a single pass, then publishes a new snapshot.
+void trxRadioStatusSample(uint8_t fields)
+{
+	uint8_t val1, val2;
+
+	if (rxPowerSavingIsRxOn() == false)
+	{
+		fields &= ~(TRX_RADIO_STATUS_RSSI_NOISE | TRX_RADIO_STATUS_CSS_FLAGS);
+	}
+
+	if (fields == 0)
+	{
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	const trxRadioStatus_t *current = &trxRadioStatusBuffers[trxRadioStatusPublished];
+	trxRadioStatus_t *next = &trxRadioStatusBuffers[trxRadioStatusPublished ^ 1];
+
+	*next = *current;
+	next->fields = 0;
+
+	if (fields & TRX_RADIO_STATUS_RSSI_NOISE)
+	{
+		val1 = next->rssi;
+		val2 = next->noise;
+		if (radioReadReg2byte(0x1b, &val1, &val2) == kStatus_Success)
+		{
+			next->rssi = val1;
+			next->noise = val2;
+			next->fields |= TRX_RADIO_STATUS_RSSI_NOISE;
+		}
+		trxDMRSynchronisedRSSIReadPending = false;
+	}
+
+	if (fields & TRX_RADIO_STATUS_CSS_FLAGS)
+	{
+		val1 = next->cssFlagsH;
+		val2 = next->cssFlagsL;
+		if (radioReadReg2byte(0x1c, &val1, &val2) == kStatus_Success)
+		{
+			next->cssFlagsH = val1;
+			next->cssFlagsL = val2;
+			next->fields |= TRX_RADIO_STATUS_CSS_FLAGS;
+		}
+	}
+
+	if (fields & TRX_RADIO_STATUS_VOX_MIC)
+	{
+		val1 = next->vox;
+		val2 = next->mic;
+		if (radioReadReg2byte(0x1a, &val1, &val2) == kStatus_Success)
+		{
+			next->vox = val1;
+			next->mic = val2;
+			next->fields |= TRX_RADIO_STATUS_VOX_MIC;
+		}
+	}
+
+	next->timestamp = ticksGetMillis();
+	next->sequence = current->sequence + 1;
+	trxRadioStatusPublished ^= 1;
+	taskEXIT_CRITICAL();
+}
+
+// Samples the registers only if the published snapshot is too old, or doesn't hold them.
+// Returns true if a new pass has been made.
+bool trxRadioStatusSampleIfOlderThan(uint8_t fields, uint32_t maxAge)
+{
+	const trxRadioStatus_t *status = trxRadioStatusGet();
+
+	if (((status->fields & fields) != fields) || ((ticksGetMillis() - status->timestamp) >= maxAge))
+	{
+		trxRadioStatusSample(fields);
+		return true;
+	}
+
+	return false;
+}
+
+// Registers needed by the consumers in the current radio state
+static uint8_t trxRadioStatusGetNeededFields(void)
+{
+	if (trxTransmissionEnabled)
+	{
+		return 0; // The mic level is sampled on demand (see uiUtilityDrawFMMicLevelBarGraph())
+	}
+
+	return (TRX_RADIO_STATUS_RSSI_NOISE | (((currentMode == RADIO_MODE_ANALOG) && rxCSSactive) ? TRX_RADIO_STATUS_CSS_FLAGS : 0));
+}
+
+// Faster while scanning or if the squelch is about to open or close, slower in eco mode when nothing is received.
+static uint32_t trxRadioStatusGetSamplingPeriod(void)
+{
+	if (uiDataGlobal.Scan.active || squelchIsMarginal(&trxSquelch, trxGetSquelchLevel()))
+	{
+		return TRX_RADIO_STATUS_PERIOD_FAST;
+	}
+
+	if ((nonVolatileSettings.ecoLevel > 0) && (squelchIsOpen(&trxSquelch) == false))
+	{
+		return TRX_RADIO_STATUS_PERIOD_ECO;
+	}
+
+	return RSSI_NOISE_SAMPLE_PERIOD_PIT;
+}
+
+// Scheduled pass, called from the main loop
+void trxRadioStatusSamplerTick(void)
 {
-	radioReadVoxAndMicStrength();
+	if ((currentMode == RADIO_MODE_NONE) || uiVFOModeSweepScanning(false)) // The sweep scan samples on its own
+	{
+		return;
+	}
+
+	if (ticksTimerHasExpired(&trxNextRssiNoiseSampleTimer))
+	{
+		trxRadioStatusSample(trxRadioStatusGetNeededFields());
+		ticksTimerStart(&trxNextRssiNoiseSampleTimer, trxRadioStatusGetSamplingPeriod());
+	}
 }
 
-// Need to postone the next AT1846ReadRSSIAndNoise() call (see trxReadRSSIAndNoise())
+// Need to postone the next scheduled sampler pass (see trxRadioStatusSamplerTick())
 // msOverride parameter is used if > 0
 void trxPostponeReadRSSIAndNoise(uint32_t msOverride)
 {
 	ticksTimerStart(&trxNextRssiNoiseSampleTimer, (msOverride > 0 ? msOverride : RSSI_NOISE_SAMPLE_PERIOD_PIT));
 }
 
-// Check RSSI and Noise
-void trxReadRSSIAndNoise(bool force)
+// Clear the RX values, as nothing is received while transmitting
+static void trxRadioStatusResetRx(void)
 {
-	if (rxPowerSavingIsRxOn() && (ticksTimerHasExpired(&trxNextRssiNoiseSampleTimer) || force))
-	{
-		radioReadRSSIAndNoise();
-		ticksTimerStart(&trxNextRssiNoiseSampleTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
-	}
+	taskENTER_CRITICAL();
+	trxRadioStatus_t *next = &trxRadioStatusBuffers[trxRadioStatusPublished ^ 1];
+
+	*next = trxRadioStatusBuffers[trxRadioStatusPublished];
+	next->fields = 0;
+	next->rssi = 0;
+	next->noise = 255;
+	next->timestamp = ticksGetMillis();
+	next->sequence++;
+	trxRadioStatusPublished ^= 1;
+	taskEXIT_CRITICAL();
 }
 
 bool trxCarrierDetected(void)
 {
-	uint8_t squelch = 0;
+	if (currentMode == RADIO_MODE_NONE)
+	{
+		return false;
+	}
 
-	trxReadRSSIAndNoise(true); // We need to get the RSSI and noise now.
+	// Only read the registers again if the snapshot is older than the fastest sampling period.
+	trxRadioStatusSampleIfOlderThan(trxRadioStatusGetNeededFields(), TRX_RADIO_STATUS_PERIOD_FAST);
 
-	switch(currentMode)
-	{
-		case RADIO_MODE_NONE:
-			return false;
-			break;
+	return (trxRadioStatusGet()->noise < trxGetSquelchLevel());
+}
 
-		case RADIO_MODE_ANALOG:
-			if (currentChannelData->sql != 0)
-			{
-				squelch = TRX_SQUELCH_MAX - (((currentChannelData->sql - 1) * 11) >> 2);
-			}
-			else
-			{
-				squelch = TRX_SQUELCH_MAX - (((nonVolatileSettings.squelchDefaults[trxCurrentBand[TRX_RX_FREQ_BAND]]) * 11) >> 2);
-			}
-			break;
+// The squelch is only evaluated when the sampler published new RSSI and noise values
+static bool trxSquelchHasNewSample(void)
+{
+	const trxRadioStatus_t *status = trxRadioStatusGet();
 
-		case RADIO_MODE_DIGITAL:
-			squelch = TRX_SQUELCH_MAX - (((nonVolatileSettings.squelchDefaults[trxCurrentBand[TRX_RX_FREQ_BAND]]) * 11) >> 2);
-			break;
+	if ((status->sequence != trxSquelchLastSequence) && (status->fields & TRX_RADIO_STATUS_RSSI_NOISE))
+	{
+		trxSquelchLastSequence = status->sequence;
+		return true;
 	}
 
-	return (trxRxNoise < squelch);
+	return false;
 }
 
 bool trxCheckDigitalSquelch(void)
 {
-	if (ticksTimerHasExpired(&trxNextSquelchCheckingTimer))
+	if (trxSquelchHasNewSample())
 	{
 		if (currentMode != RADIO_MODE_NONE)
 		{
-			uint8_t squelch;
-
-			squelch = TRX_SQUELCH_MAX - (((nonVolatileSettings.squelchDefaults[trxCurrentBand[TRX_RX_FREQ_BAND]]) * 11) >> 2);
-
-			if (trxRxNoise < squelch)
+			if (squelchUpdate(&trxSquelch, trxRadioStatusGet()->noise, trxGetSquelchLevel()))
 			{
 				if ((uiDataGlobal.rxBeepState & RX_BEEP_CARRIER_HAS_STARTED) == 0)
 				{
@@ -506,7 +689,6 @@ bool trxCheckDigitalSquelch(void)
 			}
 		}
 
-		ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 	}
 	return digitalSignalReceived;
 }
@@ -518,6 +700,7 @@ void trxTerminateCheckAnalogSquelch(void)
 	analogTriggeredAudio = false;
 	trxCssMeasureCount = 0;
 	//rxCSSTriggerCount = 0;
+	squelchInit(&trxSquelch);
 }
 
 bool trxCheckAnalogSquelch(void)
@@ -527,21 +710,9 @@ bool trxCheckAnalogSquelch(void)
 		return false;
 	}
 
-	if (ticksTimerHasExpired(&trxNextSquelchCheckingTimer))
+	if (trxSquelchHasNewSample())
 	{
-		uint8_t squelch;
-
-		// check for variable squelch control
-		if (currentChannelData->sql != 0)
-		{
-			squelch = TRX_SQUELCH_MAX - (((currentChannelData->sql - 1) * 11) >> 2);
-		}
-		else
-		{
-			squelch = TRX_SQUELCH_MAX - (((nonVolatileSettings.squelchDefaults[trxCurrentBand[TRX_RX_FREQ_BAND]]) * 11) >> 2);
-		}
-
-		if (trxRxNoise < squelch)
+		if (squelchUpdate(&trxSquelch, trxRadioStatusGet()->noise, trxGetSquelchLevel()))
 		{
 			if(analogSignalReceived == false)
 			{
@@ -635,13 +806,17 @@ bool trxCheckAnalogSquelch(void)
 			{
 				if (rxCSSactive && (cssFlag == false)) // CSS disappeared.
 				{
+					if (trxCssMeasureCount == 0)
+					{
+						ticksTimerStart(&trxCssHoldTimer, CTCSS_HOLD_DELAY_MS);
+					}
 					trxCssMeasureCount++;
 					// If using CTCSS or DCS and signal isn't lost, allow some loss of tone / code.
 					// Note:
 					//    It's not unusual to have the CSS detection failing (CTCSS, depending of the sub-tone) if
 					//    the signal is over-modulated/deviated, so waiting for 150ms is fine, and almost needed.
 					//    Waiting for shorter time will just constantly disable and enable the audio Amp.
-					if (trxCssMeasureCount >= CTCSS_HOLD_DELAY)
+					if (ticksTimerHasExpired(&trxCssHoldTimer))
 					{
 						disableAudioAmp(AUDIO_AMP_MODE_RF);
 						analogSignalReceived = false;
@@ -674,7 +849,6 @@ bool trxCheckAnalogSquelch(void)
 			}
 		}
 
-		ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 	}
 
 	return analogSignalReceived;
@@ -684,6 +858,7 @@ void trxResetSquelchesState(void)
 {
 	digitalSignalReceived = false;
 	analogSignalReceived = false;
+	squelchInit(&trxSquelch);
 }
 
 void trxSetFrequency(int fRx, int fTx, int dmrMode)
@@ -699,6 +874,14 @@ void trxSetFrequency(int fRx, int fTx, int dmrMode)
 
 	if ((currentRxFrequency != fRx) || (currentTxFrequency != fTx))
 	{
+#if defined(TRX_RETUNE_TIMING)
+		uint32_t startCycles;
+
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+		startCycles = DWT->CYCCNT;
+#endif
+
 		if (rxPowerSavingIsRxOn() == false)
 		{
 			rxPowerSavingSetState(ECOPHASE_POWERSAVE_INACTIVE);
@@ -732,13 +915,14 @@ void trxSetFrequency(int fRx, int fTx, int dmrMode)
 			trxDMRModeRx = dmrMode;
 		}
 
-		uint32_t f = currentRxFrequency * 0.16f;
+		// Native values are in 1/16 kHz steps (* 0.16), computed with integers to avoid float conversions and rounding
+		uint32_t f = (currentRxFrequency * 4) / 25;
 		rx_fl_l = (f & 0x000000ff) >> 0;
 		rx_fl_h = (f & 0x0000ff00) >> 8;
 		rx_fh_l = (f & 0x00ff0000) >> 16;
 		rx_fh_h = (f & 0xff000000) >> 24;
 
-		f = currentTxFrequency * 0.16f;
+		f = (currentTxFrequency * 4) / 25;
 		tx_fl_l = (f & 0x000000ff) >> 0;
 		tx_fl_h = (f & 0x0000ff00) >> 8;
 		tx_fh_l = (f & 0x00ff0000) >> 16;
@@ -763,7 +947,7 @@ void trxSetFrequency(int fRx, int fTx, int dmrMode)
 
 		radioWriteReg2byte( 0x29, rx_fh_h, rx_fh_l);
 		radioWriteReg2byte( 0x2a, rx_fl_h, rx_fl_l);
-		radioWriteReg2byte( 0x49, 0x0C, 0x15); // setting SQ open and shut threshold
+		// SQ open and shut threshold (0x49) is set from the tuning profile by trxUpdateAT1846SCalibration()
 
 		if (currentBandWidthIs25kHz)
 		{
@@ -799,11 +983,27 @@ void trxSetFrequency(int fRx, int fTx, int dmrMode)
 		}
 
 		ticksTimerStart(&trxNextRssiNoiseSampleTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
-		ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 		taskEXIT_CRITICAL();
+
+#if defined(TRX_RETUNE_TIMING)
+		trxRetuneLastCycles = DWT->CYCCNT - startCycles;
+		if (trxRetuneLastCycles > trxRetuneMaxCycles)
+		{
+			trxRetuneMaxCycles = trxRetuneLastCycles;
+		}
+#endif
 	}
 }
 
+#if defined(TRX_RETUNE_TIMING)
+// Time spent in the last and the slowest trxSetFrequency() retunes (scan hops and dual watch switches), in CPU cycles
+void trxGetRetuneTiming(uint32_t *lastCycles, uint32_t *maxCycles)
+{
+	*lastCycles = trxRetuneLastCycles;
+	*maxCycles = trxRetuneMaxCycles;
+}
+#endif
+
 int trxGetFrequency(void)
 {
 	if (trxTransmissionEnabled)
@@ -878,7 +1078,6 @@ void trxRxAndTxOff(bool critical)
 void trxRxOn(bool critical)
 {
 	ticksTimerStart(&trxNextRssiNoiseSampleTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
-	ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 
 	if (critical)
 	{
@@ -938,7 +1137,6 @@ void trxActivateRx(bool critical)
 	trxRxOn(critical);
 
 	ticksTimerStart(&trxNextRssiNoiseSampleTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
-	ticksTimerStart(&trxNextSquelchCheckingTimer, RSSI_NOISE_SAMPLE_PERIOD_PIT);
 }
 
 void trxActivateTx(bool critical)
@@ -949,8 +1147,7 @@ void trxActivateTx(bool critical)
 	}
 
 	txPAEnabled = true;
-	trxRxSignal = 0;
-	trxRxNoise = 255;
+	trxRadioStatusResetRx();
 
 	GPIO_PinWrite(GPIO_VHF_RX_amp_power, Pin_VHF_RX_amp_power, 0);// VHF pre-amp off
 	GPIO_PinWrite(GPIO_UHF_RX_amp_power, Pin_UHF_RX_amp_power, 0);// UHF pre-amp on
@@ -1125,134 +1322,198 @@ void trxCalcBandAndFrequencyOffset(CalibrationBand_t *calibrationBand, uint32_t
 	}
 }
 
-static void trxUpdateC6000Calibration(void)
+static trxTuningProfile_t *trxGetTuningProfile(void)
 {
 	uint32_t freq_offset;
 	CalibrationBand_t calBand;
 	CalibrationDataResult_t calRes;
+	trxTuningProfile_t *profile;
 
 	trxCalcBandAndFrequencyOffset(&calBand, &freq_offset);
 
-	SPI0WritePageRegByte(0x04, 0x00, 0x3F); // Reset HR-C6000 state
+	for (int i = 0; i < TRX_TUNING_PROFILES_CACHE_SIZE; i++)
+	{
+		profile = &trxTuningProfiles[i];
+
+		if (profile->valid && (profile->calBand == calBand) && (profile->freqOffset == freq_offset) &&
+				(profile->mode == currentMode) && (profile->bandwidthIs25kHz == currentBandWidthIs25kHz))
+		{
+			return profile;
+		}
+	}
+
+	// Not cached, compute the registers values from the calibration data, in place of the oldest profile
+	profile = &trxTuningProfiles[trxTuningProfilesNextSlot];
+	trxTuningProfilesNextSlot = (trxTuningProfilesNextSlot + 1) % TRX_TUNING_PROFILES_CACHE_SIZE;
+
+	profile->calBand = calBand;
+	profile->freqOffset = freq_offset;
+	profile->mode = currentMode;
+	profile->bandwidthIs25kHz = currentBandWidthIs25kHz;
+
+	// HR-C6000
 #if false
 	calibrationGetSectionData(calBand, CalibrationSection_DACDATA_SHIFT, &calRes);
-	SPI0WritePageRegByte(0x04, 0x37, calRes.value); // DACDATA shift (LIN_VOL)
+	profile->dacDataShift = calRes.value;
 #endif
 
 	calibrationGetSectionData(calBand, CalibrationSection_Q_MOD2_OFFSET, &calRes);
-	SPI0WritePageRegByte(0x04, 0x04, calRes.value); // MOD2 offset
+	profile->mod2Offset = calRes.value;
 
 	calRes.offset = freq_offset;
 	calibrationGetSectionData(calBand, CalibrationSection_PHASE_REDUCE, &calRes);
-	SPI0WritePageRegByte(0x04, 0x46, calRes.value); // phase reduce
+	profile->phaseReduce = calRes.value;
 
 	calibrationGetSectionData(calBand, CalibrationSection_TWOPOINT_MOD, &calRes);
-	uint16_t refOscOffset = calRes.value; //(highByte<<8)+lowByte;
+	profile->twoPointMod = calRes.value; //(highByte<<8)+lowByte;
 
-	if (refOscOffset > 1023)
+	if (profile->twoPointMod > 1023)
 	{
-		refOscOffset = 1023;
+		profile->twoPointMod = 1023;
 	}
-	SPI0WritePageRegByte(0x04, 0x48, (refOscOffset >> 8) & 0x03); // bit 0 to 1 = upper 2 bits of 10-bit twopoint mod
-	SPI0WritePageRegByte(0x04, 0x47, (refOscOffset & 0xFF)); // bit 0 to 7 = lower 8 bits of 10-bit twopoint mod
-}
-
-void I2C_AT1846_set_register_with_mask(uint8_t reg, uint16_t mask, uint16_t value, uint8_t shift)
-{
-	taskENTER_CRITICAL();
-	radioSetClearReg2byteWithMask(reg, (mask & 0xff00) >> 8, (mask & 0x00ff) >> 0, ((value << shift) & 0xff00) >> 8, ((value << shift) & 0x00ff) >> 0);
-	taskEXIT_CRITICAL();
-}
-
-static void trxUpdateAT1846SCalibration(void)
-{
-	uint32_t freq_offset = 0x00000000;
-	CalibrationBand_t calBand;
-	CalibrationDataResult_t calRes;
-
-	trxCalcBandAndFrequencyOffset(&calBand, &freq_offset);
-
-	uint8_t val_pga_gain;
-	uint8_t gain_tx;
-
-
-	uint16_t xmitter_dev;
-
-	uint8_t dac_vgain_analog;
-	uint8_t volume_analog;
-
-	uint16_t noise1_th;
-	uint16_t noise2_th;
-	uint16_t rssi3_th;
-
-	uint16_t squelch_th;
 
+	// AT1846S
 	calibrationGetSectionData(calBand, CalibrationSection_PGA_GAIN, &calRes);
-	val_pga_gain = calRes.value;
+	profile->pgaGain = calRes.value;
 
 	calibrationGetSectionData(calBand, CalibrationSection_VOICE_GAIN_TX, &calRes);
-	voice_gain_tx = calRes.value;
+	profile->voiceGainTx = calRes.value;
 
 	calibrationGetSectionData(calBand, CalibrationSection_GAIN_TX, &calRes);
-	gain_tx = calRes.value;
+	profile->gainTx = calRes.value;
 
 	calibrationGetSectionData(calBand, CalibrationSection_PADRV_IBIT, &calRes);
-	padrv_ibit = calRes.value;
-
+	profile->padrvIbit = calRes.value;
 
 	// 25 or 12.5 kHz settings
 	calibrationGetSectionData(calBand,
 			(currentBandWidthIs25kHz ? CalibrationSection_XMITTER_DEV_WIDEBAND : CalibrationSection_XMITTER_DEV_NARROWBAND), &calRes);
-	xmitter_dev = calRes.value;
+	profile->xmitterDev = calRes.value;
 
 	if (currentMode == RADIO_MODE_ANALOG)
 	{
 		calibrationGetSectionData(calBand, CalibrationSection_DAC_VGAIN_ANALOG, &calRes);
-		dac_vgain_analog = calRes.value;
+		profile->dacVGainAnalog = calRes.value;
 
 		calibrationGetSectionData(calBand, CalibrationSection_VOLUME_ANALOG, &calRes);
-		volume_analog = calRes.value;
+		profile->volumeAnalog = calRes.value;
 	}
 	else
 	{
-		dac_vgain_analog = 0x0C;
-		volume_analog = 0x0C;
+		profile->dacVGainAnalog = 0x0C;
+		profile->volumeAnalog = 0x0C;
 	}
 
 	calibrationGetSectionData(calBand,
 			(currentBandWidthIs25kHz ? CalibrationSection_NOISE1_TH_WIDEBAND : CalibrationSection_NOISE1_TH_NARROWBAND), &calRes);
-	noise1_th = calRes.value;
+	profile->noise1Th = calRes.value;
 
 	calibrationGetSectionData(calBand,
 			(currentBandWidthIs25kHz ? CalibrationSection_NOISE2_TH_WIDEBAND : CalibrationSection_NOISE2_TH_NARROWBAND), &calRes);
-	noise2_th = calRes.value;
+	profile->noise2Th = calRes.value;
 
 	calibrationGetSectionData(calBand,
 			(currentBandWidthIs25kHz ? CalibrationSection_RSSI3_TH_WIDEBAND : CalibrationSection_RSSI3_TH_NARROWBAND), &calRes);
-	rssi3_th = calRes.value;
+	profile->rssi3Th = calRes.value;
 
 	calRes.mod = (currentBandWidthIs25kHz ? 0 : 3);
 	calibrationGetSectionData(calBand, CalibrationSection_SQUELCH_TH, &calRes);
-	squelch_th = calRes.value;
+	profile->squelchTh = calRes.value;
 
-	I2C_AT1846_set_register_with_mask(0x0A, 0xF83F, val_pga_gain, 6);
-	I2C_AT1846_set_register_with_mask(0x41, 0xFF80, voice_gain_tx, 0);
-	I2C_AT1846_set_register_with_mask(0x44, 0xF0FF, gain_tx, 8);
+	profile->valid = true;
 
-	I2C_AT1846_set_register_with_mask(0x59, 0x003f, xmitter_dev, 6);
-	I2C_AT1846_set_register_with_mask(0x44, 0xFF0F, dac_vgain_analog, 4);
-	I2C_AT1846_set_register_with_mask(0x44, 0xFFF0, volume_analog, 0);
+	return profile;
+}
 
-	I2C_AT1846_set_register_with_mask(0x48, 0x0000, noise1_th, 0);
-	I2C_AT1846_set_register_with_mask(0x60, 0x0000, noise2_th, 0);
-	I2C_AT1846_set_register_with_mask(0x3f, 0x0000, rssi3_th, 0);
+// Needs to be called when the AT1846S registers handled by the tuning profiles are written by something else
+static void trxTuningImageInvalidate(void)
+{
+	trxAT1846SImage.valid = false;
+}
+
+static void trxUpdateC6000Calibration(void)
+{
+	trxTuningProfile_t *profile = trxGetTuningProfile();
+
+	SPI0WritePageRegByte(0x04, 0x00, 0x3F); // Reset HR-C6000 state
+#if false
+	SPI0WritePageRegByte(0x04, 0x37, profile->dacDataShift); // DACDATA shift (LIN_VOL)
+#endif
+	SPI0WritePageRegByte(0x04, 0x04, profile->mod2Offset); // MOD2 offset
+	SPI0WritePageRegByte(0x04, 0x46, profile->phaseReduce); // phase reduce
+	SPI0WritePageRegByte(0x04, 0x48, (profile->twoPointMod >> 8) & 0x03); // bit 0 to 1 = upper 2 bits of 10-bit twopoint mod
+	SPI0WritePageRegByte(0x04, 0x47, (profile->twoPointMod & 0xFF)); // bit 0 to 7 = lower 8 bits of 10-bit twopoint mod
+}
+
+void I2C_AT1846_set_register_with_mask(uint8_t reg, uint16_t mask, uint16_t value, uint8_t shift)
+{
+	taskENTER_CRITICAL();
+	radioSetClearReg2byteWithMask(reg, (mask & 0xff00) >> 8, (mask & 0x00ff) >> 0, ((value << shift) & 0xff00) >> 8, ((value << shift) & 0x00ff) >> 0);
+	taskEXIT_CRITICAL();
+}
+
+// Only writes the AT1846S registers which differ from the ones already set (the image), as each masked write is a read and a write on the I2C bus
+static void trxUpdateAT1846SCalibration(void)
+{
+	trxTuningProfile_t *profile = trxGetTuningProfile();
+	bool writeAll = (trxAT1846SImage.valid == false);
+
+	voice_gain_tx = profile->voiceGainTx;
+	padrv_ibit = profile->padrvIbit;
+
+	if (writeAll || (trxAT1846SImage.pgaGain != profile->pgaGain))
+	{
+		I2C_AT1846_set_register_with_mask(0x0A, 0xF83F, profile->pgaGain, 6);
+	}
+	if (writeAll || (trxAT1846SImage.voiceGainTx != profile->voiceGainTx))
+	{
+		I2C_AT1846_set_register_with_mask(0x41, 0xFF80, profile->voiceGainTx, 0);
+	}
+	if (writeAll || (trxAT1846SImage.gainTx != profile->gainTx))
+	{
+		I2C_AT1846_set_register_with_mask(0x44, 0xF0FF, profile->gainTx, 8);
+	}
 
+	if (writeAll || (trxAT1846SImage.xmitterDev != profile->xmitterDev))
+	{
+		I2C_AT1846_set_register_with_mask(0x59, 0x003f, profile->xmitterDev, 6);
+	}
+	if (writeAll || (trxAT1846SImage.dacVGainAnalog != profile->dacVGainAnalog))
+	{
+		I2C_AT1846_set_register_with_mask(0x44, 0xFF0F, profile->dacVGainAnalog, 4);
+	}
+	if (writeAll || (trxAT1846SImage.volumeAnalog != profile->volumeAnalog))
+	{
+		I2C_AT1846_set_register_with_mask(0x44, 0xFFF0, profile->volumeAnalog, 0);
+	}
+
+	if (writeAll || (trxAT1846SImage.noise1Th != profile->noise1Th))
+	{
+		I2C_AT1846_set_register_with_mask(0x48, 0x0000, profile->noise1Th, 0);
+	}
+	if (writeAll || (trxAT1846SImage.noise2Th != profile->noise2Th))
+	{
+		I2C_AT1846_set_register_with_mask(0x60, 0x0000, profile->noise2Th, 0);
+	}
+	if (writeAll || (trxAT1846SImage.rssi3Th != profile->rssi3Th))
+	{
+		I2C_AT1846_set_register_with_mask(0x3f, 0x0000, profile->rssi3Th, 0);
+	}
+
+	if (writeAll || (trxAT1846SImage.padrvIbit != profile->padrvIbit))
+	{
 #ifndef NEW_PA_CONTROL
-	I2C_AT1846_set_register_with_mask(0x0A, 0x87FF, padrv_ibit, 11);// This is now done during trxActiveTx
+		I2C_AT1846_set_register_with_mask(0x0A, 0x87FF, profile->padrvIbit, 11);// This is now done during trxActiveTx
 #else
-	I2C_AT1846_set_register_with_mask(0x0A, 0x87FF, 0, 11); // set power to zero
+		I2C_AT1846_set_register_with_mask(0x0A, 0x87FF, 0, 11); // set power to zero
 #endif
-	I2C_AT1846_set_register_with_mask(0x49, 0x0000, squelch_th, 0);
+	}
+	if (writeAll || (trxAT1846SImage.squelchTh != profile->squelchTh))
+	{
+		I2C_AT1846_set_register_with_mask(0x49, 0x0000, profile->squelchTh, 0);
+	}
+
+	trxAT1846SImage = *profile;
 }
 
 void trxSetDMRColourCode(uint8_t colourCode)
@@ -1416,6 +1677,7 @@ void trxSetRxCSS(uint16_t tone)
 		disableAudioAmp(AUDIO_AMP_MODE_RF);
 		analogSignalReceived = false;
 		analogTriggeredAudio = false;
+		squelchInit(&trxSquelch);
 	}
 	else if (type & CSS_TYPE_DCS)
 	{
@@ -1441,23 +1703,18 @@ void trxSetRxCSS(uint16_t tone)
 		disableAudioAmp(AUDIO_AMP_MODE_RF);
 		analogSignalReceived = false;
 		analogTriggeredAudio = false;
+		squelchInit(&trxSquelch);
 	}
 	taskEXIT_CRITICAL();
 }
 
+// The CSS flags are read by the radio status sampler, in the same pass as the RSSI and noise.
 bool trxCheckCSSFlag(uint16_t tone)
 {
-	uint8_t FlagsH;
-	uint8_t FlagsL;
-	status_t retval;
-
-	taskENTER_CRITICAL();
-	retval = radioReadReg2byte(0x1c, &FlagsH, &FlagsL);
-	taskEXIT_CRITICAL();
-
+	const trxRadioStatus_t *status = trxRadioStatusGet();
 	CodeplugCSSTypes_t type = codeplugGetCSSType(tone);
 
-	return ((retval == kStatus_Success) && ((type != CSS_TYPE_NONE) && ((FlagsL & 0x05) == 0x05)));
+	return (((status->fields & TRX_RADIO_STATUS_CSS_FLAGS) != 0) && ((type != CSS_TYPE_NONE) && ((status->cssFlagsL & 0x05) == 0x05)));
 }
 
 void trxUpdateDeviation(int channel)
@@ -1467,6 +1724,7 @@ void trxUpdateDeviation(int channel)
 	uint8_t deviation;
 
 	taskENTER_CRITICAL();
+	trxTuningImageInvalidate();// 0x41 is overwritten
 	switch (channel)
 	{
 		case AT1846_VOICE_CHANNEL_TONE1:
@@ -1497,6 +1755,7 @@ void trxSelectVoiceChannel(uint8_t channel) {
 	uint8_t vall;
 
 	taskENTER_CRITICAL();
+	trxTuningImageInvalidate();// 0x41 and 0x59 are overwritten
 	switch (channel)
 	{
 		case AT1846_VOICE_CHANNEL_TONE1:
@@ -1613,6 +1872,7 @@ void trxSetMicGainFM(uint8_t gain)
 		gain_tx += (gain - 16); // Seems to be enough
 	}
 
+	trxTuningImageInvalidate();// 0x0A and 0x41 are overwritten
 	I2C_AT1846_set_register_with_mask(0x0A, 0xF83F, gain, 6);
 	I2C_AT1846_set_register_with_mask(0x41, 0xFF80, gain_tx, 0);
 }
@@ -1763,13 +2023,13 @@ int trxGetRSSIdBm(void)
 	if (trxCurrentBand[TRX_RX_FREQ_BAND] == RADIO_BAND_UHF)
 	{
 		// Use fixed point maths to scale the RSSI value to dBm, based on data from VK4JWT and VK7ZJA
-		dBm = -151 + trxRxSignal;// Note no the RSSI value on UHF does not need to be scaled like it does on VHF
+		dBm = -151 + trxRadioStatusGet()->rssi;// Note no the RSSI value on UHF does not need to be scaled like it does on VHF
 	}
 	else
 	{
 		// VHF
 		// Use fixed point maths to scale the RSSI value to dBm, based on data from VK4JWT and VK7ZJA
-		dBm = -164 + ((trxRxSignal * 32) / 27);
+		dBm = -164 + ((trxRadioStatusGet()->rssi * 32) / 27);
 	}
 
 	return dBm;
@@ -1781,12 +2041,12 @@ int trxGetNoisedBm(void)
 
 	if (trxCurrentBand[TRX_RX_FREQ_BAND] == RADIO_BAND_UHF)
 	{
-		dBm = -151 + trxRxNoise;// Note no the RSSI value on UHF does not need to be scaled like it does on VHF
+		dBm = -151 + trxRadioStatusGet()->noise;// Note no the RSSI value on UHF does not need to be scaled like it does on VHF
 	}
 	else
 	{
 		// VHF
-		dBm = -164 + ((trxRxNoise * 32) / 27);
+		dBm = -164 + ((trxRadioStatusGet()->noise * 32) / 27);
 	}
 
 	return dBm;
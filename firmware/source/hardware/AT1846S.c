@@ -29,7 +29,6 @@
 #include "hardware/AT1846S.h"
 #include "functions/settings.h"
 #include "functions/trx.h"
-#include "functions/rxPowerSaving.h"
 #if defined(USING_EXTERNAL_DEBUGGER)
 #include "SeggerRTT/RTT/SEGGER_RTT.h"
 #endif
@@ -254,37 +253,6 @@ void radioSetMode(void) // Called withing trx.c: in task critical sections
 	}
 }
 
-void radioReadVoxAndMicStrength(void)
-{
-	uint8_t val1, val2;
-
-	taskENTER_CRITICAL();
-	if (radioReadReg2byte(0x1a, &val1, &val2) == kStatus_Success)
-	{
-		trxTxVox = val1;
-		trxTxMic = val2;
-	}
-	taskEXIT_CRITICAL();
-}
-
-void radioReadRSSIAndNoise(void)
-{
-	uint8_t val1, val2;
-
-	if (rxPowerSavingIsRxOn())
-	{
-
-		taskENTER_CRITICAL();
-		if (radioReadReg2byte(0x1b, &val1, &val2) == kStatus_Success)
-		{
-			trxRxSignal = val1;
-			trxRxNoise = val2;
-		}
-		trxDMRSynchronisedRSSIReadPending = false;
-		taskEXIT_CRITICAL();
-	}
-}
-
 int radioSetClearReg2byteWithMask(uint8_t reg, uint8_t mask1, uint8_t mask2, uint8_t val1, uint8_t val2)
 {
     status_t status;
@@ -40,6 +40,7 @@
 #include "interfaces/interrupts.h"
 #include "functions/rxPowerSaving.h"
 #include "functions/ticks.h"
+#include "interfaces/clockManager.h"
 
 
 #define QSODATA_TIMER_TIMEOUT            2400
@@ -62,7 +63,6 @@
 
 #define NUM_AMBE_BLOCK_PER_DMR_FRAME        3
 #define NUM_AMBE_BUFFERS                    4
-#define LENGTH_AMBE_BLOCK                   9
 
 #define START_TICK_TIMEOUT                 20
 #define END_TICK_TIMEOUT                   13
@@ -85,7 +85,7 @@
 
 Task_t hrc6000Task;
 
-static const uint8_t SILENCE_AUDIO[AMBE_AUDIO_LENGTH] = {
+const uint8_t SILENCE_AUDIO[AMBE_AUDIO_LENGTH] = {
 		0xB9U, 0xE8U, 0x81U, 0x52U, 0x61U, 0x73U, 0x00U, 0x2AU, 0x6BU, 0xB9U, 0xE8U, 0x81U, 0x52U,
 		0x61U, 0x73U, 0x00U, 0x2AU, 0x6BU, 0xB9U, 0xE8U, 0x81U, 0x52U, 0x61U, 0x73U, 0x00U, 0x2AU, 0x6BU
 };
@@ -545,6 +545,16 @@ bool HRC6000CheckTalkGroupFilter(void)
 			break;
 
 		case DMR_DESTINATION_FILTER_RXG:
+			{
+				bool isMember;
+
+				// Membership from the RX groups cache, when it knows the loaded group
+				if ((lastLoadedRxGroup != -1) && codeplugRxGroupContainsTG(lastLoadedRxGroup, hrc.receivedTgOrPcId, &isMember))
+				{
+					return isMember;
+				}
+			}
+
 			for(int i = 0; i < currentRxGroupData.NOT_IN_CODEPLUG_numTGsInGroup; i++)
 			{
 				if (currentRxGroupData.NOT_IN_CODEPLUG_contactsTG[i] == hrc.receivedTgOrPcId)
@@ -1729,12 +1739,12 @@ static inline void hrc6000TimeslotInterruptHandler(void)
 
 					if (hrc.hotspotDMRTxFrameBufferEmpty == false)
 					{
-						SPI1WritePageRegByteArray(0x03, 0x00, (uint8_t*)(deferredUpdateBuffer + LC_DATA_LENGTH), AMBE_AUDIO_LENGTH); // send the audio bytes to the hardware
+						SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, (uint8_t*)(deferredUpdateBuffer + LC_DATA_LENGTH), AMBE_AUDIO_LENGTH, NULL, NULL); // send the audio bytes to the hardware
 						hrc.hotspotDMRTxFrameBufferEmpty = true; // we have finished with the current frame data from the hotspot
 					}
 					else
 					{
-						SPI1WritePageRegByteArray(0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH); // send the audio bytes to the hardware
+						SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH, NULL, NULL); // send the audio bytes to the hardware
 					}
 
 					if (hrc.hotspotPostponedFrameHandling > 0) // Send frames of silence until it's equal to zero
@@ -1751,7 +1761,7 @@ static inline void hrc6000TimeslotInterruptHandler(void)
 
 					if (hrc.ambeBufferCount >= NUM_AMBE_BLOCK_PER_DMR_FRAME)
 					{
-						SPI1WritePageRegByteArray(0x03, 0x00, (uint8_t*)hrc.deferredUpdateBufferOutPtr, AMBE_AUDIO_LENGTH);// send the audio bytes to the hardware
+						SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, (uint8_t*)hrc.deferredUpdateBufferOutPtr, AMBE_AUDIO_LENGTH, NULL, NULL);// send the audio bytes to the hardware
 						hrc.deferredUpdateBufferOutPtr += AMBE_AUDIO_LENGTH;
 
 						if (hrc.deferredUpdateBufferOutPtr > DEFERRED_UPDATE_BUFFER_END)
@@ -1762,13 +1772,13 @@ static inline void hrc6000TimeslotInterruptHandler(void)
 					}
 					else
 					{
-						SPI1WritePageRegByteArray(0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH); // send the audio bytes to the hardware
+						SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH, NULL, NULL); // send the audio bytes to the hardware
 					}
 				}
 			}
 			else
 			{
-				SPI1WritePageRegByteArray(0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH); // send the audio bytes to the hardware
+				SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH, NULL, NULL); // send the audio bytes to the hardware
 			}
 
 			//write_SPI_page_reg_bytearray_SPI1(0x03, 0x00, (uint8_t*)(DMR_frame_buffer + LC_DATA_LENGTH), AMBE_AUDIO_LENGTH);// send the audio bytes to the hardware
@@ -1785,7 +1795,7 @@ static inline void hrc6000TimeslotInterruptHandler(void)
 			{
 				hrc6000SendPcOrTgLCHeader();
 			}
-			SPI1WritePageRegByteArray(0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH); // send silence audio bytes
+			SPIWritePageRegByteArrayAsync(SPI_BUS_1, 0x03, 0x00, SILENCE_AUDIO, AMBE_AUDIO_LENGTH, NULL, NULL); // send silence audio bytes
 			SPI0WritePageRegByte(0x04, 0x41, 0x80);                   // Transmit during Next Timeslot
 			SPI0WritePageRegByte(0x04, 0x50, 0x20);                   // Data Type =0010 (Terminator with LC), Data, LCSS=0
 			slotState = DMR_STATE_TX_END_2;
@@ -2330,21 +2340,24 @@ static void hrc6000Tick(void)
 			}
 			else
 			{
-				// Once there are 2 buffers available they can be encoded into one AMBE block
-				// The will happen  prior to the data being needed in the TS ISR, so that by the time tick_codec_encode encodes complete,
-				// the data is ready to be used in the TS ISR
-				if (wavbuffer_count >= 2)
+				// The codec task encodes the audio into DMR frames (3 AMBE blocks) as soon as the wave buffers are available.
+				// The frames are moved here prior to the data being needed in the TS ISR.
+				while ((hrc.ambeBufferCount <= ((NUM_AMBE_BUFFERS - 1) * NUM_AMBE_BLOCK_PER_DMR_FRAME)) &&
+						codecEncodedFrameGet((uint8_t *)hrc.deferredUpdateBufferInPtr))
 				{
-					codecEncodeBlock((uint8_t *)hrc.deferredUpdateBufferInPtr);
-
-					hrc.deferredUpdateBufferInPtr += LENGTH_AMBE_BLOCK;
+					hrc.deferredUpdateBufferInPtr += AMBE_AUDIO_LENGTH;
 
 					if (hrc.deferredUpdateBufferInPtr > DEFERRED_UPDATE_BUFFER_END)
 					{
 						hrc.deferredUpdateBufferInPtr = deferredUpdateBuffer;
 					}
-					hrc.ambeBufferCount++;
+
+					taskENTER_CRITICAL();
+					hrc.ambeBufferCount += NUM_AMBE_BLOCK_PER_DMR_FRAME;
+					taskEXIT_CRITICAL();
 				}
+
+				codecEncodeRequest();
 			}
 		}
 	}
@@ -2414,7 +2427,8 @@ static void hrc6000Tick(void)
 				// voice prompts take priority over incoming DMR audio
 				if ((voicePromptsIsPlaying() == false) && (soundMelodyIsPlaying() == false))
 				{
-					if ((WAV_BUFFER_COUNT - wavbuffer_count) < 3) // If we're running low on audio decoding storage
+					// If we're running low on audio decoding storage, including the frames still waiting to be decoded
+					if ((WAV_BUFFER_COUNT - wavbuffer_count - (codecDecodeFramesPending() * CODEC_WAV_BUFFERS_PER_FRAME)) < 3)
 					{
 						hrc.bufferLimitReachedCount = 6; // cancels decoding of the next 6 buffers.
 					}
@@ -2425,7 +2439,7 @@ static void hrc6000Tick(void)
 					}
 					else
 					{
-						codecDecode((uint8_t *)((hrc.hasAbnormalExit || hrc.insertSilenceFrame) ? SILENCE_AUDIO : (DMR_frame_buffer + LC_DATA_LENGTH)), 3);
+						codecDecodeFramePut((uint8_t *)((hrc.hasAbnormalExit || hrc.insertSilenceFrame) ? SILENCE_AUDIO : (DMR_frame_buffer + LC_DATA_LENGTH)));
 					}
 				}
 
@@ -2512,10 +2526,12 @@ static void hrc6000TaskFunction(void *data)
 {
 	while (1U)
 	{
-		hrc6000Task.AliveCount = TASK_FLAGGED_ALIVE;
+		watchdogTaskAlive(&hrc6000Task);
 
 		if (timer_hrc6000task == 0)
 		{
+			clockManagerGovernorBusyBegin();
+
 			// Update our atomic transmission state
 			hrc.transmissionEnabled = trxTransmissionEnabled;
 
@@ -2526,6 +2542,8 @@ static void hrc6000TaskFunction(void *data)
 			}
 
 			timer_hrc6000task = 1; // Reset ISR activity marker
+
+			clockManagerGovernorBusyEnd();
 		}
 		else
 		{
@@ -2550,7 +2568,7 @@ void HRC6000InitTask(void)
 	);
 
 	hrc6000Task.Running = true;
-	hrc6000Task.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&hrc6000Task);
 }
 
 // RC. I had to use accessor functions for the isWaking flag
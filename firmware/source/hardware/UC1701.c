@@ -56,12 +56,6 @@ extern bool headerRowIsDirty;
 static __attribute__((section(".data.$RAM2"))) uint8_t screenBufData[((DISPLAY_SIZE_X * DISPLAY_SIZE_Y) >> 3)];
 uint8_t *screenBuf = screenBufData;
 
-//#define DISPLAY_CHECK_BOUNDS
-
-#ifdef DISPLAY_CHECK_BOUNDS
-static const uint8_t *screenBufEnd = screenBuf + sizeof(screenBuf);
-#endif
-
 int16_t displaySetPixel(int16_t x, int16_t y, bool color)
 {
 	int16_t i;
@@ -102,86 +96,128 @@ void displayRender(void)
 	headerRowIsDirty = false;
 }
 
-//#define DISPLAY_CHECK_BOUNDS
-#ifdef DISPLAY_CHECK_BOUNDS
-static inline bool checkWritePos(uint8_t * writePos)
+#if ! defined(PLATFORM_GD77S)
+static const uint8_t *displayGetFont(ucFont_t fontSize)
 {
-	if (writePos < screenBuf || writePos > screenBufEnd)
+	switch(fontSize)
 	{
-#if defined(USING_EXTERNAL_DEBUGGER)
-		SEGGER_RTT_printf(0,"Display buffer error\n");
+#if defined(PLATFORM_RD5R)
+		case FONT_SIZE_1:
+			return font_6x8;
+		case FONT_SIZE_1_BOLD:
+			return font_6x8_bold;
+		case FONT_SIZE_2:
+			return font_8x8;//font_8x8;
+		case FONT_SIZE_3:
+			return font_8x8;//font_8x16;
+		case FONT_SIZE_4:
+			return font_8x16;// font_16x32;
+#else
+		case FONT_SIZE_1:
+			return font_6x8;
+		case FONT_SIZE_1_BOLD:
+			return font_6x8_bold;
+		case FONT_SIZE_2:
+			return font_8x8;
+		case FONT_SIZE_3:
+			return font_8x16;
+		case FONT_SIZE_4:
+			return font_16x32;
 #endif
-		return false;
+		default:
+			break;
 	}
-	return true;
+
+	return NULL;
 }
-#endif
+
+// Write one 8 pixel high row of a glyph, which is aligned on a display row
+static inline void displayWriteGlyphRowAligned(uint8_t *writePos, const uint8_t *readPos, int16_t width, bool isInverted)
+{
+	if (isInverted)
+	{
+		while (width--)
+		{
+			*writePos++ &= ~(*readPos++);
+		}
+	}
+	else
+	{
+		while (width--)
+		{
+			*writePos++ |= *readPos++;
+		}
+	}
+}
+
+// Write one 8 pixel high row of a glyph, which straddles two display rows.
+// Each column is shifted once, its low byte goes in the upper display row, the high byte in the lower one.
+static inline void displayWriteGlyphRowShifted(uint8_t *writePos, const uint8_t *readPos, int16_t width, int16_t shiftNum, bool hasLowerRow, bool isInverted)
+{
+	uint16_t column;
+
+	if (isInverted)
+	{
+		while (width--)
+		{
+			column = (*readPos++) << shiftNum;
+			*writePos &= ~((uint8_t)column);
+			if (hasLowerRow)
+			{
+				*(writePos + DISPLAY_SIZE_X) &= ~((uint8_t)(column >> 8));
+			}
+			writePos++;
+		}
+	}
+	else
+	{
+		while (width--)
+		{
+			column = (*readPos++) << shiftNum;
+			*writePos |= (uint8_t)column;
+			if (hasLowerRow)
+			{
+				*(writePos + DISPLAY_SIZE_X) |= (uint8_t)(column >> 8);
+			}
+			writePos++;
+		}
+	}
+}
+#endif // ! PLATFORM_GD77S
 
 int displayPrintCore(int16_t x, int16_t y, const char *szMsg, ucFont_t fontSize, ucTextAlign_t alignment, bool isInverted)
 {
 #if ! defined(PLATFORM_GD77S)
 	int16_t sLen;
-	uint8_t *currentCharData;
+	const uint8_t *currentFont;
+	const uint8_t *currentCharData;
 	int16_t charWidthPixels;
-	int16_t charHeightPixels;
+	int16_t charHeightRows;
 	int16_t bytesPerChar;
 	int16_t startCode;
-	int16_t endCode;
-	uint8_t *currentFont;
+	int16_t numChars;
+	int16_t shiftNum;
+	int16_t displayRow;
 	uint8_t *writePos;
-	uint8_t *readPos;
 
-    sLen = strlen(szMsg);
+	currentFont = displayGetFont(fontSize);
+	if (currentFont == NULL)
+	{
+		return -2;// Invalid font selected
+	}
 
-    switch(fontSize)
-    {
-#if defined(PLATFORM_RD5R)
-       	case FONT_SIZE_1:
-    		currentFont = (uint8_t *) font_6x8;
-    		break;
-    	case FONT_SIZE_1_BOLD:
-			currentFont = (uint8_t *) font_6x8_bold;
-    		break;
-    	case FONT_SIZE_2:
-    		currentFont = (uint8_t *) font_8x8;//font_8x8;
-    		break;
-    	case FONT_SIZE_3:
-    		currentFont = (uint8_t *) font_8x8;//font_8x16;
-			break;
-    	case FONT_SIZE_4:
-    		currentFont = (uint8_t *) font_8x16;// font_16x32;
-			break;
-#else
-    	case FONT_SIZE_1:
-    		currentFont = (uint8_t *) font_6x8;
-    		break;
-    	case FONT_SIZE_1_BOLD:
-			currentFont = (uint8_t *) font_6x8_bold;
-    		break;
-    	case FONT_SIZE_2:
-    		currentFont = (uint8_t *) font_8x8;
-    		break;
-    	case FONT_SIZE_3:
-    		currentFont = (uint8_t *) font_8x16;
-			break;
-    	case FONT_SIZE_4:
-    		currentFont = (uint8_t *) font_16x32;
-			break;
-#endif
-    	default:
-    		return -2;// Invalid font selected
-    		break;
-    }
+	sLen = strlen(szMsg);
 
-    startCode   		= currentFont[2];  // get first defined character
-    endCode 	  		= currentFont[3];  // get last defined character
-    charWidthPixels   	= currentFont[4];  // width in pixel of one char
-    charHeightPixels  	= currentFont[5];  // page count per char
-    bytesPerChar 		= currentFont[7];  // bytes per char
+	startCode   		= currentFont[2];  // get first defined character
+	numChars 			= (currentFont[3] - startCode) + 1;  // last defined character
+	charWidthPixels   	= currentFont[4];  // width in pixel of one char
+	charHeightRows  	= currentFont[5] >> 3;  // page count per char
+	bytesPerChar 		= currentFont[7];  // bytes per char
 
-    if ((charWidthPixels*sLen) + x > DISPLAY_SIZE_X)
+	// All the fonts are fixed width, so the string width doesn't need any per character lookup
+	if ((charWidthPixels * sLen) + x > DISPLAY_SIZE_X)
 	{
-    	sLen = (DISPLAY_SIZE_X - x) / charWidthPixels;
+		sLen = (DISPLAY_SIZE_X - x) / charWidthPixels;
 	}
 
 	if (sLen < 0)
@@ -202,87 +238,51 @@ int displayPrintCore(int16_t x, int16_t y, const char *szMsg, ucFont_t fontSize,
 			break;
 	}
 
+	if ((x < 0) || (y < 0))
+	{
+		return -1;
+	}
+
+	shiftNum = (y & 0x07);
+	displayRow = (y >> 3);
+
+	// Clip the rows which are below the bottom of the screen
+	if ((displayRow + charHeightRows) > DISPLAY_NUMBER_OF_ROWS)
+	{
+		charHeightRows = DISPLAY_NUMBER_OF_ROWS - displayRow;
+	}
+
 	for (int16_t i = 0; i < sLen; i++)
 	{
-		uint32_t charOffset = (szMsg[i] - startCode);
+		uint32_t charOffset = ((uint8_t)szMsg[i] - startCode);
 
 		// End boundary checking.
-		if (charOffset > endCode)
+		if (charOffset >= numChars)
 		{
 			charOffset = ('?' - startCode); // Substitute unsupported ASCII code by a question mark
 		}
 
-		currentCharData = (uint8_t *)&currentFont[8 + (charOffset * bytesPerChar)];
+		currentCharData = &currentFont[8 + (charOffset * bytesPerChar)];
+		writePos = (screenBuf + x + (i * charWidthPixels) + (displayRow * DISPLAY_SIZE_X));
 
-		for(int16_t row = 0; row < charHeightPixels / 8 ; row++)
+		if (shiftNum == 0)
 		{
-			readPos = (currentCharData + row * charWidthPixels);
-			writePos = (screenBuf + x + (i * charWidthPixels) + ((y >> 3) + row) * DISPLAY_SIZE_X) ;
-
-			if ((y & 0x07) == 0)
+			// y position is aligned to a row, whole glyph columns are written
+			for (int16_t row = 0; row < charHeightRows; row++)
 			{
-				// y position is aligned to a row
-				for(int16_t p = 0; p < charWidthPixels; p++)
-				{
-					if (isInverted)
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ &= ~(*readPos++);
-					}
-					else
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ |= *readPos++;
-					}
-				}
+				displayWriteGlyphRowAligned(writePos, currentCharData, charWidthPixels, isInverted);
+				currentCharData += charWidthPixels;
+				writePos += DISPLAY_SIZE_X;
 			}
-			else
+		}
+		else
+		{
+			// y position is NOT aligned to a row
+			for (int16_t row = 0; row < charHeightRows; row++)
 			{
-				int16_t shiftNum = y & 0x07;
-				// y position is NOT aligned to a row
-
-				for(int16_t p = 0; p < charWidthPixels; p++)
-				{
-					if (isInverted)
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ &= ~((*readPos++) << shiftNum);
-					}
-					else
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ |= ((*readPos++) << shiftNum);
-					}
-				}
-
-				readPos = (currentCharData + row * charWidthPixels);
-				writePos = (screenBuf + x + (i * charWidthPixels) + ((y >> 3) + row + 1) * DISPLAY_SIZE_X) ;
-
-				for(int16_t p = 0; p < charWidthPixels; p++)
-				{
-					if (isInverted)
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ &= ~((*readPos++) >> (8 - shiftNum));
-					}
-					else
-					{
-#ifdef DISPLAY_CHECK_BOUNDS
-						checkWritePos(writePos);
-#endif
-						*writePos++ |= ((*readPos++) >> (8 - shiftNum));
-					}
-				}
+				displayWriteGlyphRowShifted(writePos, currentCharData, charWidthPixels, shiftNum, ((displayRow + row + 1) < DISPLAY_NUMBER_OF_ROWS), isInverted);
+				currentCharData += charWidthPixels;
+				writePos += DISPLAY_SIZE_X;
 			}
 		}
 	}
@@ -290,6 +290,49 @@ int displayPrintCore(int16_t x, int16_t y, const char *szMsg, ucFont_t fontSize,
 	return 0;
 }
 
+#if defined(DISPLAY_BENCHMARK) && ! defined(PLATFORM_GD77S)
+// Renders the text of the Channel and Last Heard screens (aligned and unaligned rows), then returns the average number of CPU cycles per screen.
+// The screen buffer is restored afterwards, nothing is sent to the display.
+uint32_t displayBenchmarkTextRendering(uint32_t iterations)
+{
+	uint8_t savedScreenBuf[((DISPLAY_SIZE_X * DISPLAY_SIZE_Y) >> 3)];
+	uint32_t startCycles;
+	uint32_t totalCycles;
+
+	memcpy(savedScreenBuf, screenBuf, sizeof(savedScreenBuf));
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	startCycles = DWT->CYCCNT;
+
+	for (uint32_t i = 0; i < iterations; i++)
+	{
+		// Channel screen
+		displayClearBuf();
+		displayPrintCore(0, 3, "DMR C1 TS2 7.8V", FONT_SIZE_1, TEXT_ALIGN_CENTER, false);
+		displayPrintCentered(16, "VK3KYY Roger", FONT_SIZE_3);
+		displayPrintCentered(32, "TG 505 Australia", FONT_SIZE_2);
+		displayPrintCentered(40, "Zone Victoria", FONT_SIZE_1);
+		displayPrintCentered(52, "Local Repeater", FONT_SIZE_3);
+
+		// Last Heard screen
+		displayClearBuf();
+		displayPrintCore(0, 3, "Last heard", FONT_SIZE_1, TEXT_ALIGN_LEFT, false);
+		for (int16_t row = 0; row < 3; row++)
+		{
+			displayPrintCore(0, 16 + (row * 16), "VK3KYY Roger", FONT_SIZE_3, TEXT_ALIGN_LEFT, false);
+			displayPrintCore(0, 12 + (row * 16), "TG 505", FONT_SIZE_1, TEXT_ALIGN_RIGHT, true);
+		}
+	}
+
+	totalCycles = DWT->CYCCNT - startCycles;
+
+	memcpy(screenBuf, savedScreenBuf, sizeof(savedScreenBuf));
+
+	return (totalCycles / (iterations * 2));
+}
+#endif
+
 void displayClearBuf(void)
 {
 	memset(screenBuf, 0x00, ((DISPLAY_SIZE_X * DISPLAY_SIZE_Y) >> 3));
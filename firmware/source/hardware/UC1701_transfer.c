@@ -47,6 +47,10 @@ static void UC1701_setDataMode(void);
 static bool isAwake = true;
 static bool isInverted = false;
 
+// Copy of what is currently in the LCD controller RAM. Rows which have not changed since they were last sent are not transferred again.
+static __attribute__((section(".data.$RAM2"))) uint8_t displayShadowBufData[((DISPLAY_SIZE_X * DISPLAY_SIZE_Y) >> 3)];
+static uint32_t displayRowsInvalidMask = ((1U << DISPLAY_NUMBER_OF_ROWS) - 1);// Rows whose content in the LCD controller is unknown
+
 static void UC1701_setCommandMode(void)
 {
 	GPIO_Display_RS->PCOR = 1U << Pin_Display_RS;// set the command / data pin low to signify Command mode
@@ -58,16 +62,43 @@ static void UC1701_setDataMode(void)
 }
 #endif // ! PLATFORM_GD77S
 
+// Force the rows to be sent to the LCD on the next render, even if their content has not changed.
+void displayInvalidateRows(int16_t startRow, int16_t endRow)
+{
+#if ! defined(PLATFORM_GD77S)
+	for(int16_t row = startRow; row < endRow; row++)
+	{
+		displayRowsInvalidMask |= (1U << row);
+	}
+#endif // ! PLATFORM_GD77S
+}
+
 void displayRenderRows(int16_t startRow, int16_t endRow)
 {
 #if ! defined(PLATFORM_GD77S)
 	taskENTER_CRITICAL();
 	uint8_t *rowPos = (displayGetScreenBuffer() + startRow * DISPLAY_SIZE_X);
+	uint8_t *shadowPos = (displayShadowBufData + startRow * DISPLAY_SIZE_X);
+	bool csEnabled = false;
 
-	GPIO_PinWrite(GPIO_Display_CS, Pin_Display_CS, 0);// Enable CS
-
-	for(int16_t row = startRow; row < endRow; row++)
+	for(int16_t row = startRow; row < endRow; row++, shadowPos += DISPLAY_SIZE_X)
 	{
+		// Only transfer the rows which have changed since the last time they have been sent.
+		if (((displayRowsInvalidMask & (1U << row)) == 0) && (memcmp(rowPos, shadowPos, DISPLAY_SIZE_X) == 0))
+		{
+			rowPos += DISPLAY_SIZE_X;
+			continue;
+		}
+
+		memcpy(shadowPos, rowPos, DISPLAY_SIZE_X);
+		displayRowsInvalidMask &= ~(1U << row);
+
+		if (!csEnabled)
+		{
+			GPIO_PinWrite(GPIO_Display_CS, Pin_Display_CS, 0);// Enable CS
+			csEnabled = true;
+		}
+
 		UC1701_setCommandMode();
 		UC1701_transfer(0xb0 | row); // set Y
 		UC1701_transfer(0x10 | 0); // set X (high MSB)
@@ -103,7 +134,10 @@ void displayRenderRows(int16_t startRow, int16_t endRow)
 		}
 	}
 
-	GPIO_PinWrite(GPIO_Display_CS, Pin_Display_CS, 1);// Disable CS
+	if (csEnabled)
+	{
+		GPIO_PinWrite(GPIO_Display_CS, Pin_Display_CS, 1);// Disable CS
+	}
 	taskEXIT_CRITICAL();
 #endif // ! PLATFORM_GD77S
 }
@@ -184,6 +218,7 @@ void displayBegin(bool inverted)
 	GPIO_PinWrite(GPIO_Display_CS, Pin_Display_CS, 1);// Disable CS
 	taskEXIT_CRITICAL();
 
+	displayInvalidateRows(0, DISPLAY_NUMBER_OF_ROWS);// The controller RAM content is unknown after a reset
 	displayClearBuf();
 	displayRender();
 #endif // ! PLATFORM_GD77S
@@ -233,6 +268,8 @@ void displaySetDisplayPowerMode(bool wake)
 
 		UC1701_transfer(0xAF); // White background, black pixels
 
+		displayInvalidateRows(0, DISPLAY_NUMBER_OF_ROWS);// Resend the whole screen on the next render
+
 		if (nonVolatileSettings.backlightMode == BACKLIGHT_MODE_MANUAL)
 		{
 			if (nonVolatileSettings.displayBacklightPercentageOff > 0)
@@ -27,115 +27,186 @@
  */
 
 #include "interfaces/adc.h"
+#include "interfaces/pit.h"
 #include "functions/settings.h"
+#include "fsl_edma.h"
+#include "fsl_dmamux.h"
+
+// The ADC is hardware triggered by the PIT channel 1, and uses the hardware averaging.
+// Each conversion end requests the ADC_DMA_RESULT channel, which copies the result into the sample ring, then links to
+// the ADC_DMA_CHANNEL_LIST channel, which writes the next channel to convert into ADC0 SC1A. No CPU time is used
+// to acquire the samples, and there is no ADC interrupt anymore.
+// Filtering is done in task context, by adcTick().
+#define ADC_DMA_RESULT          2
+#define ADC_DMA_CHANNEL_LIST    3
+
+#define ADC_CHANNEL_BATTERY     1
+#define ADC_CHANNEL_VOX         3
+#define ADC_CHANNEL_TEMPERATURE 26
+
+#define ADC_CHANNELS_COUNT      3
+#define ADC_SAMPLES_PER_CHANNEL 8
+#define ADC_RING_LENGTH         (ADC_CHANNELS_COUNT * ADC_SAMPLES_PER_CHANNEL)
+
+// Index, in a round, of each channel's sample
+#define ADC_ROUND_BATTERY       0
+#define ADC_ROUND_VOX           1
+#define ADC_ROUND_TEMPERATURE   2
+
+// Next channel to convert, written into SC1A after each conversion: the first conversion is the battery,
+// which was set up in adcInit(), followed by the VOX, then the temperature.
+static const uint32_t adcChannelList[ADC_CHANNELS_COUNT] = { ADC_CHANNEL_VOX, ADC_CHANNEL_TEMPERATURE, ADC_CHANNEL_BATTERY };
+static volatile uint16_t adcSampleRing[ADC_RING_LENGTH];
+
+static int adcRingReadIndex;
+static uint32_t adcVOXEnvelope; // Q4
+static int32_t adcTemperature; // Q12
+static int adcTemperatureSamples;
+
+#define ADC_VOX_ENVELOPE_FRACTION_BITS       4
+#define ADC_VOX_ENVELOPE_ATTACK_SHIFT        1
+#define ADC_VOX_ENVELOPE_RELEASE_SHIFT       4
+#define ADC_TEMPERATURE_FRACTION_BITS       12
 
-static volatile uint32_t adc_channel;
-static volatile uint32_t adcBatteryVoltage;
-static volatile uint32_t adcVOX;
-static volatile uint32_t adcTemperature;
-static volatile int averageLength = 0;
-
-const int TEMPERATURE_DECIMAL_RESOLUTION = 1000000;
 const int CUTOFF_VOLTAGE_UPPER_HYST = 64;
 const int CUTOFF_VOLTAGE_LOWER_HYST = 62;
 const int BATTERY_MAX_VOLTAGE = 82;
 
-void approxRollingAverage (unsigned int newSample);
-
-void adcTriggerConversion(int channelOverride)
+static void adcInitDMA(void)
 {
-    adc16_channel_config_t adc16ChannelConfigStruct;
-
-    if (channelOverride != NO_ADC_CHANNEL_OVERRIDE)
-    {
-    	adc_channel = channelOverride;
-    }
-    adc16ChannelConfigStruct.channelNumber = adc_channel;
-    adc16ChannelConfigStruct.enableInterruptOnConversionCompleted = true;
-    adc16ChannelConfigStruct.enableDifferentialConversion = false;
-    ADC16_SetChannelConfig(ADC0, 0, &adc16ChannelConfigStruct);
+	edma_transfer_config_t transferConfig;
+
+	// The eDMA module has already been initialised by the I2S
+	DMAMUX_SetSource(DMAMUX0, ADC_DMA_RESULT, 40); // 40..ADC0
+	DMAMUX_EnableChannel(DMAMUX0, ADC_DMA_RESULT);
+
+	// ADC0 R[0] -> sample ring, 2 bytes per request, wraps around at the end of the ring.
+	EDMA_ResetChannel(DMA0, ADC_DMA_RESULT);
+	EDMA_PrepareTransfer(&transferConfig, (void *)&ADC0->R[0], sizeof(uint16_t), (void *)adcSampleRing, sizeof(uint16_t),
+			sizeof(uint16_t), sizeof(adcSampleRing), kEDMA_PeripheralToMemory);
+	EDMA_SetTransferConfig(DMA0, ADC_DMA_RESULT, &transferConfig, NULL);
+	EDMA_SetMajorOffsetConfig(DMA0, ADC_DMA_RESULT, 0, -((int32_t)sizeof(adcSampleRing)));
+	EDMA_SetChannelLink(DMA0, ADC_DMA_RESULT, kEDMA_MinorLink, ADC_DMA_CHANNEL_LIST);
+	EDMA_SetChannelLink(DMA0, ADC_DMA_RESULT, kEDMA_MajorLink, ADC_DMA_CHANNEL_LIST);// The last minor loop only triggers the major link
+	EDMA_EnableAutoStopRequest(DMA0, ADC_DMA_RESULT, false);
+
+	// Channel list -> ADC0 SC1A, only started by the link.
+	EDMA_ResetChannel(DMA0, ADC_DMA_CHANNEL_LIST);
+	EDMA_PrepareTransfer(&transferConfig, (void *)adcChannelList, sizeof(uint32_t), (void *)&ADC0->SC1[0], sizeof(uint32_t),
+			sizeof(uint32_t), sizeof(adcChannelList), kEDMA_MemoryToPeripheral);
+	EDMA_SetTransferConfig(DMA0, ADC_DMA_CHANNEL_LIST, &transferConfig, NULL);
+	EDMA_SetMajorOffsetConfig(DMA0, ADC_DMA_CHANNEL_LIST, -((int32_t)sizeof(adcChannelList)), 0);
+	EDMA_EnableAutoStopRequest(DMA0, ADC_DMA_CHANNEL_LIST, false);
+
+	EDMA_EnableChannelRequest(DMA0, ADC_DMA_RESULT);
 }
 
 void adcInit(void)
 {
 	adc16_config_t adc16ConfigStruct;
+	adc16_channel_config_t adc16ChannelConfigStruct;
+
+	memset((void *)adcSampleRing, 0, sizeof(adcSampleRing));
+	adcRingReadIndex = 0;
+	adcVOXEnvelope = 0;
+	adcTemperature = 0;
+	adcTemperatureSamples = 0;
+
+	ADC16_GetDefaultConfig(&adc16ConfigStruct);
+	adc16ConfigStruct.clockDivider = kADC16_ClockDivider4;// 8 averaged conversions have to fit in a PIT_ADC_TRIGGER_PERIOD_US period
+	ADC16_Init(ADC0, &adc16ConfigStruct);
+	ADC16_DoAutoCalibration(ADC0);
+	ADC16_SetHardwareAverage(ADC0, kADC16_HardwareAverageCount8);
+
+	adcInitDMA();
+
+	// PIT channel 1 triggers the conversions
+	SIM->SOPT7 = (SIM->SOPT7 & ~(SIM_SOPT7_ADC0TRGSEL_MASK | SIM_SOPT7_ADC0PRETRGSEL_MASK)) | SIM_SOPT7_ADC0TRGSEL(0b0101) | SIM_SOPT7_ADC0ALTTRGEN_MASK;
+	ADC16_EnableDMA(ADC0, true);
+	ADC16_EnableHardwareTrigger(ADC0, true);
+
+	adc16ChannelConfigStruct.channelNumber = ADC_CHANNEL_BATTERY;
+	adc16ChannelConfigStruct.enableInterruptOnConversionCompleted = false;
+	adc16ChannelConfigStruct.enableDifferentialConversion = false;
+	ADC16_SetChannelConfig(ADC0, 0, &adc16ChannelConfigStruct);
+}
 
-	taskENTER_CRITICAL();
-	adc_channel = 1;// Next channel to sample. Channel 1 is the battery
-	adcBatteryVoltage = 0;
-	adcVOX = 0;
-
-	taskEXIT_CRITICAL();
-
-    ADC16_GetDefaultConfig(&adc16ConfigStruct);
-    ADC16_Init(ADC0, &adc16ConfigStruct);
-    ADC16_EnableHardwareTrigger(ADC0, false);
-    ADC16_DoAutoCalibration(ADC0);
-
-    EnableIRQ(ADC0_IRQn);
-
-    adcTriggerConversion(NO_ADC_CHANNEL_OVERRIDE);
+// Index of the next ring entry the DMA will write
+static inline int adcGetRingWriteIndex(void)
+{
+	return ((DMA0->TCD[ADC_DMA_RESULT].DADDR - (uint32_t)adcSampleRing) / sizeof(uint16_t)) % ADC_RING_LENGTH;
 }
-void approxRollingAverage (unsigned int newSample)
+
+// Called every millisecond, from the main task
+void adcTick(void)
 {
 #if defined(PLATFORM_DM1801) || defined(PLATFORM_DM1801A)
-	const int AVERAGING_LENGTH = 1000;
-#elif defined(PLATFORM_RD5R)
-	const int AVERAGING_LENGTH = 250;
+	const int TEMPERATURE_AVERAGING_SHIFT = 10; // ~1000 samples
 #else
-	const int AVERAGING_LENGTH = 250;
+	const int TEMPERATURE_AVERAGING_SHIFT = 8; // ~250 samples
 #endif
-	newSample *= TEMPERATURE_DECIMAL_RESOLUTION;
-	if (averageLength == 0)
-	{
-		// set initial reading to the sample
-		adcTemperature = newSample;
-	}
+	int writeIndex = adcGetRingWriteIndex();
 
-	// Gradually increase the averaging length, to get to a stable reading quicker
-	if (averageLength < AVERAGING_LENGTH)
+	while (adcRingReadIndex != writeIndex)
 	{
-		averageLength += 1;
+		uint32_t sample = adcSampleRing[adcRingReadIndex];
+
+		switch (adcRingReadIndex % ADC_CHANNELS_COUNT)
+		{
+			case ADC_ROUND_VOX:
+				{
+					// Fast attack, slow release
+					uint32_t level = (sample << ADC_VOX_ENVELOPE_FRACTION_BITS);
+
+					if (level > adcVOXEnvelope)
+					{
+						adcVOXEnvelope += ((level - adcVOXEnvelope) >> ADC_VOX_ENVELOPE_ATTACK_SHIFT);
+					}
+					else
+					{
+						adcVOXEnvelope -= ((adcVOXEnvelope - level) >> ADC_VOX_ENVELOPE_RELEASE_SHIFT);
+					}
+				}
+				break;
+
+			case ADC_ROUND_TEMPERATURE:
+				{
+					int32_t level = (int32_t)(sample << ADC_TEMPERATURE_FRACTION_BITS);
+
+					// Gradually increase the averaging length, to get to a stable reading quicker
+					if (adcTemperatureSamples < (1 << TEMPERATURE_AVERAGING_SHIFT))
+					{
+						adcTemperatureSamples++;
+					}
+
+					adcTemperature += ((level - adcTemperature) >> (31 - __builtin_clz(adcTemperatureSamples)));
+				}
+				break;
+		}
+
+		adcRingReadIndex = ((adcRingReadIndex + 1) % ADC_RING_LENGTH);
 	}
-
-	adcTemperature -= adcTemperature / averageLength;
-	adcTemperature += newSample / averageLength;
-}
-
-void ADC0_IRQHandler(void)
-{
-	uint32_t result = ADC16_GetChannelConversionValue(ADC0, 0);
-
-    switch (adc_channel)
-    {
-    case 1:
-    	adcBatteryVoltage = result + ((int)((((nonVolatileSettings.batteryCalibration & 0x0F) - 5) * 0.1) * 416));
-    	adc_channel = 3;// get channel 3 next
-    	break;
-    case 3:
-    	adcVOX = result;
-    	adc_channel = 26;// get channel 26 next
-    	break;
-    case 26:
-    	approxRollingAverage(result);
-    	adc_channel = 1;// get channel 1 next
-    	break;
-    }
-
-    /* Add for ARM errata 838869, affects Cortex-M4, Cortex-M4F Store immediate overlapping
-    exception return operation might vector to incorrect interrupt */
-    __DSB();
 }
 
 // result of conversion is rounded voltage*10 as integer
 int adcGetBatteryVoltage(void)
 {
-	return (int)(adcBatteryVoltage / 41.6f + 0.5f);
+	uint32_t sum = 0;
+
+	// Average of the battery samples in the ring
+	for (int i = ADC_ROUND_BATTERY; i < ADC_RING_LENGTH; i += ADC_CHANNELS_COUNT)
+	{
+		sum += adcSampleRing[i];
+	}
+
+	int32_t voltage = (sum / ADC_SAMPLES_PER_CHANNEL) + ((((nonVolatileSettings.batteryCalibration & 0x0F) - 5) * 416) / 10);
+
+	return ((voltage * 10) + 208) / 416;
 }
 
 int getVOX(void)
 {
-	return adcVOX;
+	return (adcVOXEnvelope >> ADC_VOX_ENVELOPE_FRACTION_BITS);
 }
 
 int getTemperature(void)
@@ -148,5 +219,5 @@ int getTemperature(void)
 	const int OFFSET = 9250;// Value needs to be validated as average for this radio
 #endif
 
-	return  (OFFSET + (nonVolatileSettings.temperatureCalibration * 10) - (adcTemperature  / (TEMPERATURE_DECIMAL_RESOLUTION / 10))) / 2;
+	return  (OFFSET + (nonVolatileSettings.temperatureCalibration * 10) - ((adcTemperature * 10) >> ADC_TEMPERATURE_FRACTION_BITS)) / 2;
 }
@@ -36,6 +36,7 @@
 //#include "fsl_tickless_generic.h"
 #include "interfaces/hr-c6000_spi.h"
 #include "interfaces/i2c.h"
+#include "functions/ticks.h"
 
 #include "usb/virtual_com.h"
 
@@ -86,6 +87,26 @@ volatile static uint32_t hsClockSpeed = CLOCK_MANAGER_SPEED_HS_RUN;
 volatile uint8_t currentTargetConfigIndex = 0x00;
 volatile uint32_t currentClockSpeedSetting = 0x00;
 
+// Run mode set by clockManagerSetRunMode(), the governor may only raise it (from RUN to HSRUN)
+static uint8_t requestedTargetConfigIndex = 0x00;
+static uint32_t requestedClockSpeedSetting = 0x00;
+
+#define CLOCK_MANAGER_LEASE_NO_EXPIRY   0xFFFFFFFF
+// PLL multiplier (x1000) of a clock speed setting, see the CLOCK_MANAGER_SPEED_xxx enum
+#define CLOCK_MANAGER_PLL_RATIO(s)      (((((s) & 0xFF) + 24) * 1000) / ((((s) >> 8) & 0xFF) + 1))
+
+static bool governorBoost = false;
+static uint8_t governorDownCount = 0;
+static uint32_t governorLeaseExpiry[CLOCK_MANAGER_LEASES_NUM];
+static uint32_t governorWindowStartTime = 0;
+static uint32_t governorWindowStartCycles = 0;
+static uint32_t governorBusyCycles = 0;
+static uint32_t governorBusyStartCycles = 0;
+static uint8_t governorBusyNesting = 0;
+static uint32_t statsLastAccountTime = 0;
+
+clockManagerStats_t clockManagerStats = { .structVersion = 0x01, .level = CLOCK_MANAGER_LEVEL_RUN };
+
 struct pllData
 {
 	uint32_t pllMult;
@@ -104,6 +125,7 @@ static void updateRTOSAndPitTimings(void)
 	PIT_DisableInterrupts(PIT, kPIT_Chnl_0, kPIT_TimerInterruptEnable);
 	PIT_SetTimerPeriod(PIT, kPIT_Chnl_0, USEC_TO_COUNT(1000U, CLOCK_GetFreq(kCLOCK_BusClk)));
 	PIT_EnableInterrupts(PIT, kPIT_Chnl_0, kPIT_TimerInterruptEnable);
+	PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, USEC_TO_COUNT(PIT_ADC_TRIGGER_PERIOD_US, CLOCK_GetFreq(kCLOCK_BusClk)));
 
     SPI0Setup();
     SPI1Setup();
@@ -374,40 +396,251 @@ uint32_t clockManagerGetRunMode(void)
 	return currentClockSpeedSetting;
 }
 
-void clockManagerSetRunMode(uint8_t targetConfigIndex, uint32_t clockSpeedSetting)
+static uint8_t clockManagerGetLevel(uint8_t targetConfigIndex, uint32_t clockSpeedSetting)
 {
-	if ((targetConfigIndex == currentTargetConfigIndex) && (clockSpeedSetting == currentClockSpeedSetting))
+	if (clockSpeedSetting == CLOCK_MANAGER_SPEED_HS_RUN)
 	{
-		return;
+		return CLOCK_MANAGER_LEVEL_HS_RUN;
 	}
 
-	if (clockSpeedSetting == CLOCK_MANAGER_RUN_SUSPEND_MODE)
+	if ((targetConfigIndex != kAPP_PowerModeVlpr) && (clockSpeedSetting == CLOCK_MANAGER_SPEED_RUN))
 	{
-		// If USB is connected, don't go to suspend mode clock, as it kills the USB
-		if (USB_DeviceIsConnected())
-		{
-			return;
-		}
+		return CLOCK_MANAGER_LEVEL_RUN;
 	}
-	else if ((clockSpeedSetting == CLOCK_MANAGER_SPEED_HS_RUN) && (USB_DeviceIsConnected() || USB_DeviceIsResetting()))
+
+	return CLOCK_MANAGER_LEVEL_LOW_POWER;
+}
+
+static void clockManagerAccountTime(void)
+{
+	uint32_t now = ticksGetMillis();
+
+	clockManagerStats.timeInLevel[clockManagerStats.level] += (now - statsLastAccountTime);
+	statsLastAccountTime = now;
+}
+
+// Starts a new CPU load measurement window
+static void clockManagerGovernorResetWindow(void)
+{
+	taskENTER_CRITICAL();
+	governorWindowStartCycles = DWT->CYCCNT;
+	governorBusyStartCycles = governorWindowStartCycles;
+	governorBusyCycles = 0;
+	taskEXIT_CRITICAL();
+	governorWindowStartTime = ticksGetMillis();
+}
+
+static void clockManagerSwitch(uint8_t targetConfigIndex, uint32_t clockSpeedSetting)
+{
+	if ((clockSpeedSetting == CLOCK_MANAGER_SPEED_HS_RUN) && (USB_DeviceIsConnected() || USB_DeviceIsResetting()))
 	{
 		targetConfigIndex = kAPP_PowerModeRun;
 		clockSpeedSetting = CLOCK_MANAGER_SPEED_RUN;
 	}
 
+	if ((targetConfigIndex == currentTargetConfigIndex) && (clockSpeedSetting == currentClockSpeedSetting))
+	{
+		return;
+	}
+
+	clockManagerAccountTime();
+
 	currentTargetConfigIndex = targetConfigIndex;
 	currentClockSpeedSetting = clockSpeedSetting;
 
 	taskENTER_CRITICAL();
+	uint32_t startCycles = DWT->CYCCNT;
 	hsClockSpeed = clockSpeedSetting;
 	callbackData0.originPowerState = SMC_GetPowerModeState(SMC);
 	NOTIFIER_SwitchConfig(&powerModeHandle, targetConfigIndex - kAPP_PowerModeMin - 1, kNOTIFIER_PolicyAgreement);
+	uint32_t switchCycles = DWT->CYCCNT - startCycles;
 	taskEXIT_CRITICAL();
+
+	// Approximation, as the core clock changed during the switch
+	clockManagerStats.lastSwitchLatencyUs = switchCycles / (SystemCoreClock / 1000000U);
+	if (clockManagerStats.lastSwitchLatencyUs > clockManagerStats.maxSwitchLatencyUs)
+	{
+		clockManagerStats.maxSwitchLatencyUs = clockManagerStats.lastSwitchLatencyUs;
+	}
+	clockManagerStats.switchCount++;
+	clockManagerStats.level = clockManagerGetLevel(targetConfigIndex, clockSpeedSetting);
+
+	// The cycle counts of the current window were measured with the previous clock
+	clockManagerGovernorResetWindow();
 #if defined(USING_EXTERNAL_DEBUGGER)
 	SEGGER_RTT_printf(0,"Core Clock = %dHz \n", CLOCK_GetFreq(kCLOCK_CoreSysClk));
 #endif
 }
 
+// Applies the requested run mode, raised to HSRUN if the governor or a lease needs it
+static void clockManagerUpdate(void)
+{
+	if ((clockManagerGetLevel(requestedTargetConfigIndex, requestedClockSpeedSetting) == CLOCK_MANAGER_LEVEL_RUN) &&
+			(governorBoost || (clockManagerStats.leases != 0)))
+	{
+		clockManagerSwitch(kAPP_PowerModeHsrun, CLOCK_MANAGER_SPEED_HS_RUN);
+	}
+	else
+	{
+		clockManagerSwitch(requestedTargetConfigIndex, requestedClockSpeedSetting);
+	}
+}
+
+void clockManagerSetRunMode(uint8_t targetConfigIndex, uint32_t clockSpeedSetting)
+{
+	if (clockSpeedSetting == CLOCK_MANAGER_RUN_SUSPEND_MODE)
+	{
+		// If USB is connected, don't go to suspend mode clock, as it kills the USB
+		if (USB_DeviceIsConnected())
+		{
+			return;
+		}
+	}
+
+	requestedTargetConfigIndex = targetConfigIndex;
+	requestedClockSpeedSetting = clockSpeedSetting;
+
+	if (clockManagerGetLevel(targetConfigIndex, clockSpeedSetting) != CLOCK_MANAGER_LEVEL_RUN)
+	{
+		governorBoost = false;
+	}
+	governorDownCount = 0;
+
+	clockManagerUpdate();
+}
+
+// Full speed (HSRUN) is needed by a subsystem, for durationMs (0: until released)
+void clockManagerLeaseFullSpeed(uint8_t lease, uint32_t durationMs)
+{
+	governorLeaseExpiry[lease] = ((durationMs == 0) ? CLOCK_MANAGER_LEASE_NO_EXPIRY : (ticksGetMillis() + durationMs));
+
+	if ((clockManagerStats.leases & (1 << lease)) == 0)
+	{
+		clockManagerStats.leases |= (1 << lease);
+		clockManagerUpdate();
+	}
+}
+
+void clockManagerLeaseRelease(uint8_t lease)
+{
+	if (clockManagerStats.leases & (1 << lease))
+	{
+		clockManagerStats.leases &= ~(1 << lease);
+		clockManagerUpdate();
+	}
+}
+
+// Called by the main, HR-C6000 and codec tasks around their actual work (not around their vTaskDelay() polling).
+// The time while at least one of them is in its work is accounted as busy.
+void clockManagerGovernorBusyBegin(void)
+{
+	taskENTER_CRITICAL();
+	if (governorBusyNesting++ == 0)
+	{
+		governorBusyStartCycles = DWT->CYCCNT;
+	}
+	taskEXIT_CRITICAL();
+}
+
+void clockManagerGovernorBusyEnd(void)
+{
+	taskENTER_CRITICAL();
+	if ((governorBusyNesting > 0) && (--governorBusyNesting == 0))
+	{
+		governorBusyCycles += (DWT->CYCCNT - governorBusyStartCycles);
+	}
+	taskEXIT_CRITICAL();
+}
+
+// Called from the main task loop
+void clockManagerGovernorTick(void)
+{
+	uint32_t now = ticksGetMillis();
+	bool changed = false;
+
+	for (int i = 0; i < CLOCK_MANAGER_LEASES_NUM; i++)
+	{
+		if ((clockManagerStats.leases & (1 << i)) && (governorLeaseExpiry[i] != CLOCK_MANAGER_LEASE_NO_EXPIRY) &&
+				((int32_t)(now - governorLeaseExpiry[i]) >= 0))
+		{
+			clockManagerStats.leases &= ~(1 << i);
+			changed = true;
+		}
+	}
+
+	if ((now - governorWindowStartTime) >= CLOCK_MANAGER_GOVERNOR_WINDOW_MS)
+	{
+		uint32_t totalCycles;
+		uint32_t busyCycles;
+		uint32_t load = 0;
+
+		taskENTER_CRITICAL();
+		totalCycles = DWT->CYCCNT - governorWindowStartCycles;
+		busyCycles = governorBusyCycles;
+		if (governorBusyNesting > 0)
+		{
+			// Still in some work (this function is called from the main task work)
+			busyCycles += (DWT->CYCCNT - governorBusyStartCycles);
+		}
+		taskEXIT_CRITICAL();
+		clockManagerGovernorResetWindow();
+
+		if ((totalCycles != 0) && (busyCycles < totalCycles))
+		{
+			load = (uint32_t)(((uint64_t)busyCycles * 100) / totalCycles);
+		}
+		else
+		{
+			load = 100;
+		}
+		clockManagerStats.loadPercent = load;
+
+		if (clockManagerGetLevel(requestedTargetConfigIndex, requestedClockSpeedSetting) == CLOCK_MANAGER_LEVEL_RUN)
+		{
+			if (governorBoost == false)
+			{
+				if ((load >= CLOCK_MANAGER_GOVERNOR_UP_LOAD) && (USB_DeviceIsConnected() == false))
+				{
+					governorBoost = true;
+					governorDownCount = 0;
+					changed = true;
+				}
+			}
+			else if (clockManagerStats.level == CLOCK_MANAGER_LEVEL_HS_RUN)
+			{
+				// Load the RUN clock would have to handle
+				uint32_t projectedLoad = (load * CLOCK_MANAGER_PLL_RATIO(CLOCK_MANAGER_SPEED_HS_RUN)) / CLOCK_MANAGER_PLL_RATIO(CLOCK_MANAGER_SPEED_RUN);
+
+				if (projectedLoad < CLOCK_MANAGER_GOVERNOR_DOWN_LOAD)
+				{
+					governorDownCount++;
+					if (governorDownCount >= CLOCK_MANAGER_GOVERNOR_DOWN_WINDOWS)
+					{
+						governorBoost = false;
+						governorDownCount = 0;
+						changed = true;
+					}
+				}
+				else
+				{
+					governorDownCount = 0;
+				}
+			}
+			else
+			{
+				governorBoost = false; // HSRUN couldn't be applied (USB)
+			}
+		}
+	}
+
+	clockManagerAccountTime();
+
+	if (changed)
+	{
+		clockManagerUpdate();
+	}
+}
+
 void clockManagerInit(void)
 {
 	callbacks[0] = callbackCfg0;
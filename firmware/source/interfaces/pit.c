@@ -58,6 +58,10 @@ void pitInit(void)
 	EnableIRQ(PIT0_IRQn);
 
     PIT_StartTimer(PIT, kPIT_Chnl_0);
+
+	// ADC hardware trigger, no interrupt
+	PIT_SetTimerPeriod(PIT, kPIT_Chnl_1, USEC_TO_COUNT(PIT_ADC_TRIGGER_PERIOD_US, CLOCK_GetFreq(kCLOCK_BusClk)));
+	PIT_StartTimer(PIT, kPIT_Chnl_1);
 }
 
 void PIT0_IRQHandler(void)
@@ -25,14 +25,57 @@
  *
  */
 #include "main.h"
+#include "interfaces/settingsStorage.h"
+#include "interfaces/crc.h"
+#include "functions/settings.h"
+
 #define STORAGE_BASE_ADDRESS          0x6000
+#define STORAGE_CRC_MARKER            0x4352 // "CR"
+
+// The settings are followed by a marker, the magic number of the settings it was computed for, and their CRC.
+// A trailer without the marker (older firmware), or for another magic number (the settings were written by a
+// firmware which doesn't know about it), is ignored, the settings integrity then only relies on their magic number.
+typedef struct
+{
+	uint16_t marker;
+	uint16_t crc;
+	int32_t  magicNumber;
+} settingsStorageTrailer_t;
+
+// The settings and their trailer are written at once
+static uint8_t settingsStorageBuffer[sizeof(settingsStruct_t) + sizeof(settingsStorageTrailer_t)];
 
 bool settingsStorageRead(uint8_t *buf, uint32_t size)
 {
-	return EEPROM_Read(STORAGE_BASE_ADDRESS, buf, size);
+	settingsStorageTrailer_t trailer;
+
+	if ((EEPROM_Read(STORAGE_BASE_ADDRESS, buf, size) == false) ||
+			(EEPROM_Read(STORAGE_BASE_ADDRESS + size, (uint8_t *)&trailer, sizeof(settingsStorageTrailer_t)) == false))
+	{
+		return false;
+	}
+
+	if ((trailer.marker != STORAGE_CRC_MARKER) || (size < sizeof(int32_t)) || (trailer.magicNumber != *(int32_t *)buf))
+	{
+		return true;
+	}
+
+	return (trailer.crc == crcCompute(CRC_TYPE_CCITT16, buf, size));
 }
 
 bool settingsStorageWrite(uint8_t *buf, uint32_t size)
 {
-	return EEPROM_Write(STORAGE_BASE_ADDRESS, buf, size);
+	settingsStorageTrailer_t trailer = { .marker = STORAGE_CRC_MARKER, .crc = crcCompute(CRC_TYPE_CCITT16, buf, size) };
+
+	if ((size < sizeof(int32_t)) || ((size + sizeof(settingsStorageTrailer_t)) > sizeof(settingsStorageBuffer)))
+	{
+		return false;
+	}
+
+	trailer.magicNumber = *(int32_t *)buf;// The settings start with their magic number
+
+	memcpy(settingsStorageBuffer, buf, size);
+	memcpy(settingsStorageBuffer + size, &trailer, sizeof(settingsStorageTrailer_t));
+
+	return EEPROM_Write(STORAGE_BASE_ADDRESS, settingsStorageBuffer, (size + sizeof(settingsStorageTrailer_t)));
 }
@@ -27,6 +27,8 @@
  */
 
 #include "drivers/fsl_port.h"
+#include "drivers/fsl_edma.h"
+#include "drivers/fsl_dmamux.h"
 #include "interfaces/hr-c6000_spi.h"
 
 const uint32_t SPI_0_BAUDRATE = 3000000U;
@@ -35,6 +37,243 @@ const uint32_t SPI_1_BAUDRATE = 1000000U;
 volatile bool SPI0inUse = false;
 volatile bool SPI1inUse = false;
 
+// Asynchronous transfers: the DMA channel feeds the TX FIFO with ready made PUSHR words (command + data),
+// the End Of Queue interrupt of the last frame completes the transfer.
+// Note: SPI1 has a single DMA request (TX or RX), only the TX one is enabled, nothing is read back.
+#define SPI0_DMA_CHANNEL    4
+#define SPI1_DMA_CHANNEL    5
+
+typedef struct
+{
+	uint32_t           commands[SPI_ASYNC_MAX_LENGTH + 2];
+	uint8_t            length; // frames (bytes)
+	spiAsyncCallback_t callback;
+	void              *userData;
+} spiAsyncTransfer_t;
+
+typedef struct
+{
+	SPI_Type           *base;
+	uint8_t             dmaChannel;
+	volatile bool      *inUse;
+	volatile bool       active;
+	volatile uint8_t    head;
+	volatile uint8_t    tail;
+	volatile uint8_t    count;
+	uint32_t            startCycles;
+	spiAsyncTransfer_t  queue[SPI_ASYNC_QUEUE_LENGTH];
+} spiAsyncBus_t;
+
+__attribute__((section(".data.$RAM2"))) static spiAsyncBus_t spiAsyncBuses[SPI_BUSES_NUM];
+
+spiBusStats_t spiBusStats[SPI_BUSES_NUM];
+
+static void spiAccountTransfer(spiBus_t bus, uint32_t bytes, uint32_t startCycles)
+{
+	spiBusStats[bus].transfers++;
+	spiBusStats[bus].bytes += bytes;
+	spiBusStats[bus].busTimeUs += ((DWT->CYCCNT - startCycles) / (SystemCoreClock / 1000000U));
+}
+
+// Needs to be called with the SPI interrupts masked
+static void spiAsyncStartNext(spiAsyncBus_t *asyncBus)
+{
+	edma_transfer_config_t transferConfig;
+	SPI_Type *base = asyncBus->base;
+	spiAsyncTransfer_t *transfer;
+
+	if (asyncBus->active || (asyncBus->count == 0) || *asyncBus->inUse)
+	{
+		return;
+	}
+
+	transfer = &asyncBus->queue[asyncBus->tail];
+	asyncBus->active = true;
+	asyncBus->startCycles = DWT->CYCCNT;
+
+	DSPI_StopTransfer(base);
+	DSPI_FlushFifo(base, true, true);
+	DSPI_ClearStatusFlags(base, kDSPI_AllStatusFlag);
+
+	EDMA_ResetChannel(DMA0, asyncBus->dmaChannel);
+	EDMA_PrepareTransfer(&transferConfig, transfer->commands, sizeof(uint32_t), (void *)DSPI_MasterGetTxRegisterAddress(base), sizeof(uint32_t),
+			sizeof(uint32_t), (transfer->length * sizeof(uint32_t)), kEDMA_MemoryToPeripheral);
+	EDMA_SetTransferConfig(DMA0, asyncBus->dmaChannel, &transferConfig, NULL);
+	EDMA_EnableAutoStopRequest(DMA0, asyncBus->dmaChannel, true);
+	EDMA_EnableChannelRequest(DMA0, asyncBus->dmaChannel);
+
+	DSPI_EnableInterrupts(base, kDSPI_EndOfQueueInterruptEnable);
+	DSPI_EnableDMA(base, kDSPI_TxDmaEnable);
+	DSPI_StartTransfer(base);
+}
+
+// Needs to be called with the SPI interrupts masked
+static void spiAsyncComplete(spiBus_t bus)
+{
+	spiAsyncBus_t *asyncBus = &spiAsyncBuses[bus];
+	SPI_Type *base = asyncBus->base;
+	spiAsyncTransfer_t *transfer = &asyncBus->queue[asyncBus->tail];
+	spiAsyncCallback_t callback = transfer->callback;
+	void *userData = transfer->userData;
+
+	DSPI_DisableDMA(base, kDSPI_TxDmaEnable);
+	DSPI_DisableInterrupts(base, kDSPI_EndOfQueueInterruptEnable);
+	DSPI_ClearStatusFlags(base, kDSPI_EndOfQueueFlag);
+	DSPI_FlushFifo(base, false, true);
+	EDMA_DisableChannelRequest(DMA0, asyncBus->dmaChannel);
+
+	spiAccountTransfer(bus, transfer->length, asyncBus->startCycles);
+
+	asyncBus->tail = ((asyncBus->tail + 1) % SPI_ASYNC_QUEUE_LENGTH);
+	asyncBus->count--;
+	asyncBus->active = false;
+
+	if (callback != NULL)
+	{
+		callback(kStatus_Success, userData);
+	}
+
+	spiAsyncStartNext(asyncBus);
+}
+
+static void spiAsyncIRQHandler(spiBus_t bus)
+{
+	spiAsyncBus_t *asyncBus = &spiAsyncBuses[bus];
+
+	if (asyncBus->active && (DSPI_GetStatusFlags(asyncBus->base) & kDSPI_EndOfQueueFlag))
+	{
+		spiAsyncComplete(bus);
+	}
+}
+
+void SPI0_IRQHandler(void)
+{
+	spiAsyncIRQHandler(SPI_BUS_0);
+	__DSB();
+}
+
+void SPI1_IRQHandler(void)
+{
+	spiAsyncIRQHandler(SPI_BUS_1);
+	__DSB();
+}
+
+// Waits (polling) for all the queued asynchronous transfers of that bus to be completed. Can be used from an ISR.
+void SPIAsyncFlush(spiBus_t bus)
+{
+	spiAsyncBus_t *asyncBus = &spiAsyncBuses[bus];
+
+	if (asyncBus->count == 0)
+	{
+		return;
+	}
+
+	UBaseType_t savedInterruptMask = taskENTER_CRITICAL_FROM_ISR();
+	while (asyncBus->count > 0)
+	{
+		if (asyncBus->active == false)
+		{
+			if (*asyncBus->inUse)
+			{
+				break; // A blocking transfer (we interrupted) owns the bus, it will start the queue when finished
+			}
+
+			spiAsyncStartNext(asyncBus);
+		}
+
+		while ((DSPI_GetStatusFlags(asyncBus->base) & kDSPI_EndOfQueueFlag) == 0)
+		{
+		}
+
+		spiAsyncComplete(bus);
+	}
+	taskEXIT_CRITICAL_FROM_ISR(savedInterruptMask);
+}
+
+// The data is copied, the buffer can be reused as soon as this function returns.
+int SPIWritePageRegByteArrayAsync(spiBus_t bus, uint8_t page, uint8_t reg, const uint8_t *values, uint8_t length, spiAsyncCallback_t callback, void *userData)
+{
+	spiAsyncBus_t *asyncBus = &spiAsyncBuses[bus];
+
+	if (length > SPI_ASYNC_MAX_LENGTH)
+	{
+		return kStatus_InvalidArgument;
+	}
+
+	if (asyncBus->count >= SPI_ASYNC_QUEUE_LENGTH)
+	{
+		spiBusStats[bus].queueFull++;
+		SPIAsyncFlush(bus);
+
+		if (asyncBus->count >= SPI_ASYNC_QUEUE_LENGTH)
+		{
+			spiBusStats[bus].collisions++;
+			return -1;
+		}
+	}
+
+	UBaseType_t savedInterruptMask = taskENTER_CRITICAL_FROM_ISR();
+	spiAsyncTransfer_t *transfer = &asyncBus->queue[asyncBus->head];
+	uint8_t frames = (length + 2);
+
+	for (uint8_t i = 0; i < frames; i++)
+	{
+		bool last = (i == (frames - 1));
+		uint8_t data = ((i == 0) ? page : ((i == 1) ? reg : values[i - 2]));
+
+		// CS is held between frames, released after the last one
+		transfer->commands[i] = SPI_PUSHR_CONT(last ? 0 : 1) | SPI_PUSHR_CTAS(0) | SPI_PUSHR_PCS(kDSPI_Pcs0) | SPI_PUSHR_EOQ(last ? 1 : 0) | SPI_PUSHR_TXDATA(data);
+	}
+	transfer->length = frames;
+	transfer->callback = callback;
+	transfer->userData = userData;
+
+	asyncBus->head = ((asyncBus->head + 1) % SPI_ASYNC_QUEUE_LENGTH);
+	asyncBus->count++;
+
+	spiAsyncStartNext(asyncBus);
+	taskEXIT_CRITICAL_FROM_ISR(savedInterruptMask);
+
+	return kStatus_Success;
+}
+
+// Blocking transfers: wait for the queued asynchronous transfers, then take the bus
+static bool spiBlockingTransferBegin(spiBus_t bus, uint32_t *startCycles)
+{
+	volatile bool *inUse = spiAsyncBuses[bus].inUse;
+
+	if (*inUse)
+	{
+		spiBusStats[bus].collisions++;
+		return false;
+	}
+
+	if (spiAsyncBuses[bus].count > 0)
+	{
+		spiBusStats[bus].collisions++;
+		SPIAsyncFlush(bus);
+	}
+
+	*inUse = true;
+	*startCycles = DWT->CYCCNT;
+
+	return true;
+}
+
+static void spiBlockingTransferEnd(spiBus_t bus, uint32_t bytes, uint32_t startCycles)
+{
+	spiAccountTransfer(bus, bytes, startCycles);
+	*spiAsyncBuses[bus].inUse = false;
+
+	// Some asynchronous transfers may have been queued in the meantime
+	if (spiAsyncBuses[bus].count > 0)
+	{
+		UBaseType_t savedInterruptMask = taskENTER_CRITICAL_FROM_ISR();
+		spiAsyncStartNext(&spiAsyncBuses[bus]);
+		taskEXIT_CRITICAL_FROM_ISR(savedInterruptMask);
+	}
+}
+
 void SPIInit(void)
 {
 	/* PORTD0 is configured as SPI0_CS0 */
@@ -64,6 +303,18 @@ void SPIInit(void)
 	NVIC_SetPriority(SPI0_IRQn, 3);
 	NVIC_SetPriority(SPI1_IRQn, 3);
 
+	spiAsyncBuses[SPI_BUS_0] = (spiAsyncBus_t){ .base = SPI0, .dmaChannel = SPI0_DMA_CHANNEL, .inUse = &SPI0inUse };
+	spiAsyncBuses[SPI_BUS_1] = (spiAsyncBus_t){ .base = SPI1, .dmaChannel = SPI1_DMA_CHANNEL, .inUse = &SPI1inUse };
+
+	// The eDMA module is initialised by the I2S
+	DMAMUX_Init(DMAMUX0);
+	DMAMUX_SetSource(DMAMUX0, SPI0_DMA_CHANNEL, 15); // 15..SPI0 Transmit
+	DMAMUX_EnableChannel(DMAMUX0, SPI0_DMA_CHANNEL);
+	DMAMUX_SetSource(DMAMUX0, SPI1_DMA_CHANNEL, 16); // 16..SPI1 Transmit or Receive
+	DMAMUX_EnableChannel(DMAMUX0, SPI1_DMA_CHANNEL);
+	EnableIRQ(SPI0_IRQn);
+	EnableIRQ(SPI1_IRQn);
+
 	SPI0Setup();
 	SPI1Setup();
 }
@@ -72,6 +323,8 @@ void SPI0Setup(void)
 {
 	dspi_master_config_t config;
 
+	SPIAsyncFlush(SPI_BUS_0);
+
 	config.whichCtar = kDSPI_Ctar0;
 	config.ctarConfig.baudRate = SPI_0_BAUDRATE;
 	config.ctarConfig.bitsPerFrame = 8;
@@ -97,6 +350,8 @@ void SPI1Setup(void)
 {
 	dspi_master_config_t config;
 
+	SPIAsyncFlush(SPI_BUS_1);
+
 	config.whichCtar = kDSPI_Ctar0;
 	config.ctarConfig.baudRate = SPI_1_BAUDRATE;
 	config.ctarConfig.bitsPerFrame = 8;
@@ -122,11 +377,12 @@ int SPI0WritePageRegByte(uint8_t page, uint8_t reg, uint8_t val)
 {
 	uint8_t txBuf[3];
 
-	if (SPI0inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_0, &startCycles) == false)
 	{
 		return -1;
 	}
-	SPI0inUse = true;
 
 	dspi_transfer_t masterXfer;
 	status_t status;
@@ -143,7 +399,7 @@ int SPI0WritePageRegByte(uint8_t page, uint8_t reg, uint8_t val)
 
 	status = DSPI_MasterTransferBlocking(SPI0, &masterXfer);
 
-	SPI0inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_0, masterXfer.dataSize, startCycles);
 
 	return status;
 }
@@ -152,11 +408,12 @@ int SPI0ReadPageRegByte(uint8_t page, uint8_t reg, volatile uint8_t *val)
 {
 	uint8_t rxBuf[3];
 	uint8_t RxBuf[3];
-	if (SPI0inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_0, &startCycles) == false)
 	{
 		return -1;
 	}
-	SPI0inUse = true;
 
 	dspi_transfer_t masterXfer;
 	status_t status;
@@ -178,7 +435,7 @@ int SPI0ReadPageRegByte(uint8_t page, uint8_t reg, volatile uint8_t *val)
 		*val = rxBuf[2];
 	}
 
-	SPI0inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_0, masterXfer.dataSize, startCycles);
 
 	return status;
 }
@@ -209,13 +466,13 @@ int SPI0WritePageRegByteArray(uint8_t page, uint8_t reg, const uint8_t *values,
 		return kStatus_InvalidArgument;
 	}
 
-	if (SPI0inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_0, &startCycles) == false)
 	{
 		return -1;
 	}
 
-	SPI0inUse = true;
-
 	dspi_transfer_t masterXfer;
 	status_t status;
 
@@ -231,7 +488,7 @@ int SPI0WritePageRegByteArray(uint8_t page, uint8_t reg, const uint8_t *values,
 
 	status = DSPI_MasterTransferBlocking(SPI0, &masterXfer);
 
-	SPI0inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_0, masterXfer.dataSize, startCycles);
 
 	return status;
 }
@@ -246,11 +503,12 @@ int SPI0ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values
 		return kStatus_InvalidArgument;
 	}
 
-	if (SPI0inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_0, &startCycles) == false)
 	{
 		return -1;
 	}
-	SPI0inUse = true;
 
 	dspi_transfer_t masterXfer;
 	status_t status;
@@ -274,7 +532,7 @@ int SPI0ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values
 		}
 	}
 
-	SPI0inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_0, masterXfer.dataSize, startCycles);
 
 	return status;
 }
@@ -288,11 +546,12 @@ int SPI1WritePageRegByteArray(uint8_t page, uint8_t reg, const uint8_t *values,
 		return kStatus_InvalidArgument;
 	}
 
-	if (SPI1inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_1, &startCycles) == false)
 	{
 		return -1;
 	}
-	SPI1inUse = true;
 
 	dspi_transfer_t masterXfer;
 	status_t status;
@@ -309,7 +568,7 @@ int SPI1WritePageRegByteArray(uint8_t page, uint8_t reg, const uint8_t *values,
 
 	status = DSPI_MasterTransferBlocking(SPI1, &masterXfer);
 
-	SPI1inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_1, masterXfer.dataSize, startCycles);
 
 	return status;
 }
@@ -324,11 +583,12 @@ int SPI1ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values
 		return kStatus_InvalidArgument;
 	}
 
-	if (SPI1inUse)
+	uint32_t startCycles;
+
+	if (spiBlockingTransferBegin(SPI_BUS_1, &startCycles) == false)
 	{
 		return -1;
 	}
-	SPI1inUse = true;
 
 	dspi_transfer_t masterXfer;
 	status_t status;
@@ -352,7 +612,7 @@ int SPI1ReadPageRegByteArray(uint8_t page, uint8_t reg, volatile uint8_t *values
 		}
 	}
 
-	SPI1inUse = false;
+	spiBlockingTransferEnd(SPI_BUS_1, masterXfer.dataSize, startCycles);
 
 	return status;
 }
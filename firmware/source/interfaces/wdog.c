@@ -26,11 +26,13 @@
  *
  */
 
+#include <string.h>
 #include "interfaces/wdog.h"
 #include "interfaces/pit.h"
 #include "functions/ticks.h"
 #include "functions/sound.h"
 #include "hardware/HR-C6000.h"
+#include "dmr_codec/codec.h"
 #include "main.h"
 #if defined(USING_EXTERNAL_DEBUGGER)
 #include "SeggerRTT/RTT/SEGGER_RTT.h"
@@ -44,15 +46,164 @@ static WDOG_Type *wdog_base = WDOG;
 volatile static int watchdog_refresh_tick = 0;
 volatile static bool reboot = false;
 
+static Task_t * const watchdogMonitoredTasks[WATCHDOG_MONITORED_TASKS] = { &mainTask, &beepTask, &hrc6000Task, &codecTask };
+// Upper limit (included) of each histogram bin, in milliseconds. Last bin gets everything over the previous one.
+static const uint16_t watchdogHistogramBinLimits[WATCHDOG_HISTOGRAM_BINS] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 0xFFFF };
+
+static volatile uint32_t worstStallDuration = 0;
+static volatile uint32_t worstStallPC = 0;
+static volatile uint32_t worstStallTime = 0;
+static volatile TaskHandle_t worstStallTask = NULL;
+
+// PC of a task: from the exception frame if it has been interrupted by the PIT, otherwise from its saved context
+static uint32_t watchdogGetTaskPC(TaskHandle_t handle)
+{
+	uint32_t *frame;
+
+	if (handle == xTaskGetCurrentTaskHandle())
+	{
+		frame = (uint32_t *)__get_PSP();
+	}
+	else
+	{
+		// pxTopOfStack is the first member of the TCB. The port saves r4-r11 and EXC_RETURN,
+		// plus s16-s31 if the task used the FPU, on top of the exception frame.
+		uint32_t *topOfStack = *(uint32_t **)handle;
+
+		frame = topOfStack + (((topOfStack[8] & 0x10) == 0) ? 25 : 9);
+	}
+
+	return frame[6];
+}
+
+// Keeps the longest time a running task hasn't been alive, and where it was
+static void watchdogCheckStalls(void)
+{
+	uint32_t now = ticksGetMillis();
+
+	for (int i = 0; i < WATCHDOG_MONITORED_TASKS; i++)
+	{
+		Task_t *task = watchdogMonitoredTasks[i];
+
+		if (task->Running && (task->Handle != NULL))
+		{
+			uint32_t elapsed = now - task->LastAliveTime;
+
+			if ((elapsed >= WATCHDOG_SOFT_WARNING_MS) && (elapsed > worstStallDuration))
+			{
+				worstStallDuration = elapsed;
+				worstStallTask = task->Handle;
+				worstStallPC = watchdogGetTaskPC(task->Handle);
+				worstStallTime = now;
+			}
+		}
+	}
+}
+
+void watchdogTaskStart(Task_t *task)
+{
+	task->LastAliveTime = ticksGetMillis();
+	task->AliveCount = TASK_FLAGGED_ALIVE;
+}
+
+void watchdogTaskAlive(Task_t *task)
+{
+	uint32_t now = ticksGetMillis();
+	uint32_t interval = now - task->LastAliveTime;
+	int bin = 0;
+
+	task->LastAliveTime = now;
+	task->AliveCount = TASK_FLAGGED_ALIVE;
+
+	while ((bin < (WATCHDOG_HISTOGRAM_BINS - 1)) && (interval > watchdogHistogramBinLimits[bin]))
+	{
+		bin++;
+	}
+
+	task->Stats.histogram[bin]++;
+	task->Stats.count++;
+
+	if (interval > task->Stats.maxInterval)
+	{
+		task->Stats.maxInterval = interval;
+	}
+
+	if (interval >= WATCHDOG_SOFT_WARNING_MS)
+	{
+		task->Stats.warnings++;
+
+		if (interval >= WATCHDOG_DEADLINE_MS)
+		{
+			task->Stats.misses++;
+		}
+#if defined(USING_EXTERNAL_DEBUGGER)
+		SEGGER_RTT_printf(0, "WDOG: %s late by %dms\n", pcTaskGetName(task->Handle), interval);
+#endif
+	}
+}
+
+void watchdogGetReport(watchdogReport_t *report)
+{
+	memset(report, 0, sizeof(watchdogReport_t));
+	report->structVersion = 0x01;
+	memcpy(report->histogramBinLimits, watchdogHistogramBinLimits, sizeof(watchdogHistogramBinLimits));
+
+	for (int i = 0; i < WATCHDOG_MONITORED_TASKS; i++)
+	{
+		Task_t *task = watchdogMonitoredTasks[i];
+		watchdogTaskReport_t *taskReport = &report->tasks[i];
+		uint32_t cumulated = 0;
+
+		if (task->Handle != NULL)
+		{
+			strncpy(taskReport->name, pcTaskGetName(task->Handle), WATCHDOG_TASK_NAME_LENGTH);
+		}
+
+		taskReport->count = task->Stats.count;
+		taskReport->maxInterval = task->Stats.maxInterval;
+		taskReport->warnings = task->Stats.warnings;
+		taskReport->misses = task->Stats.misses;
+		memcpy(taskReport->histogram, task->Stats.histogram, sizeof(taskReport->histogram));
+
+		// 99th percentile, as the upper limit of the bin it falls in
+		for (int bin = 0; bin < WATCHDOG_HISTOGRAM_BINS; bin++)
+		{
+			cumulated += task->Stats.histogram[bin];
+
+			if (((uint64_t)cumulated * 100) >= ((uint64_t)taskReport->count * 99))
+			{
+				taskReport->p99Interval = MIN(watchdogHistogramBinLimits[bin], task->Stats.maxInterval);
+				break;
+			}
+		}
+	}
+
+	taskENTER_CRITICAL();
+	if (worstStallTask != NULL)
+	{
+		strncpy(report->worstStallTaskName, pcTaskGetName(worstStallTask), WATCHDOG_TASK_NAME_LENGTH);
+	}
+	report->worstStallPC = worstStallPC;
+	report->worstStallDuration = worstStallDuration;
+	report->worstStallTime = worstStallTime;
+	taskEXIT_CRITICAL();
+}
+
 void watchdogTick(void) // called each 1ms my PIT callback
 {
+	if (isSuspended == false)
+	{
+		watchdogCheckStalls();
+	}
+
 	watchdog_refresh_tick++;
-	if (watchdog_refresh_tick >= 100)
+	if (watchdog_refresh_tick >= WATCHDOG_REFRESH_PERIOD_MS)
 	{
 		if (isSuspended || ((reboot == false) &&
 				(mainTask.Running ? (mainTask.AliveCount > 0) : true) &&
 				(beepTask.Running ? (beepTask.AliveCount > 0) : true) &&
-				(hrc6000Task.Running ? (hrc6000Task.AliveCount > 0) : true)))
+				(hrc6000Task.Running ? (hrc6000Task.AliveCount > 0) : true) &&
+				(codecTask.Running ? (codecTask.AliveCount > 0) : true)))
 		{
 			WDOG_Refresh(wdog_base);
 		}
@@ -73,6 +224,11 @@ void watchdogTick(void) // called each 1ms my PIT callback
 			{
 				hrc6000Task.AliveCount--;
 			}
+
+			if (codecTask.Running && (codecTask.AliveCount > 0))
+			{
+				codecTask.AliveCount--;
+			}
 		}
 
 		watchdog_refresh_tick = 0;
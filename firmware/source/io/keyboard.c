@@ -32,12 +32,26 @@
 #include "interfaces/pit.h"
 #include "functions/settings.h"
 #include "interfaces/gpio.h"
+#include "functions/ticks.h"
 
 static char oldKeyboardCode;
 static uint32_t keyDebounceScancode;
-static int keyDebounceCounter;
+static uint32_t keyDebounceStartTime;
 static uint8_t keyState;
 
+#if ! defined(PLATFORM_GD77S)
+#define KEY_ROWS_MASK         ((1U << Pin_Key_Row0) | (1U << Pin_Key_Row1) | (1U << Pin_Key_Row2) | (1U << Pin_Key_Row3) | (1U << Pin_Key_Row4))
+#define KEY_SCAN_IDLE         -1
+
+// When idle, all the columns are driven low, and a falling edge on any row line raises the Port B interrupt.
+// Then the matrix is scanned one column per call to keyboardCheckKeyEvent(): the column is selected at the end of
+// a call, and read at the next one, so there is no need to wait for the row lines to settle.
+static volatile bool keyRowInterrupt = false;
+static int keyScanColumn = KEY_SCAN_IDLE;
+static uint32_t keyScanAccumulator;
+static uint32_t keyScancode; // Last complete scan
+#endif
+
 static char keypadAlphaKey;
 static int keypadAlphaIndex;
 
@@ -116,13 +130,136 @@ static const char keypadAlphaMap[11][31] = {
 		"*"
 };
 
+static inline uint8_t keyboardReadCol(void)
+{
+#if defined(PLATFORM_GD77S)
+	return 0;
+#else
+	return ~((GPIOB->PDIR)>>19) & 0x1f;
+#endif
+}
+
+#if ! defined(PLATFORM_GD77S)
+static void keyboardSetAllColumns(const gpio_pin_config_t *config)
+{
+	GPIO_PinInit(GPIO_Key_Col0, Pin_Key_Col0, config);
+	GPIO_PinInit(GPIO_Key_Col1, Pin_Key_Col1, config);
+	GPIO_PinInit(GPIO_Key_Col2, Pin_Key_Col2, config);
+	GPIO_PinInit(GPIO_Key_Col3, Pin_Key_Col3, config);
+}
+
+static void keyboardSelectColumn(int col)
+{
+	GPIO_PinInit(GPIOC, col, &pin_config_output);
+	GPIO_PinWrite(GPIOC, col, 0);
+}
+
+static void keyboardReleaseColumn(int col)
+{
+	GPIO_PinWrite(GPIOC, col, 1);
+	GPIO_PinInit(GPIOC, col, &pin_config_input);
+}
+
+// All columns low, waiting for a key press interrupt
+static void keyboardEnterIdle(void)
+{
+	keyboardSetAllColumns(&pin_config_output);
+	GPIO_PortClear(GPIOC, ((1U << Pin_Key_Col0) | (1U << Pin_Key_Col1) | (1U << Pin_Key_Col2) | (1U << Pin_Key_Col3)));
+
+	keyScanColumn = KEY_SCAN_IDLE;
+	keyScancode = 0;
+
+	PORT_ClearPinsInterruptFlags(Port_Key_Row0, KEY_ROWS_MASK);
+	NVIC_EnableIRQ(PORTB_IRQn);
+
+	// A key pressed while the columns were released may have already pulled its row down, hence no edge will come.
+	if (keyboardReadCol() != 0)
+	{
+		keyRowInterrupt = true;
+	}
+}
+
+static void keyboardInitRowInterrupts(void)
+{
+	PORT_SetPinInterruptConfig(Port_Key_Row0, Pin_Key_Row0, kPORT_InterruptFallingEdge);
+	PORT_SetPinInterruptConfig(Port_Key_Row1, Pin_Key_Row1, kPORT_InterruptFallingEdge);
+	PORT_SetPinInterruptConfig(Port_Key_Row2, Pin_Key_Row2, kPORT_InterruptFallingEdge);
+	PORT_SetPinInterruptConfig(Port_Key_Row3, Pin_Key_Row3, kPORT_InterruptFallingEdge);
+	PORT_SetPinInterruptConfig(Port_Key_Row4, Pin_Key_Row4, kPORT_InterruptFallingEdge);
+
+	NVIC_SetPriority(PORTB_IRQn, 3);
+}
+
+void PORTB_IRQHandler(void)
+{
+	// No more interrupts until the scan is over, as scanning toggles the row lines
+	NVIC_DisableIRQ(PORTB_IRQn);
+	PORT_ClearPinsInterruptFlags(Port_Key_Row0, KEY_ROWS_MASK);
+	keyRowInterrupt = true;
+
+	__DSB();
+}
+
+// Advances the matrix scan by one column. Returns the last complete scancode.
+static uint32_t keyboardUpdateScan(void)
+{
+	if (keyScanColumn == KEY_SCAN_IDLE)
+	{
+		if (keyRowInterrupt == false)
+		{
+			return 0;
+		}
+
+		keyRowInterrupt = false;
+		keyboardSetAllColumns(&pin_config_input);
+		keyScanAccumulator = 0;
+		keyScanColumn = 3;
+		keyboardSelectColumn(keyScanColumn);
+
+		return keyScancode;
+	}
+
+	// The column has been selected since the last call
+	keyScanAccumulator = (keyScanAccumulator << 5) | keyboardReadCol();
+	keyboardReleaseColumn(keyScanColumn);
+
+	if (keyScanColumn > 0)
+	{
+		keyScanColumn--;
+	}
+	else
+	{
+		keyScancode = keyScanAccumulator;
+		keyScanAccumulator = 0;
+		keyScanColumn = 3;
+
+		// All keys released, back to interrupt mode
+		if (keyScancode == 0)
+		{
+			keyboardEnterIdle();
+			return 0;
+		}
+	}
+
+	keyboardSelectColumn(keyScanColumn);
+
+	return keyScancode;
+}
+#endif // ! PLATFORM_GD77S
+
 void keyboardInit(void)
 {
 	gpioInitKeyboard();
 
+#if ! defined(PLATFORM_GD77S)
+	keyRowInterrupt = false;
+	keyboardInitRowInterrupts();
+	keyboardEnterIdle();
+#endif
+
 	oldKeyboardCode = 0;
 	keyDebounceScancode = 0;
-	keyDebounceCounter = 0;
+	keyDebounceStartTime = 0;
 	keypadAlphaEnable = false;
 	keypadAlphaIndex = 0;
 	keypadAlphaKey = 0;
@@ -155,32 +292,27 @@ bool keyboardKeyIsDTMFKey(char key)
 	return false;
 }
 
-static inline uint8_t keyboardReadCol(void)
-{
-#if defined(PLATFORM_GD77S)
-	return 0;
-#else
-	return ~((GPIOB->PDIR)>>19) & 0x1f;
-#endif
-}
-
+// Synchronous full scan, only used at boot time (the main loop uses the interrupt driven scan)
 uint32_t keyboardRead(void)
 {
 	uint32_t result = 0;
 
 #if ! defined(PLATFORM_GD77S)
+	NVIC_DisableIRQ(PORTB_IRQn);
+	keyboardSetAllColumns(&pin_config_input);
+
 	for (int col = 3; col >= 0; col--)
 	{
-		GPIO_PinInit(GPIOC, col, &pin_config_output);
-		GPIO_PinWrite(GPIOC, col, 0);
+		keyboardSelectColumn(col);
 		for (volatile int i = 0; i < 100; i++)
 			; // small delay to allow voltages to settle. The delay value of 100 is arbitrary.
 
 		result = (result << 5) | keyboardReadCol();
 
-		GPIO_PinWrite(GPIOC, col, 1);
-		GPIO_PinInit(GPIOC, col, &pin_config_input);
+		keyboardReleaseColumn(col);
 	}
+
+	keyboardEnterIdle();
 #endif // ! PLATFORM_GD77S
 
     return result;
@@ -225,7 +357,11 @@ bool keyboardScanKey(uint32_t scancode, char *keycode)
 
 void keyboardCheckKeyEvent(keyboardCode_t *keys, int *event)
 {
-	uint32_t scancode = keyboardRead();
+#if defined(PLATFORM_GD77S)
+	uint32_t scancode = 0;
+#else
+	uint32_t scancode = keyboardUpdateScan();
+#endif
 	char keycode;
 	bool validKey;
 	int newAlphaKey;
@@ -250,7 +386,7 @@ void keyboardCheckKeyEvent(keyboardCode_t *keys, int *event)
 		if (scancode != 0)
 		{
 			keyState = KEY_DEBOUNCE;
-			keyDebounceCounter = 0;
+			keyDebounceStartTime = ticksGetMillis();
 			keyDebounceScancode = scancode;
 			oldKeyboardCode = 0;
 		}
@@ -267,8 +403,7 @@ void keyboardCheckKeyEvent(keyboardCode_t *keys, int *event)
 		}
 		break;
 	case KEY_DEBOUNCE:
-		keyDebounceCounter++;
-		if (keyDebounceCounter > KEY_DEBOUNCE_COUNTER)
+		if ((ticksGetMillis() - keyDebounceStartTime) > KEY_DEBOUNCE_DELAY)
 		{
 			if (keyDebounceScancode == scancode)
 			{
@@ -38,6 +38,8 @@
 #include "interfaces/clockManager.h"
 #include "functions/rxPowerSaving.h"
 #include "interfaces/wdog.h"
+#include "interfaces/crc.h"
+#include "functions/bootTrace.h"
 #include <time.h>
 
 #if defined(USING_EXTERNAL_DEBUGGER)
@@ -59,6 +61,7 @@ static uint32_t lowBatteryCount = 0;
 #define LOW_BATTERY_VOLTAGE_RECOVERY_TIME          30000 // 30 seconds
 #define SUSPEND_LOW_BATTERY_RATE                   1000 // 1 second
 #define LOW_BATTERY_SUSPEND_TO_POWEROFF            69
+#define BACKGROUND_INIT_CONTACTS_PER_TICK          16 // The whole contacts cache is built in ~64 ticks
 
 static const int BATTERY_VOLTAGE_TICK_RELOAD = 100;
 static const int BATTERY_VOLTAGE_CALLBACK_TICK_RELOAD = 20;
@@ -95,7 +98,7 @@ void mainTaskInit(void)
 	);
 
 	mainTask.Running = true;
-	mainTask.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&mainTask);
 
 	vTaskStartScheduler();
 }
@@ -131,7 +134,7 @@ static void batteryUpdate(void)
 		}
 		batteryVoltageTick = 0;
 	}
-	adcTriggerConversion(NO_ADC_CHANNEL_OVERRIDE);// need the ADC value next time though, so request conversion now, so that its ready by the time we need it
+	adcTick();
 }
 
 static void showLowBattery(void)
@@ -402,7 +405,6 @@ static void die(bool usbMonitoring, bool maintainRTC, bool forceSuspend)
 		while(batteryLowRetries-- > 0)
 		{
 			batteryCriticalCount += (batteryLastReadingIsCritical() ? 1 : (batteryCriticalCount ? -1 : 0));
-			adcTriggerConversion(1);
 			vTaskDelay((1 / portTICK_PERIOD_MS));
 		}
 		bool batteryIsCritical = batteryCriticalCount > 25;
@@ -544,9 +546,9 @@ static void wakeFromSleep(void)
 	trxPowerUpDownRxAndC6000(true, true);
 
 	// Reset counters before enabling watchdog
-	hrc6000Task.AliveCount = TASK_FLAGGED_ALIVE;
-	beepTask.AliveCount = TASK_FLAGGED_ALIVE;
-	mainTask.AliveCount = TASK_FLAGGED_ALIVE;
+	watchdogTaskStart(&hrc6000Task);
+	watchdogTaskStart(&beepTask);
+	watchdogTaskStart(&mainTask);
 
 	watchdogRun(true);
 	displaySetDisplayPowerMode(true);
@@ -816,6 +818,9 @@ void mainTaskFunction(void *data)
 	bool wasRestoringDefaultsettings = false;
 	int *quickkeyPushedMenuMelody = NULL;
 	bool spiFlashInitialized = false;
+	bool backgroundInitIsDone = false;
+
+	bootTraceStart();
 
 	clockManagerInit();
 	// Init SPI
@@ -838,7 +843,15 @@ void mainTaskFunction(void *data)
 	keyboardInit();
 	rotarySwitchInit();
 	pitInit();
+	crcInit();
+	bootTraceMark("HW_INIT");
+
 	spiFlashInitialized = SPI_Flash_init();
+	if (spiFlashInitialized)
+	{
+		languagesInit();
+	}
+	bootTraceMark("FLASH");
 
 	buttonsCheckButtonsEvent(&buttons, &button_event, false);// Read button state and event
 
@@ -852,6 +865,7 @@ void mainTaskFunction(void *data)
 	{
 		wasRestoringDefaultsettings = settingsLoadSettings();
 	}
+	bootTraceMark("SETTINGS");
 
 	// Set default time to 01/01/BUILD_YEAR
 	timeAndDate.tm_sec 	= 0;
@@ -864,6 +878,7 @@ void mainTaskFunction(void *data)
 
 	gpioInitDisplay();
 	displayInit(settingsIsOptionBitSet(BIT_INVERSE_VIDEO));
+	bootTraceMark("DISPLAY");
 
 	// We shouldn't go further if calibration related initialization has failed
 	if ((spiFlashInitialized == false) || (calibrationInit() == false) || (calibrationCheckAndCopyToCommonLocation(false) == false))
@@ -872,6 +887,7 @@ void mainTaskFunction(void *data)
 		USB_DeviceApplicationInit();
 		die(true, false, false);
 	}
+	bootTraceMark("CALIB");
 
 	// Check if DMR codec is available
 	uiDataGlobal.dmrDisabled = !codecIsAvailable();
@@ -888,6 +904,7 @@ void mainTaskFunction(void *data)
 
 	// VOX init
 	voxInit();
+	bootTraceMark("RADIO");
 
 	// Small startup delay after initialization to stabilize system
 	//  vTaskDelay((500 / portTICK_PERIOD_MS));
@@ -896,7 +913,6 @@ void mainTaskFunction(void *data)
 	int batteryLowRetries = 100;
 	while((batteryLowRetries-- > 0) && batteryLastReadingIsCritical())
 	{
-		adcTriggerConversion(1);
 		vTaskDelay((1 / portTICK_PERIOD_MS));
 	}
 
@@ -908,8 +924,15 @@ void mainTaskFunction(void *data)
 #endif
 		die(false, false, false);
 	}
+	bootTraceMark("BATTERY");
 
 	HRC6000InitTask();
+	if (codecInitTask() == false)
+	{
+		showErrorMessage("CODEC TASK ERROR");
+		USB_DeviceApplicationInit();
+		die(true, false, false);
+	}
 
 	menuRadioInfosInit(); // Initialize circular buffer
 	batteryUpdate();
@@ -920,6 +943,9 @@ void mainTaskFunction(void *data)
 	SEGGER_RTT_ConfigUpBuffer(0, NULL, NULL, 0, SEGGER_RTT_MODE_NO_BLOCK_TRIM);
 	SEGGER_RTT_printf(0,"Segger RTT initialised\n");
 	SEGGER_RTT_printf(0,"Core Clock = %dHz \n", CLOCK_GetFreq(kCLOCK_CoreSysClk));
+#if defined(DISPLAY_BENCHMARK) && ! defined(PLATFORM_GD77S)
+	SEGGER_RTT_printf(0,"Text rendering = %d cycles/screen\n", displayBenchmarkTextRendering(100));
+#endif
 #endif
 
 	// Clear boot melody and image
@@ -932,10 +958,11 @@ void mainTaskFunction(void *data)
 		settingsEraseCustomContent();
 	}
 
+	// The contacts and DMR IDs caches aren't needed by the first screen, they are built in the background (see the main loop)
 	lastheardInitList();
 	codeplugInitCaches();
-	dmrIDCacheInit();
 	voicePromptsCacheInit();
+	bootTraceMark("CACHES");
 
 	if (wasRestoringDefaultsettings || ((keyboardRead() & SCAN_HASH) == SCAN_HASH))
 	{
@@ -992,11 +1019,13 @@ void mainTaskFunction(void *data)
 #endif
 
 	menuSystemInit();
+	bootTraceMark("MENU");
 
 	// Now that init is complete, change back to Run mode before initialisating the USB.
 	// As at the moment we don't have a way to change clock rates and maintain the USB connection
 	clockManagerSetRunMode(kAPP_PowerModeRun, CLOCK_MANAGER_SPEED_RUN);
 	USB_DeviceApplicationInit();
+	bootTraceMark("USB");
 
 	// Reset buttons/key states in case some where pressed while booting.
 	button_event = EVENT_BUTTON_NONE;
@@ -1015,12 +1044,31 @@ void mainTaskFunction(void *data)
 	{
 		if (timer_maintask == 0)
 		{
-			mainTask.AliveCount = TASK_FLAGGED_ALIVE;
+			clockManagerGovernorBusyBegin();
+
+			watchdogTaskAlive(&mainTask);
 
 			batteryUpdate();
 
 			tick_com_request();
 
+			clockManagerGovernorTick();
+
+			// Background boot initialization: build the caches a few entries at each tick
+			if (backgroundInitIsDone == false)
+			{
+				if (codeplugContactsCacheBuildStep(BACKGROUND_INIT_CONTACTS_PER_TICK))
+				{
+					if (dmrIDCacheIsReady() == false)
+					{
+						dmrIDCacheInit();
+					}
+
+					bootTraceMark("BG_READY");
+					backgroundInitIsDone = true;
+				}
+			}
+
 			handleTimerCallbacks();
 
 			keyboardCheckKeyEvent(&keys, &key_event); // Read keyboard state and event
@@ -1779,6 +1827,8 @@ void mainTaskFunction(void *data)
 #endif
 
 			timer_maintask = 1; // Reset PIT Counter
+
+			clockManagerGovernorBusyEnd();
 		}
 
 		if (!trxTransmissionEnabled && !trxIsTransmitting)
@@ -1799,7 +1849,7 @@ void mainTaskFunction(void *data)
 					switch(trxGetMode())
 					{
 						case RADIO_MODE_ANALOG:
-							trxReadRSSIAndNoise(false);
+							trxRadioStatusSamplerTick();
 
 							if (melody_play == NULL)
 							{
@@ -1809,7 +1859,7 @@ void mainTaskFunction(void *data)
 						case RADIO_MODE_DIGITAL:
 							if (slotState == DMR_STATE_IDLE)
 							{
-								trxReadRSSIAndNoise(false);
+								trxRadioStatusSamplerTick();
 
 								hasSignal = trxCheckDigitalSquelch();
 							}
@@ -1817,7 +1867,7 @@ void mainTaskFunction(void *data)
 							{
 								if (ticksTimerHasExpired((ticksTimer_t *)&readDMRRSSITimer))
 								{
-									trxReadRSSIAndNoise(false);
+									trxRadioStatusSamplerTick();
 									ticksTimerStart((ticksTimer_t *)&readDMRRSSITimer, 10000); // hold of for a very long time
 								}
 								hasSignal = true;
@@ -39,6 +39,9 @@
 #include "hardware/SPI_Flash.h"
 #include "user_interface/uiLocalisation.h"
 #include "functions/rxPowerSaving.h"
+#include "interfaces/crc.h"
+#include "functions/bootTrace.h"
+#include "interfaces/clockManager.h"
 
 //#define LOOKUP_ENABLED 1
 
@@ -52,6 +55,7 @@ volatile int comRecvMMDVMIndexIn = 0;
 volatile int comRecvMMDVMIndexOut = 0;
 volatile int comRecvMMDVMFrameCount = 0;
 static bool flashingDMRIDs = false;
+static bool flashingCustomData = false;
 static bool channelsRewritten = false;
 
 bool isCompressingAMBE = false;
@@ -97,8 +101,76 @@ enum CPS_ACCESS_AREA { 	CPS_ACCESS_FLASH = 1,
 						CPS_ACCESS_WAV_BUFFER = 7,
 						CPS_COMPRESS_AND_ACCESS_AMBE_BUFFER = 8,
 						CPS_ACCESS_RADIO_INFO = 9,
+						CPS_ACCESS_FLASH_CRC_MANIFEST = 10,
+						CPS_ACCESS_EEPROM_CRC_MANIFEST = 11,
+						CPS_ACCESS_BOOT_TRACE = 12,
+						CPS_ACCESS_CLOCK_STATS = 13,
+						CPS_ACCESS_WATCHDOG_STATS = 14,
+						CPS_ACCESS_SPI_STATS = 15,
+						CPS_ACCESS_CODEC_STATS = 16,
 						};
 
+// CRC manifests: one CRC32 (little endian) per Flash sector, or per EEPROM page.
+// Address is the start (byte) address, length the number of sectors/pages.
+#define CPS_CRC_MANIFEST_FLASH_SECTOR_SIZE  4096
+#define CPS_CRC_MANIFEST_EEPROM_PAGE_SIZE    128
+#define CPS_CRC_MANIFEST_MAX_ENTRIES          64 // Keeps each request short (256KB of Flash, or 8KB of EEPROM)
+
+// CRC32 of a Flash or EEPROM area
+static bool cpsComputeCRC32(bool fromFlash, uint32_t address, uint32_t length, uint32_t *crc)
+{
+	static uint32_t buffer[64];
+	uint32_t chunkLength;
+	crcContext_t context;
+
+	crcStart(&context, CRC_TYPE_CRC32);
+
+	while (length > 0)
+	{
+		chunkLength = SAFE_MIN(length, sizeof(buffer));
+
+		if ((fromFlash ? SPI_Flash_read(address, (uint8_t *)buffer, chunkLength) : EEPROM_Read(address, (uint8_t *)buffer, chunkLength)) == false)
+		{
+			return false;
+		}
+
+		crcUpdate(&context, (uint8_t *)buffer, chunkLength);
+
+		address += chunkLength;
+		length -= chunkLength;
+	}
+
+	*crc = crcFinish(&context);
+
+	return true;
+}
+
+static bool cpsBuildCRCManifest(bool fromFlash, uint32_t address, uint32_t *count)
+{
+	uint32_t blockSize = (fromFlash ? CPS_CRC_MANIFEST_FLASH_SECTOR_SIZE : CPS_CRC_MANIFEST_EEPROM_PAGE_SIZE);
+	uint32_t crc;
+
+	*count = SAFE_MIN(*count, (uint32_t)CPS_CRC_MANIFEST_MAX_ENTRIES);
+
+	for (uint32_t i = 0; i < *count; i++)
+	{
+		if (cpsComputeCRC32(fromFlash, (address + (i * blockSize)), blockSize, &crc) == false)
+		{
+			return false;
+		}
+
+		// Little endian
+		usbComSendBuf[3 + (i * 4) + 0] = (crc >> 0) & 0xFF;
+		usbComSendBuf[3 + (i * 4) + 1] = (crc >> 8) & 0xFF;
+		usbComSendBuf[3 + (i * 4) + 2] = (crc >> 16) & 0xFF;
+		usbComSendBuf[3 + (i * 4) + 3] = (crc >> 24) & 0xFF;
+	}
+
+	*count *= sizeof(uint32_t);
+
+	return true;
+}
+
 static void cpsHandleReadCommand(void)
 {
 	uint32_t address = (com_requestbuffer[2] << 24) + (com_requestbuffer[3] << 16) + (com_requestbuffer[4] << 8) + (com_requestbuffer[5] << 0);
@@ -176,6 +248,42 @@ static void cpsHandleReadCommand(void)
 				result = true;
 			}
 			break;
+		case CPS_ACCESS_FLASH_CRC_MANIFEST:
+			result = cpsBuildCRCManifest(true, address, &length);
+			break;
+		case CPS_ACCESS_EEPROM_CRC_MANIFEST:
+			result = cpsBuildCRCManifest(false, address, &length);
+			break;
+		case CPS_ACCESS_BOOT_TRACE:
+			length = sizeof(bootTrace_t);
+			memcpy(&usbComSendBuf[3], &bootTrace, length);
+			result = true;
+			break;
+		case CPS_ACCESS_CLOCK_STATS:
+			length = sizeof(clockManagerStats_t);
+			memcpy(&usbComSendBuf[3], &clockManagerStats, length);
+			result = true;
+			break;
+		case CPS_ACCESS_WATCHDOG_STATS:
+			{
+				static watchdogReport_t report;
+
+				watchdogGetReport(&report);
+				length = sizeof(watchdogReport_t);
+				memcpy(&usbComSendBuf[3], &report, length);
+				result = true;
+			}
+			break;
+		case CPS_ACCESS_SPI_STATS:
+			length = sizeof(spiBusStats);
+			memcpy(&usbComSendBuf[3], spiBusStats, length);
+			result = true;
+			break;
+		case CPS_ACCESS_CODEC_STATS:
+			length = sizeof(codecStats_t);
+			memcpy(&usbComSendBuf[3], &codecStats, length);
+			result = true;
+			break;
 	}
 
 	if (result)
@@ -211,6 +319,10 @@ static void cpsHandleWriteCommand(void)
 				{
 					flashingDMRIDs = true;
 				}
+				else if ((sector * 4096) < 0x10000) // OpenGD77 custom data (images, beeps, language packs...)
+				{
+					flashingCustomData = true;
+				}
 
 				ok = SPI_Flash_read(sector * 4096, SPI_Flash_sectorbuffer, 4096);
 			}
@@ -252,6 +364,8 @@ static void cpsHandleWriteCommand(void)
 		case 3:
 			if (sector >= 0)
 			{
+				codeplugChannelCacheInvalidate();// The CPS may be writing channels data
+
 				ok = SPI_Flash_eraseSector(sector * 4096);
 				if (ok)
 				{
@@ -264,6 +378,15 @@ static void cpsHandleWriteCommand(void)
 							break;
 						}
 					}
+
+					// Verify the sector, the CPS will get an error if the Flash content doesn't match
+					if (ok)
+					{
+						uint32_t crc;
+
+						ok = (cpsComputeCRC32(true, (sector * 4096), 4096, &crc) &&
+								(crc == crcCompute(CRC_TYPE_CRC32, SPI_Flash_sectorbuffer, 4096)));
+					}
 				}
 
 				sector = -1;
@@ -280,6 +403,8 @@ static void cpsHandleWriteCommand(void)
 					channelsRewritten = true;
 				}
 
+				codeplugChannelCacheInvalidate();// The CPS may be writing channels data
+
 				if (length > (COM_REQUESTBUFFER_SIZE - 8))
 				{
 					length = (COM_REQUESTBUFFER_SIZE - 8);
@@ -416,6 +541,18 @@ static void cpsHandleCommand(void)
 				dmrIDCacheInit();
 				flashingDMRIDs = false;
 			}
+			if (flashingCustomData)
+			{
+				// Language packs may have been added, removed or moved. As on boot, the setting is kept if the pack is missing
+				languagesInit();
+				int languageIndex = languagesGetIndexFromSetting(nonVolatileSettings.languageIndex);
+				if ((languageIndex == -1) || (languagesSetCurrent(languageIndex) == false))
+				{
+					languagesSetCurrent(0);
+				}
+				menuSystemLanguageHasChanged();
+				flashingCustomData = false;
+			}
 			isCompressingAMBE = false;
 			rxPowerSavingSetLevel(nonVolatileSettings.ecoLevel);
 			uiCPSUpdate(CPS2UI_COMMAND_END, 0, 0, FONT_SIZE_1, TEXT_ALIGN_LEFT, 0, NULL);
@@ -58,6 +58,12 @@ static uint32_t contactCallType;
 static contactListState_t contactListDisplayState;
 static contactListState_t contactListOverrideState = MENU_CONTACT_LIST_DISPLAY;
 static int menuContactListTimeout; // Action result screen autohide timeout (or it will instantly disappear if RED or GREEN is pressed)
+
+#define CONTACT_LIST_TYPE_AHEAD_TIMEOUT_MS  1500 // A key pressed after this delay starts a new name prefix
+
+static char typeAheadKeys[CODEPLUG_CONTACTS_NAME_KEYS_MAX];
+static int typeAheadLength = 0;
+static uint32_t typeAheadLastKeyTime = 0;
 static menuStatus_t menuContactListExitCode = MENU_STATUS_SUCCESS;
 static menuStatus_t menuContactListSubMenuExitCode = MENU_STATUS_SUCCESS;
 
@@ -80,6 +86,7 @@ static void overrideWithSelectedContact(void)
 
 static void reloadContactList(contactListContactType_t type)
 {
+	typeAheadLength = 0;
 	menuDataGlobal.numItems = (type == MENU_CONTACT_LIST_CONTACT_DIGITAL) ? codeplugContactsGetCount(contactCallType) : codeplugDTMFContactsGetCount();
 
 	if (menuDataGlobal.numItems > 0)
@@ -216,6 +223,13 @@ static void updateScreen(bool isFirstRun)
 			}
 			else
 			{
+				if (contactListType == MENU_CONTACT_LIST_CONTACT_DIGITAL)
+				{
+					// Read the displayed contacts in one go
+					mNum = menuGetMenuOffset(menuDataGlobal.numItems, -((MENU_MAX_DISPLAYED_ENTRIES - 1) / 2));
+					codeplugContactsPrefetchWindowInType(((mNum < 0) ? 1 : (mNum + 1)), MENU_MAX_DISPLAYED_ENTRIES, contactCallType);
+				}
+
 				for(int i = 1 - ((MENU_MAX_DISPLAYED_ENTRIES - 1) / 2) - 1; i <= (MENU_MAX_DISPLAYED_ENTRIES - ((MENU_MAX_DISPLAYED_ENTRIES - 1) / 2) - 1); i++)
 				{
 					mNum = menuGetMenuOffset(menuDataGlobal.numItems, i);
@@ -279,6 +293,36 @@ static void updateScreen(bool isFirstRun)
 	displayRender();
 }
 
+// Digital contacts type-ahead: the number keys spell the start of the name, like in the alpha entry (2 for ABC, 3 for DEF...),
+// the list jumps to the first matching contact.
+static void typeAheadHandleKey(uiEvent_t *ev)
+{
+	int number;
+
+	if (((ev->time - typeAheadLastKeyTime) > CONTACT_LIST_TYPE_AHEAD_TIMEOUT_MS) || (typeAheadLength >= CODEPLUG_CONTACTS_NAME_KEYS_MAX))
+	{
+		typeAheadLength = 0;
+	}
+
+	typeAheadLastKeyTime = ev->time;
+	typeAheadKeys[typeAheadLength++] = ev->keys.key;
+
+	number = codeplugContactsFindNumberByNamePrefixInType(typeAheadKeys, typeAheadLength, contactCallType);
+	if (number > 0)
+	{
+		menuDataGlobal.currentItemIndex = number - 1;
+		uiDataGlobal.currentSelectedContactIndex = codeplugContactGetDataForNumberInType(number, contactCallType, &contactListContactData);
+		voicePromptsInit();
+		updateScreen(false);
+		menuContactListExitCode |= MENU_STATUS_LIST_TYPE;
+	}
+	else
+	{
+		typeAheadLength--; // No match, the key is ignored
+		menuContactListExitCode |= MENU_STATUS_ERROR;
+	}
+}
+
 static void handleEvent(uiEvent_t *ev)
 {
 	if (ev->events & BUTTON_EVENT)
@@ -406,6 +450,12 @@ static void handleEvent(uiEvent_t *ev)
 				return;
 			}
 
+			if ((contactListType == MENU_CONTACT_LIST_CONTACT_DIGITAL) && (menuDataGlobal.numItems > 0) && KEYCHECK_SHORTUP_NUMBER(ev->keys))
+			{
+				typeAheadHandleKey(ev);
+				return;
+			}
+
 			break;
 
 		case MENU_CONTACT_LIST_CONFIRM:
@@ -192,7 +192,7 @@ menuStatus_t menuLanguage(uiEvent_t *ev, bool isFirstRun)
 {
 	if (isFirstRun)
 	{
-		menuDataGlobal.numItems = NUM_LANGUAGES;
+		menuDataGlobal.numItems = languagesGetCount();
 
 		voicePromptsInit();
 		voicePromptsAppendPrompt(PROMPT_SILENCE);
@@ -224,7 +224,7 @@ static void updateScreen(bool isFirstRun)
 
 	for(int i = 1 - ((MENU_MAX_DISPLAYED_ENTRIES - 1) / 2) - 1; i <= (MENU_MAX_DISPLAYED_ENTRIES - ((MENU_MAX_DISPLAYED_ENTRIES - 1) / 2) - 1); i++)
 	{
-		mNum = menuGetMenuOffset(NUM_LANGUAGES, i);
+		mNum = menuGetMenuOffset(languagesGetCount(), i);
 		if (mNum == MENU_OFFSET_BEFORE_FIRST_ENTRY)
 		{
 			continue;
@@ -234,9 +234,9 @@ static void updateScreen(bool isFirstRun)
 			break;
 		}
 
-		if (mNum < NUM_LANGUAGES)
+		if (mNum < languagesGetCount())
 		{
-			menuDisplayEntry(i, mNum, (char *)languages[LANGUAGE_DISPLAY_ORDER[mNum]].LANGUAGE_NAME);
+			menuDisplayEntry(i, mNum, (char *)languagesGetName(mNum));
 
 			if (i == 0)
 			{
@@ -244,7 +244,7 @@ static void updateScreen(bool isFirstRun)
 				{
 					char buffer[17];
 
-					snprintf(buffer, 17, "%s", (char *)languages[LANGUAGE_DISPLAY_ORDER[mNum]].LANGUAGE_NAME);
+					snprintf(buffer, 17, "%s", (char *)languagesGetName(mNum));
 
 					clearNonLatinChar((uint8_t *)&buffer[0]);
 
@@ -274,11 +274,11 @@ static void handleEvent(uiEvent_t *ev)
 	}
 	if (ev->events & FUNCTION_EVENT)
 	{
-		if ((QUICKKEY_TYPE(ev->function) == QUICKKEY_MENU) && (QUICKKEY_ENTRYID(ev->function) < NUM_LANGUAGES))
+		if ((QUICKKEY_TYPE(ev->function) == QUICKKEY_MENU) && (QUICKKEY_ENTRYID(ev->function) < languagesGetCount()))
 		{
 			menuDataGlobal.currentItemIndex = QUICKKEY_ENTRYID(ev->function);
-			settingsSet(nonVolatileSettings.languageIndex, menuDataGlobal.currentItemIndex);
-			currentLanguage = &languages[menuDataGlobal.currentItemIndex];
+			settingsSet(nonVolatileSettings.languageIndex, languagesGetSetting(menuDataGlobal.currentItemIndex));
+			languagesSetCurrent(menuDataGlobal.currentItemIndex);
 			settingsSaveIfNeeded(true);
 			menuSystemLanguageHasChanged();
 			menuSystemPopAllAndDisplayRootMenu();
@@ -288,20 +288,20 @@ static void handleEvent(uiEvent_t *ev)
 
 	if (KEYCHECK_PRESS(ev->keys, KEY_DOWN) && (menuDataGlobal.numItems != 0))
 	{
-		menuSystemMenuIncrement(&menuDataGlobal.currentItemIndex, NUM_LANGUAGES);
+		menuSystemMenuIncrement(&menuDataGlobal.currentItemIndex, languagesGetCount());
 		updateScreen(false);
 		menuLanguageExitCode |= MENU_STATUS_LIST_TYPE;
 	}
 	else if (KEYCHECK_PRESS(ev->keys, KEY_UP))
 	{
-		menuSystemMenuDecrement(&menuDataGlobal.currentItemIndex, NUM_LANGUAGES);
+		menuSystemMenuDecrement(&menuDataGlobal.currentItemIndex, languagesGetCount());
 		updateScreen(false);
 		menuLanguageExitCode |= MENU_STATUS_LIST_TYPE;
 	}
 	else if (KEYCHECK_SHORTUP(ev->keys, KEY_GREEN))
 	{
-		settingsSet(nonVolatileSettings.languageIndex, (uint8_t) LANGUAGE_DISPLAY_ORDER[menuDataGlobal.currentItemIndex]);
-		currentLanguage = &languages[LANGUAGE_DISPLAY_ORDER[menuDataGlobal.currentItemIndex]];
+		settingsSet(nonVolatileSettings.languageIndex, languagesGetSetting(menuDataGlobal.currentItemIndex));
+		languagesSetCurrent(menuDataGlobal.currentItemIndex);
 		settingsSaveIfNeeded(true);
 		menuSystemLanguageHasChanged();
 		menuSystemPopAllAndDisplayRootMenu();
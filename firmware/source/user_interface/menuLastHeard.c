@@ -38,7 +38,7 @@ static LinkItem_t *selectedItem;
 static int lastHeardCount;
 static int firstDisplayed;
 
-static void displayTalkerAlias(uint8_t y, char *text, uint32_t time, uint32_t now, uint32_t TGorPC, size_t maxLen, bool displayDetails, bool itemIsSelected, bool isFirstRun, LinkItem_t * item);
+static void displayTalkerAlias(uint8_t y, const char *text, uint32_t time, uint32_t now, uint32_t TGorPC, size_t maxLen, bool displayDetails, bool itemIsSelected, bool isFirstRun, LinkItem_t * item);
 static void promptsInit(bool isFirstRun);
 
 menuStatus_t menuLastHeard(uiEvent_t *ev, bool isFirstRun)
@@ -161,14 +161,14 @@ void menuLastHeardUpdateScreen(bool showTitleOrHeader, bool displayDetails, bool
 				case CONTACT_DISPLAY_PRIO_CC_DB_TA:
 				case CONTACT_DISPLAY_PRIO_DB_CC_TA:
 					// No contact found in codeplug and DMRIDs, use TA as fallback, if any.
-					if ((strncmp(item->contact, "ID:", 3) == 0) && (item->talkerAlias[0] != 0x00))
+					if ((strncmp(lastheardGetContact(item), "ID:", 3) == 0) && (item->talkerAlias != 0))
 					{
 						displayTA = true;
 					}
 					break;
 				case CONTACT_DISPLAY_PRIO_TA_CC_DB:
 				case CONTACT_DISPLAY_PRIO_TA_DB_CC:
-					if (item->talkerAlias[0] != 0x00)
+					if (item->talkerAlias != 0)
 					{
 						displayTA = true;
 					}
@@ -177,11 +177,11 @@ void menuLastHeardUpdateScreen(bool showTitleOrHeader, bool displayDetails, bool
 
 			if (displayTA)
 			{
-				displayTalkerAlias(16 + (numDisplayed * MENU_ENTRY_HEIGHT) + LH_ENTRY_V_OFFSET, item->talkerAlias, item->time, now, item->talkGroupOrPcId, 32, displayDetails, invertColour, isFirstRun, item);
+				displayTalkerAlias(16 + (numDisplayed * MENU_ENTRY_HEIGHT) + LH_ENTRY_V_OFFSET, lastheardGetTalkerAlias(item), item->time, now, item->talkGroupOrPcId, LASTHEARD_TALKER_ALIAS_LENGTH, displayDetails, invertColour, isFirstRun, item);
 			}
 			else
 			{
-				displayTalkerAlias(16 + (numDisplayed * MENU_ENTRY_HEIGHT) + LH_ENTRY_V_OFFSET, item->contact, item->time, now, item->talkGroupOrPcId, MAX_DMR_ID_CONTACT_TEXT_LENGTH, displayDetails, invertColour, isFirstRun, item);
+				displayTalkerAlias(16 + (numDisplayed * MENU_ENTRY_HEIGHT) + LH_ENTRY_V_OFFSET, lastheardGetContact(item), item->time, now, item->talkGroupOrPcId, MAX_DMR_ID_CONTACT_TEXT_LENGTH, displayDetails, invertColour, isFirstRun, item);
 			}
 
 			numDisplayed++;
@@ -375,7 +375,7 @@ static void promptsInit(bool isFirstRun)
 	}
 }
 
-static void displayTalkerAlias(uint8_t y, char *text, uint32_t time, uint32_t now, uint32_t TGorPC, size_t maxLen, bool displayDetails, bool itemIsSelected, bool isFirstRun, LinkItem_t * item)
+static void displayTalkerAlias(uint8_t y, const char *text, uint32_t time, uint32_t now, uint32_t TGorPC, size_t maxLen, bool displayDetails, bool itemIsSelected, bool isFirstRun, LinkItem_t * item)
 {
 	char timeBuffer[SCREEN_LINE_BUFFER_SIZE];
 	uint32_t tg = (TGorPC & 0xFFFFFF);
@@ -455,7 +455,7 @@ static void displayTalkerAlias(uint8_t y, char *text, uint32_t time, uint32_t no
 						memcpy(buffer, text, cpos);
 						buffer[cpos] = 0;
 
-						memcpy(nameBuf, (text + cpos + 1), strlen(text) - cpos - 1);
+						memcpy(nameBuf, (text + cpos + 1), SAFE_MIN((strlen(text) - cpos - 1), (SCREEN_LINE_BUFFER_SIZE - 1)));
 						nameBuf[(SCREEN_LINE_BUFFER_SIZE - 1)] = 0;
 
 						snprintf(outputBuf, 17, "%s %s", chomp(buffer), chomp(nameBuf));
@@ -467,8 +467,10 @@ static void displayTalkerAlias(uint8_t y, char *text, uint32_t time, uint32_t no
 			else
 			{
 				// No space found, use a chainsaw
-				memcpy(buffer, text, (SCREEN_LINE_BUFFER_SIZE - 1));
-				buffer[(SCREEN_LINE_BUFFER_SIZE - 1)] = 0;
+				size_t textLength = strnlen(text, (SCREEN_LINE_BUFFER_SIZE - 1));// The text is stored in the last heard strings pool, don't copy past its end
+
+				memcpy(buffer, text, textLength);
+				buffer[textLength] = 0;
 
 				displayPrintCore(0, y, chomp(buffer), FONT_SIZE_3, TEXT_ALIGN_CENTER, itemIsSelected);
 			}
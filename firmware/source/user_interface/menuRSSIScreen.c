@@ -172,7 +172,7 @@ static void updateScreen(bool forceRedraw, bool isFirstRun)
 	displayPrintCentered(DISPLAY_Y_POS_RSSI_VALUE, buffer, FONT_SIZE_3);
 
 #if 0 // DEBUG
-	sprintf(buffer, "%d", trxRxSignal);
+	sprintf(buffer, "%d", trxRadioStatusGet()->rssi);
 	displayFillRect((DISPLAY_SIZE_X - (4 * 8)), DISPLAY_Y_POS_RSSI_VALUE, (4 * 8), 8, true);
 	ucPrintCore((DISPLAY_SIZE_X - ((strlen(buffer) + 1) * 8)), DISPLAY_Y_POS_RSSI_VALUE, buffer, FONT_SIZE_2, TEXT_ALIGN_RIGHT, false);
 #endif
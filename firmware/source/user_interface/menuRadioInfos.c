@@ -222,8 +222,8 @@ menuStatus_t menuRadioInfos(uiEvent_t *ev, bool isFirstRun)
 
 void buildMaidenHead(char *maidenheadBuffer,uint32_t intPartLat,uint32_t decPartLat,bool isSouthern,uint32_t intPartLon,uint32_t decPartLon, bool isWestern)
 {
-	double latitude = intPartLat + (((double)decPartLat) /  LOCATION_DECIMAL_PART_MULIPLIER);
-	double longitude = intPartLon + (((double)decPartLon) / LOCATION_DECIMAL_PART_MULIPLIER);
+	int32_t latitude = (intPartLat * 1000000) + (decPartLat * (1000000 / LOCATION_DECIMAL_PART_MULIPLIER));
+	int32_t longitude = (intPartLon * 1000000) + (decPartLon * (1000000 / LOCATION_DECIMAL_PART_MULIPLIER));
 
 	if (isSouthern)
 	{
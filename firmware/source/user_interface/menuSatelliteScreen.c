@@ -53,14 +53,15 @@ static const uint32_t ALARM_OFFSET_SECS = 60;
 
 enum { SATELLITE_SCREEN_ALL_PREDICTIONS_LIST, SATELLITE_SCREEN_SELECTED_SATELLITE, SATELLITE_SCREEN_SELECTED_SATELLITE_POLAR, SATELLITE_SCREEN_SELECTED_SATELLITE_PREDICTION,  NUM_SATELLITE_SCREEN_ITEMS };//
 
+static menuStatus_t menuSatelliteScreenTick(uiEvent_t *ev, bool isFirstRun);
 static void handleEvent(uiEvent_t *ev);
 static void updateScreen(uiEvent_t *ev, bool firstRun, bool announceVP);
-static bool calculatePredictionsForSatelliteIndex(int satelliteIndex);
 
 static void loadKeps(void);
 static int menuSatelliteFindNextSatellite(void);
 static void selectSatellite(uint32_t selectedSatellite);
 static void calculateActiveSatelliteData(bool forceFrequencyUpdate);
+static void polarPlotPosition(int azimuth, int elevation, int maxRadius, float *x, float *y);
 
 static bool hasSatelliteKeps = false;
 static bool satelliteVisible = false;
@@ -71,7 +72,6 @@ static uint32_t nextCalculationTime = 0;
 static uint32_t menuSatelliteScreenNextUpdateTime;
 static char azelBuffer[SCREEN_LINE_BUFFER_SIZE];
 static uint32_t numSatellitesLoaded;
-static predictionStateMachineData_t currentPrediction;
 static int currentlyDisplayedListPosition = 0;
 static int predictionsListNumSatellitePassesDisplayed = 0;
 static int rxIntPart;
@@ -80,22 +80,29 @@ static int txIntPart;
 static int txDecPart;
 static int predictionsListSelectedSatellite;
 static satelliteResults_t currentSatelliteResults;
-static int currentlyPredictingSatellite = 0;
 static int numTotalSatellitesPredicted = 0;
-static satelliteData_t *predictingSat;
 static uint32_t nextAlarmBeepTime = 0;
 static bool hasRecalculated;
 static bool hasSelectedSatellite = false;
 
 menuStatus_t menuSatelliteScreen(uiEvent_t *ev, bool isFirstRun)
+{
+	menuStatus_t status;
+
+	// The prediction task updates the passes and the pass track, which are read all over this screen
+	satellitePredictionTaskLock();
+	status = menuSatelliteScreenTick(ev, isFirstRun);
+	satellitePredictionTaskUnlock();
+
+	return status;
+}
+
+static menuStatus_t menuSatelliteScreenTick(uiEvent_t *ev, bool isFirstRun)
 {
 	if (isFirstRun)
 	{
 		struct tm buildDateTime;
 		predictionsListSelectedSatellite = 0;
-		currentlyPredictingSatellite = 0;
-
-		currentPrediction.state = PREDICTION_STATE_NONE;
 		currentlyDisplayedListPosition = 0;
 
 		if (!hasSelectedSatellite)
@@ -134,6 +141,7 @@ menuStatus_t menuSatelliteScreen(uiEvent_t *ev, bool isFirstRun)
 			if (!hasSatelliteKeps)
 			{
 				loadKeps();
+				satellitePredictionTaskReset(numSatellitesLoaded);
 			}
 
 			if (hasSatelliteKeps) // No Keps data, no computation
@@ -160,6 +168,13 @@ menuStatus_t menuSatelliteScreen(uiEvent_t *ev, bool isFirstRun)
 		currentActiveSatellite = &satelliteDataNative[uiDataGlobal.SatelliteAndAlarmData.currentSatellite];
 		menuSatelliteScreenNextUpdateTime = ev->time  - 1;
 
+		if (hasSatelliteKeps)
+		{
+			// Predictions are run in the background by the satellite task
+			satellitePredictionTaskStart();
+			numTotalSatellitesPredicted = satellitePredictionTaskGetNumPredicted();
+		}
+
 		calculateActiveSatelliteData(true);
 		nextCalculationTime = ev->time + 1000; // 1000 milliseconds
 
@@ -169,26 +184,27 @@ menuStatus_t menuSatelliteScreen(uiEvent_t *ev, bool isFirstRun)
 	{
 		if (hasSatelliteKeps)
 		{
+			satellitePredictionTaskKeepAlive();
+
 			if (numTotalSatellitesPredicted == 0)
 			{
-				clockManagerSetRunMode(kAPP_PowerModeHsrun,CLOCK_MANAGER_SPEED_HS_RUN);
+				clockManagerLeaseFullSpeed(CLOCK_MANAGER_LEASE_SATELLITE, 0);
 			}
 
-			while(!calculatePredictionsForSatelliteIndex(currentlyPredictingSatellite))
+			if (satellitePredictionTaskHasUpdate())
 			{
-				vTaskDelay((0 / portTICK_PERIOD_MS));
-			}
-
-			predictingSat = &satelliteDataNative[currentlyPredictingSatellite];
+				uint32_t numPredicted = satellitePredictionTaskGetNumPredicted();
 
-			if (numTotalSatellitesPredicted < numSatellitesLoaded)
-			{
-				if (predictingSat->predictions.passes[predictingSat->predictions.numPassBeingPredicted].valid == PREDICTION_RESULT_LIMIT)
+				if (numPredicted != numTotalSatellitesPredicted)
 				{
-					currentlyPredictingSatellite++;
-					numTotalSatellitesPredicted++;
+					if (numPredicted < numTotalSatellitesPredicted)
+					{
+						currentlyDisplayedListPosition = 0;// Reset the list position, as there may be less satellites after the passes for this satellite are re-calculated
+					}
 
+					numTotalSatellitesPredicted = numPredicted;
 					updateScreen(ev, false, true);
+
 					if (numTotalSatellitesPredicted == numSatellitesLoaded)
 					{
 						if (settingsIsOptionBitSet(BIT_SATELLITE_MANUAL_AUTO))
@@ -200,15 +216,13 @@ menuStatus_t menuSatelliteScreen(uiEvent_t *ev, bool isFirstRun)
 								selectSatellite(foundSatellite);
 							}
 						}
-						clockManagerSetRunMode(kAPP_PowerModeHsrun,CLOCK_MANAGER_SPEED_RUN);
+						clockManagerLeaseRelease(CLOCK_MANAGER_LEASE_SATELLITE);
 					}
 				}
-			}
-			else
-			{
-				// keep sweeping in case any of the satellites goes LOS and the predictions need to be re-run.
-				currentlyPredictingSatellite++;
-				currentlyPredictingSatellite %= numSatellitesLoaded;
+				else if (displayMode == SATELLITE_SCREEN_ALL_PREDICTIONS_LIST)
+				{
+					menuSatelliteScreenNextUpdateTime = 1;// satellite visibility has changed
+				}
 			}
 
 			if (ev->time > nextCalculationTime)
@@ -417,14 +431,15 @@ static void updateScreen(uiEvent_t *ev, bool firstRun, bool announceVP)
 #else
 				const int MAX_RADIUS = ((DISPLAY_SIZE_Y / 2) - 4);
 #endif
-				float az, elFactor, s,c, lastX = 0, lastY = 0,x,y;
-				satelliteResults_t results;
+				float lastX = 0, lastY = 0,x,y;
+				const satelliteTrack_t *track;
 
 				time_t_custom displayedPassTimeDiff = displayedPredictionPass->satelliteAOS - uiDataGlobal.dateTimeSecs;
 
 				if (displayedPredictionPass->valid == PREDICTION_RESULT_OK)
 				{
 					volatile uint32_t startTime;
+					bool isFirstPoint = true;
 #define POLAR_GRAPHICS_X_OFFSET  24
 
 					if(hasRecalculated || announceVP)
@@ -540,27 +555,42 @@ static void updateScreen(uiEvent_t *ev, bool firstRun, bool announceVP)
 							}
 						}
 
-						for(uint32_t t = startTime; t < displayedPredictionPass->satelliteLOS; t += 30)
+						// The track is drawn from the cache filled by the prediction task. If it's not available yet, it will be drawn on the next recalculation.
+						track = satelliteGetPassTrack(currentActiveSatellite, currentActiveSatellite->predictions.selectedPassNumber);
+						if (track != NULL)
 						{
-							satelliteCalculateForDateTimeSecs(currentActiveSatellite, t, &results, SATELLITE_PREDICTION_LEVEL_TIME_EL_AND_AZ);
-							az = deg2rad(results.azimuthAsInteger);
-							elFactor = (1 - (fabs(results.elevationAsInteger) / 90)) * MAX_RADIUS;
-							s = sin(az);
-							c = cos(az);
-							x = POLAR_GRAPHICS_X_OFFSET + (DISPLAY_SIZE_X / 2) + (s * elFactor);
-							y = (DISPLAY_SIZE_Y / 2) - (c * elFactor);// NOTE... Subtract value from Y center - for North at top of screen
-
-							if (t == startTime)
+							int i = 0;
+
+							if (startTime != track->passAOS)
 							{
-								displayFillCircle(x, y , (DOT_RADIUS+1), true);
+								// Satellite is visible, start from its current position and skip the part of the track which is in the past
+								polarPlotPosition(currentSatelliteResults.azimuthAsInteger, currentSatelliteResults.elevationAsInteger, MAX_RADIUS, &lastX, &lastY);
+								displayFillCircle(lastX, lastY , (DOT_RADIUS+1), true);
+								isFirstPoint = false;
+
+								while ((i < track->numPoints) && ((track->passAOS + (i * track->stepSecs)) <= startTime))
+								{
+									i++;
+								}
 							}
-							else
+
+							for(; i < track->numPoints; i++)
 							{
-								displayDrawLine(lastX    ,lastY     ,x    ,y	   ,true);
-							}
+								polarPlotPosition(SATELLITE_TRACK_POINT_AZ(track->points[i]), SATELLITE_TRACK_POINT_EL(track->points[i]), MAX_RADIUS, &x, &y);
+
+								if (isFirstPoint)
+								{
+									displayFillCircle(x, y , (DOT_RADIUS+1), true);
+									isFirstPoint = false;
+								}
+								else
+								{
+									displayDrawLine(lastX    ,lastY     ,x    ,y	   ,true);
+								}
 
-							lastX=x;
-							lastY=y;
+								lastX=x;
+								lastY=y;
+							}
 						}
 					}
 
@@ -799,7 +829,7 @@ static void handleEvent(uiEvent_t *ev)
 	{
 		if (displayMode == SATELLITE_SCREEN_ALL_PREDICTIONS_LIST)
 		{
-			clockManagerSetRunMode(kAPP_PowerModeRun, CLOCK_MANAGER_SPEED_RUN);
+			clockManagerLeaseRelease(CLOCK_MANAGER_LEASE_SATELLITE);
 			menuSystemPopPreviousMenu();
 		}
 		else
@@ -1095,157 +1125,6 @@ static void handleEvent(uiEvent_t *ev)
 	}
 }
 
-bool findSelectedPass = false;
-uint32_t selectedPassAOS = 0;
-bool calculatePredictionsForSatelliteIndex(int satelliteIndex)
-{
-	satelliteResults_t results;
-	satelliteData_t * satellite = &satelliteDataNative[satelliteIndex];
-
-	if ((uiDataGlobal.dateTimeSecs >= satellite->predictions.passes[0].satelliteAOS) && (uiDataGlobal.dateTimeSecs <= satellite->predictions.passes[0].satelliteLOS))
-	{
-		if ((displayMode == SATELLITE_SCREEN_ALL_PREDICTIONS_LIST) && (satellite->predictions.isVisible == false))
-		{
-			menuSatelliteScreenNextUpdateTime = 1;
-		}
-		satellite->predictions.isVisible = true;
-	}
-	else
-	{
-		if ((displayMode == SATELLITE_SCREEN_ALL_PREDICTIONS_LIST) && (satellite->predictions.isVisible == true))
-		{
-			menuSatelliteScreenNextUpdateTime = 1;
-		}
-		satellite->predictions.isVisible = false;
-	}
-
-	// Force rebuilding of the prediction if the the time is after the LOS of the first predicted pass
-	if ((satellite->predictions.numPasses > 0) && (uiDataGlobal.dateTimeSecs > satellite->predictions.passes[0].satelliteLOS) && !satellite->predictions.isPredicting)
-	{
-		findSelectedPass = false;
-		if (satellite->predictions.selectedPassNumber != 0)
-		{
-			selectedPassAOS = satellite->predictions.passes[satellite->predictions.selectedPassNumber].satelliteAOS;
-			if (selectedPassAOS >= uiDataGlobal.dateTimeSecs)
-			{
-				findSelectedPass = true;
-			}
-		}
-
-		// find passes which are in the past
-		int passNum;
-		for(passNum=0; passNum<satellite->predictions.numPasses; passNum++)
-		{
-			if (!(uiDataGlobal.dateTimeSecs > satellite->predictions.passes[passNum].satelliteLOS))
-			{
-				break;
-			}
-		}
-		int numPassesToMove = satellite->predictions.numPasses - passNum;
-		memcpy(&satellite->predictions.passes[0], &satellite->predictions.passes[passNum],  numPassesToMove * sizeof(satellitePass_t));
-
-		int numPassesToClear = NUM_SATELLITE_PREDICTIONS - numPassesToMove;
-		memset(&satellite->predictions.passes[numPassesToMove], 0x00, (numPassesToClear) * sizeof(satellitePass_t));// clear all predictions for this satellite
-
-		satellite->predictions.numPasses = numPassesToMove;
-		satellite->predictions.numPassBeingPredicted = numPassesToMove;
-		satellite->predictions.listDisplayPassSearchStartIndex = 0;
-		satellite->predictions.selectedPassNumber = 0;
-		satellite->predictions.isPredicting = true;
-		satellite->predictions.isVisible = false;
-
-
-		//memset(&satellite->predictions, 0x00, sizeof(satellitePredictions_t));// clear all predictions for this satellite
-		//satellite->predictions.numPassBeingPredicted = 0;
-		satellite->predictions.isPredicting = true;
-		numTotalSatellitesPredicted--;
-		currentlyDisplayedListPosition = 0;// Reset the list position, as there may be less satellites after the passes for this satellite are re-calculated
-	}
-
-	if (satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid == PREDICTION_RESULT_NONE)
-	{
-		time_t_custom predictionStartTime;
-
-		if ((satellite->predictions.numPassBeingPredicted == 0) && (currentPrediction.state == PREDICTION_STATE_NONE))
-		{
-			satelliteCalculateForDateTimeSecs(satellite, uiDataGlobal.dateTimeSecs, &results, SATELLITE_PREDICTION_LEVEL_TIME_AND_ELEVATION_ONLY);
-
-			if (results.elevation < 0)
-			{
-				predictionStartTime = uiDataGlobal.dateTimeSecs;
-			}
-			else
-			{
-				predictionStartTime = uiDataGlobal.dateTimeSecs - (30 * 60);// If satellite is currently visible. Change prediction start back  30 mins
-			}
-		}
-		else
-		{
-			predictionStartTime = satellite->predictions.passes[satellite->predictions.numPassBeingPredicted - 1].satelliteAOS +
-				satellite->predictions.passes[satellite->predictions.numPassBeingPredicted - 1].satellitePassDuration + 30 * 60;// 30 minutes after the last pass
-		}
-
-		if ((currentPrediction.state == PREDICTION_STATE_NONE))
-		{
-			currentPrediction.state = PREDICTION_STATE_INIT_AOS;// Start the prediction
-		}
-
-		if (!satellitePredictNextPassFromDateTimeSecs(&currentPrediction, satellite, predictionStartTime, (uiDataGlobal.dateTimeSecs + (24 * 60 * 60)), 500,  &satellite->predictions.passes[satellite->predictions.numPassBeingPredicted]))
-		{
-			satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid = PREDICTION_RESULT_NONE;
-		}
-
-		switch(currentPrediction.state)
-		{
-			case PREDICTION_STATE_COMPLETE:
-				if (satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].satelliteAOS != 0)
-				{
-
-					satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid = PREDICTION_RESULT_OK;
-					satellite->predictions.numPasses++;
-					if (satellite->predictions.numPasses < (NUM_SATELLITE_PREDICTIONS - 1))
-					{
-						if (findSelectedPass && (selectedPassAOS == satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].satelliteAOS))
-						{
-							satellite->predictions.selectedPassNumber = satellite->predictions.numPassBeingPredicted;
-							findSelectedPass = false;
-						}
-						satellite->predictions.numPassBeingPredicted++;
-					}
-					else
-					{
-						satellite->predictions.numPasses--;// hack
-						satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid = PREDICTION_RESULT_LIMIT;
-						currentPrediction.state = PREDICTION_STATE_NONE;// Start the prediction
-						satellite->predictions.isPredicting = false;
-					}
-				}
-				currentPrediction.state = PREDICTION_STATE_NONE;// Start the prediction
-				break;
-
-			case PREDICTION_STATE_ITERATION_LIMIT:
-				// Do something. There has been a problem while computing the predictions
-			case PREDICTION_STATE_LIMIT:
-				satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid = PREDICTION_RESULT_LIMIT;
-				currentPrediction.state = PREDICTION_STATE_NONE;// Start the prediction
-				satellite->predictions.isPredicting = false;
-				//clockManagerSetRunMode(kAPP_PowerModeRun, CLOCK_MANAGER_SPEED_RUN);
-				findSelectedPass = false;
-				return true;
-				break;
-			case PREDICTION_STATE_NONE:
-			case PREDICTION_STATE_INIT_AOS:
-			case PREDICTION_STATE_FIND_AOS:
-			case PREDICTION_STATE_INIT_LOS:
-			case PREDICTION_STATE_FIND_LOS:
-				satellite->predictions.passes[satellite->predictions.numPassBeingPredicted].valid = PREDICTION_RESULT_NONE;// move on to next pass
-				return false;
-				break;
-		}
-	}
-	return true;
-}
-
 static void loadKeps(void)
 {
 	codeplugSatelliteData_t codeplugKepsData[NUM_SATELLITES];
@@ -1279,6 +1158,9 @@ static void loadKeps(void)
 
 void menuSatelliteScreenClearPredictions(bool reloadKeps)
 {
+	// Stop the prediction task while the satellite data is changed. This also invalidates the cached pass tracks
+	satellitePredictionTaskLock();
+
 	numTotalSatellitesPredicted = 0;
 	currentlyDisplayedListPosition = 0; //reset the list display position if the predictions have been cleared.
 
@@ -1293,6 +1175,9 @@ void menuSatelliteScreenClearPredictions(bool reloadKeps)
 	}
 	currentActiveSatellite =  &satelliteDataNative[0];
 
+	satellitePredictionTaskReset(numSatellitesLoaded);
+	satellitePredictionTaskUnlock();
+
 	uiDataGlobal.SatelliteAndAlarmData.alarmType = ALARM_TYPE_NONE;
 }
 
@@ -1339,6 +1224,15 @@ static void selectSatellite(uint32_t selectedSatellite)
 		voicePromptsInit();
 }
 
+static void polarPlotPosition(int azimuth, int elevation, int maxRadius, float *x, float *y)
+{
+	float az = deg2rad(azimuth);
+	float elFactor = (1 - (fabs(elevation) / 90)) * maxRadius;
+
+	*x = POLAR_GRAPHICS_X_OFFSET + (DISPLAY_SIZE_X / 2) + (sin(az) * elFactor);
+	*y = (DISPLAY_SIZE_Y / 2) - (cos(az) * elFactor);// NOTE... Subtract value from Y center - for North at top of screen
+}
+
 bool menuSatelliteIsDisplayingHeader(void)
 {
 	return (displayMode == SATELLITE_SCREEN_SELECTED_SATELLITE);
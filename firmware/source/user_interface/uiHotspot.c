@@ -190,7 +190,7 @@ void menuHotspotRestoreSettings(void)
 	}
 }
 
-static void displayContactInfo(uint8_t y, char *text, size_t maxLen)
+static void displayContactInfo(uint8_t y, const char *text, size_t maxLen)
 {
 	// Max for TalkerAlias is 37: TA 27 (in 7bit format) + ' [' + 6 (Maidenhead)  + ']' + NULL
 	// Max for DMRID Database is MAX_DMR_ID_CONTACT_TEXT_LENGTH (50 + NULL)
@@ -210,8 +210,10 @@ static void displayContactInfo(uint8_t y, char *text, size_t maxLen)
 		else
 		{
 			// No space found, use a chainsaw
-			memcpy(buffer, text, 16);
-			buffer[16] = 0;
+			size_t textLength = strnlen(text, 16);// The text is stored in the last heard strings pool, don't copy past its end
+
+			memcpy(buffer, text, textLength);
+			buffer[textLength] = 0;
 
 			displayPrintCentered(y, chomp(buffer), FONT_SIZE_3);
 		}
@@ -228,7 +230,7 @@ static void updateContactLine(uint8_t y)
 {
 	if ((LinkHead->talkGroupOrPcId >> 24) == PC_CALL_FLAG) // Its a Private call
 	{
-		displayPrintCentered(y, LinkHead->contact, FONT_SIZE_3);
+		displayPrintCentered(y, lastheardGetContact(LinkHead), FONT_SIZE_3);
 	}
 	else // Group call
 	{
@@ -237,26 +239,26 @@ static void updateContactLine(uint8_t y)
 			case CONTACT_DISPLAY_PRIO_CC_DB_TA:
 			case CONTACT_DISPLAY_PRIO_DB_CC_TA:
 				// No contact found is codeplug and DMRIDs, use TA as fallback, if any.
-				if ((strncmp(LinkHead->contact, "ID:", 3) == 0) && (LinkHead->talkerAlias[0] != 0x00))
+				if ((strncmp(lastheardGetContact(LinkHead), "ID:", 3) == 0) && (LinkHead->talkerAlias != 0))
 				{
-					displayContactInfo(y, LinkHead->talkerAlias, sizeof(LinkHead->talkerAlias));
+					displayContactInfo(y, lastheardGetTalkerAlias(LinkHead), LASTHEARD_TALKER_ALIAS_LENGTH);
 				}
 				else
 				{
-					displayContactInfo(y, LinkHead->contact, sizeof(LinkHead->contact));
+					displayContactInfo(y, lastheardGetContact(LinkHead), MAX_DMR_ID_CONTACT_TEXT_LENGTH);
 				}
 				break;
 
 			case CONTACT_DISPLAY_PRIO_TA_CC_DB:
 			case CONTACT_DISPLAY_PRIO_TA_DB_CC:
 				// Talker Alias have the priority here
-				if (LinkHead->talkerAlias[0] != 0x00)
+				if (LinkHead->talkerAlias != 0)
 				{
-					displayContactInfo(y, LinkHead->talkerAlias, sizeof(LinkHead->talkerAlias));
+					displayContactInfo(y, lastheardGetTalkerAlias(LinkHead), LASTHEARD_TALKER_ALIAS_LENGTH);
 				}
 				else // No TA, then use the one extracted from Codeplug or DMRIdDB
 				{
-					displayContactInfo(y, LinkHead->contact, sizeof(LinkHead->contact));
+					displayContactInfo(y, lastheardGetContact(LinkHead), MAX_DMR_ID_CONTACT_TEXT_LENGTH);
 				}
 				break;
 		}
@@ -447,7 +449,7 @@ static bool handleEvent(uiEvent_t *ev)
 			case 91:
 				trxTalkGroupOrPcId = 98977;
 				LinkHead->talkGroupOrPcId = 0;
-				sprintf(LinkHead->contact, "%s", "VK3KYY");
+				lastheardSetContact(LinkHead, "VK3KYY");
 				trxTransmissionEnabled = true;
 				uiHotspotUpdateScreen(HOTSPOT_STATE_TX_START_BUFFERING);
 				break;
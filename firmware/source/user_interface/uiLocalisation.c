@@ -26,89 +26,234 @@
  *
  */
 #include "user_interface/uiLocalisation.h"
+#include "functions/codeplug.h"
+#include "hardware/SPI_Flash.h"
 
 #include "user_interface/languages/english.h"
 #if defined(LANGUAGE_BUILD_JAPANESE)
 #include "user_interface/languages/japanese.h"
-#else
-#include "user_interface/languages/french.h"
-#include "user_interface/languages/german.h"
-#include "user_interface/languages/portuguese.h"
-#include "user_interface/languages/catalan.h"
-#include "user_interface/languages/spanish.h"
-#include "user_interface/languages/italian.h"
-#include "user_interface/languages/danish.h"
-#include "user_interface/languages/finnish.h"
-#include "user_interface/languages/polish.h"
-#include "user_interface/languages/turkish.h"
-#include "user_interface/languages/czech.h"
-#include "user_interface/languages/dutch.h"
-#include "user_interface/languages/slovenian.h"
-#include "user_interface/languages/portugues_brazil.h"
-#include "user_interface/languages/swedish.h"
-#include "user_interface/languages/hungarian.h"
-#include "user_interface/languages/croatian.h"
 #endif
 
-/*
- * Note.
- *
- * Do not re-order the list of languages, unless you also change the MagicNumber in the settings
- * Because otherwise the radio will load a different language than the one the user previously saved when the radio was turned off
- * Add new languages at the end of the list
- *
- */
-const stringsTable_t languages[NUM_LANGUAGES]= { 	englishLanguage,        // englishLanguageName
+static const stringsTable_t *builtinLanguages[NUM_BUILTIN_LANGUAGES] = { &englishLanguage,
 #if defined(LANGUAGE_BUILD_JAPANESE)
-													japaneseLanguage,       // japaneseLanguageName
-#else
-													catalanLanguage,        // catalanLanguageName
-													danishLanguage,         // danishLanguageName
-													frenchLanguage,         // frenchLanguageName
-													germanLanguage,         // deutschGermanLanguageName
-													italianLanguage,        // italianLanguageName
-													portuguesLanguage,      // portuguesLanguageName
-													spanishLanguage,        // spanishLanguageName
-													finnishLanguage,        // suomiFinnishLanguageName
-													polishLanguage,         // polishLanguageName
-													turkishLanguage,        // turkishLanguageName
-													czechLanguage,          // czechLanguageName
-													dutchLanguage,          // nederlandsDutchLanguageName
-													slovenianLanguage,      // slovenianLanguageName
-													portuguesBrazilLanguage,// portuguesBrazilLanguageName
-													swedishLanguage,        // swedishLanguageName
-													hungarianLanguage,      // hungarianLanguageName
-													croatianLanguage,       // croatianLanguageName
+																		 &japaneseLanguage
+#endif
+																	   };
+static const uint8_t builtinLanguagesIds[NUM_BUILTIN_LANGUAGES] = { LANGUAGE_ID_ENGLISH,
+#if defined(LANGUAGE_BUILD_JAPANESE)
+																	LANGUAGE_ID_JAPANESE
 #endif
-													};
-const stringsTable_t *currentLanguage;
+																  };
+
+typedef struct
+{
+	int     address; // Pack data address in the SPI Flash
+	int     length;
+	uint8_t id;
+	char    name[LANGUAGE_TEXTS_LENGTH];
+} languagePackInfo_t;
+
+// Available packs, sorted alphabetically on their names
+static languagePackInfo_t languagePacks[LANGUAGE_PACKS_MAX];
+static int languagePacksCount = 0;
+
+// RAM cache of the selected pack
+static __attribute__((section(".data.$RAM2"))) stringsTable_t languagePackTable;
+static __attribute__((section(".data.$RAM2"))) char languagePackTexts[LANGUAGE_PACK_TEXTS_MAX_LENGTH];
+
+const stringsTable_t *currentLanguage = &englishLanguage;
+
+static bool languagePackReadHeader(int address, int length, languagePackHeader_t *header)
+{
+	return ((length >= sizeof(languagePackHeader_t)) &&
+			SPI_Flash_read(address, (uint8_t *)header, sizeof(languagePackHeader_t)) &&
+			(memcmp(header->magic, LANGUAGE_PACK_MAGIC, sizeof(header->magic)) == 0) && (header->languageId <= LANGUAGE_ID_MAX) &&
+			(header->stringsCount > 0) && (header->textsLength > 0) && (header->textsLength <= LANGUAGE_PACK_TEXTS_MAX_LENGTH) &&
+			((sizeof(languagePackHeader_t) + (header->stringsCount * sizeof(uint16_t)) + header->textsLength) <= length));
+}
+
+// Looks for the language packs stored in the SPI Flash. Only their names are read.
+void languagesInit(void)
+{
+	int address = 0;
+	int length = 0;
+
+	languagePacksCount = 0;
+
+	while ((languagePacksCount < LANGUAGE_PACKS_MAX) &&
+			codeplugFindNextOpenGD77CustomData(CODEPLUG_CUSTOM_DATA_TYPE_LANGUAGE_PACK, &address, &length))
+	{
+		languagePackHeader_t header;
+		uint16_t nameOffset;
+		languagePackInfo_t info;
+		int textsAddress;
+		int nameLength;
+
+		if ((languagePackReadHeader(address, length, &header) == false) ||
+				(SPI_Flash_read(address + sizeof(languagePackHeader_t), (uint8_t *)&nameOffset, sizeof(uint16_t)) == false) ||
+				(nameOffset >= header.textsLength))
+		{
+			continue;
+		}
+
+		// The language ID is saved in the settings, only the first pack (or the built in language) using it is listed
+		if (languagesGetIndexFromSetting(LANGUAGE_SETTING_FROM_ID(header.languageId)) != -1)
+		{
+			continue;
+		}
+
+		textsAddress = address + sizeof(languagePackHeader_t) + (header.stringsCount * sizeof(uint16_t));
+
+		nameLength = SAFE_MIN((LANGUAGE_TEXTS_LENGTH - 1), (header.textsLength - nameOffset));
+
+		info.address = address;
+		info.length = length;
+		info.id = header.languageId;
+		if (SPI_Flash_read(textsAddress + nameOffset, (uint8_t *)info.name, nameLength) == false)
+		{
+			continue;
+		}
+		info.name[nameLength] = 0;
+
+		// Insertion sort
+		int i = languagePacksCount;
+		while ((i > 0) && (strcmp(languagePacks[i - 1].name, info.name) > 0))
+		{
+			languagePacks[i] = languagePacks[i - 1];
+			i--;
+		}
+		languagePacks[i] = info;
+		languagePacksCount++;
+	}
+}
+
+int languagesGetCount(void)
+{
+	return (NUM_BUILTIN_LANGUAGES + languagePacksCount);
+}
+
+const char *languagesGetName(int index)
+{
+	if (index < NUM_BUILTIN_LANGUAGES)
+	{
+		return builtinLanguages[index]->LANGUAGE_NAME;
+	}
+
+	return languagePacks[index - NUM_BUILTIN_LANGUAGES].name;
+}
+
+static bool languagePackLoad(const languagePackInfo_t *info)
+{
+	languagePackHeader_t header;
+	const char * const *englishStrings = (const char * const *)&englishLanguage;
+	const char **strings = (const char **)&languagePackTable;
+	uint16_t offsets[32];
+
+	if ((languagePackReadHeader(info->address, info->length, &header) == false) ||
+			(SPI_Flash_read(info->address + sizeof(languagePackHeader_t) + (header.stringsCount * sizeof(uint16_t)), (uint8_t *)languagePackTexts, header.textsLength) == false))
+	{
+		return false;
+	}
+
+	languagePackTexts[header.textsLength - 1] = 0;
+
+	for (int i = 0; i < LANGUAGE_STRINGS_COUNT; i += (sizeof(offsets) / sizeof(offsets[0])))
+	{
+		int count = SAFE_MIN((sizeof(offsets) / sizeof(offsets[0])), (LANGUAGE_STRINGS_COUNT - i));
+
+		if (i < header.stringsCount)
+		{
+			if (SPI_Flash_read(info->address + sizeof(languagePackHeader_t) + (i * sizeof(uint16_t)), (uint8_t *)offsets, (SAFE_MIN(count, (header.stringsCount - i)) * sizeof(uint16_t))) == false)
+			{
+				return false;
+			}
+		}
+
+		for (int j = 0; j < count; j++)
+		{
+			int stringIndex = i + j;
+
+			if ((stringIndex < header.stringsCount) && (offsets[j] < header.textsLength))
+			{
+				strings[stringIndex] = &languagePackTexts[offsets[j]];
+			}
+			else
+			{
+				strings[stringIndex] = englishStrings[stringIndex];
+			}
+		}
+	}
+
+	return true;
+}
+
+// Selects the language, loading its pack into RAM if needed. Falls back to English if the pack can't be loaded
+bool languagesSetCurrent(int index)
+{
+	if ((index >= 0) && (index < NUM_BUILTIN_LANGUAGES))
+	{
+		currentLanguage = builtinLanguages[index];
+		return true;
+	}
+
+	// The pack cache is going to be overwritten
+	currentLanguage = &englishLanguage;
+
+	if ((index >= NUM_BUILTIN_LANGUAGES) && (index < languagesGetCount()) &&
+			languagePackLoad(&languagePacks[index - NUM_BUILTIN_LANGUAGES]))
+	{
+		currentLanguage = &languagePackTable;
+		return true;
+	}
+
+	return false;
+}
+
+// Value to save in the settings for the language at this index of the list
+uint8_t languagesGetSetting(int index)
+{
+	if (index < NUM_BUILTIN_LANGUAGES)
+	{
+		return LANGUAGE_SETTING_FROM_ID(builtinLanguagesIds[index]);
+	}
+
+	return LANGUAGE_SETTING_FROM_ID(languagePacks[index - NUM_BUILTIN_LANGUAGES].id);
+}
+
+// Converts a setting saved by an older firmware (index in its languages table) into a language ID setting
+uint8_t languagesSettingFromLegacy(uint8_t setting)
+{
+	if (setting & LANGUAGE_SETTING_ID_FLAG)
+	{
+		return setting;
+	}
 
-// used in menuLanguage
-// needs to be sorted alphabetically, based on the text that is displayed for each language name. With English as the first / default language
-const int LANGUAGE_DISPLAY_ORDER[NUM_LANGUAGES] = {	englishLanguageName,
 #if defined(LANGUAGE_BUILD_JAPANESE)
-													japaneseLanguageName,
+	// The Japanese firmware table was English, Japanese
+	return LANGUAGE_SETTING_FROM_ID((setting == 1) ? LANGUAGE_ID_JAPANESE : LANGUAGE_ID_ENGLISH);
 #else
-													catalanLanguageName,
-													croatianLanguageName,
-													czechLanguageName,
-													danishLanguageName,
-													deutschGermanLanguageName,
-													frenchLanguageName,
-													hungarianLanguageName,
-													italianLanguageName,
-													nederlandsDutchLanguageName,
-													polishLanguageName,
-													portuguesLanguageName,
-													portuguesBrazilLanguageName,
-													slovenianLanguageName,
-													spanishLanguageName,
-													suomiFinnishLanguageName,
-													swedishLanguageName,
-													turkishLanguageName
+	// The table order is the language IDs one
+	return LANGUAGE_SETTING_FROM_ID((setting <= LANGUAGE_ID_CROATIAN) ? setting : LANGUAGE_ID_ENGLISH);
 #endif
-													};
+}
+
+// Returns the index in the list of the saved language, or -1 if it's not available (e.g. its pack has been removed)
+int languagesGetIndexFromSetting(uint8_t setting)
+{
+	int count = languagesGetCount();
 
+	setting = languagesSettingFromLegacy(setting);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (languagesGetSetting(i) == setting)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
 
 char LanguageGetSymbol(LanguageSymbol_t s)
 {
@@ -68,7 +68,7 @@ menuStatus_t menuTxScreen(uiEvent_t *ev, bool isFirstRun)
 
 		if (trxGetMode() == RADIO_MODE_DIGITAL)
 		{
-			clockManagerSetRunMode(kAPP_PowerModeHsrun, CLOCK_MANAGER_SPEED_HS_RUN);
+			clockManagerLeaseFullSpeed(CLOCK_MANAGER_LEASE_TX, 0);
 		}
 
 #if defined(PLATFORM_GD77S)
@@ -378,7 +378,7 @@ static void handleEvent(uiEvent_t *ev)
 
 				if (trxGetMode() == RADIO_MODE_DIGITAL)
 				{
-					clockManagerSetRunMode(kAPP_PowerModeRun, CLOCK_MANAGER_SPEED_RUN);
+					clockManagerLeaseRelease(CLOCK_MANAGER_LEASE_TX);
 				}
 
 				HRC6000ClearIsWakingState();
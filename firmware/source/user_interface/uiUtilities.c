@@ -37,17 +37,42 @@
 #include "functions/ticks.h"
 #include "functions/trx.h"
 #include "functions/rxPowerSaving.h"
+#include "functions/nameIndex.h"
 
 static const uint8_t DECOMPRESS_LUT[64] = { ' ', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '.' };
 
 static __attribute__((section(".data.$RAM2"))) LinkItem_t callsList[NUM_LASTHEARD_STORED];
 
+// Last heard strings pool.
+// The texts are interned (a talkgroup name is stored only once, whatever the number of entries using it), and
+// reference counted. They are stored in an arena, as blocks of [handle][length][text][NULL], which is compacted
+// when there is no more room at its end. If the arena is still full after compaction, the oldest last heard entries
+// are dropped.
+typedef struct
+{
+	uint16_t offset;
+	uint8_t  length;
+	uint8_t  refCount;
+} lastheardString_t;
+
+typedef struct
+{
+	uint16_t          used;
+	lastheardString_t strings[LASTHEARD_STRINGS_COUNT];// handle 0 is never allocated, it's the empty string
+	char              arena[LASTHEARD_STRINGS_ARENA_SIZE];
+} lastheardStrings_t;
+
+#define LASTHEARD_STRING_HEADER_LENGTH   2
+
+static __attribute__((section(".data.$RAM2"))) lastheardStrings_t lastheardStrings;
+
 static uint32_t dmrIdDataArea_1_Size;
 static const uint32_t DMRID_HEADER_LENGTH = 0x0C;
 static const uint32_t DMRID_MEMORY_LOCATION_1 = 0x30000;
 static uint32_t dmrIDDatabaseMemoryLocation2 = 0xB8000;
 
 static dmrIDsCache_t dmrIDsCache;
+static bool dmrIDsCacheIsReady = false; // Built in the background at boot
 static voicePromptItem_t voicePromptSequenceState = PROMPT_SEQUENCE_CHANNEL_NAME_OR_VFO_FREQ;
 static uint32_t lastTG = 0;
 
@@ -58,9 +83,31 @@ DECLARE_SMETER_ARRAY(rssiMeterHeaderBar, DISPLAY_SIZE_X);
 
 static uint32_t DMRID_IdLength = 4U;
 
-static uint8_t bufferTA[32] = { 0 };
-static uint8_t blocksTA = 0x00;
-static bool overrideTA = false;
+// Optional callsign index, written by the CPS right after the last DMR ID record (records area offset
+// entries * contactLength): a header (magic, then the number of records, uint32 little endian) followed by
+// the records numbers (uint24 little endian) sorted by callsign (the record text up to the first space,
+// case insensitive). It costs 3 bytes per record, and a lookup reads about 2 * log2(entries) records.
+#define DMRID_CALLSIGN_INDEX_MAGIC            "CsIx"
+#define DMRID_CALLSIGN_INDEX_HEADER_LENGTH    8
+#define DMRID_CALLSIGN_INDEX_ENTRY_LENGTH     3
+
+#define TALKER_ALIAS_BLOCKS          4
+#define TALKER_ALIAS_BLOCK_LENGTH    7
+#define TALKER_ALIAS_BUFFER_LENGTH  (TALKER_ALIAS_BLOCKS * TALKER_ALIAS_BLOCK_LENGTH)
+
+// Incremental Talker Alias decoder: each embedded LC block is only decoded once, as it arrives,
+// and characters are decoded as soon as all the bytes they are spanning are available.
+typedef struct
+{
+	uint8_t  buffer[TALKER_ALIAS_BUFFER_LENGTH];
+	uint8_t  blocks;       // Bitmap of the received blocks
+	uint32_t decodedChars; // Bitmap of the decoded characters
+	uint8_t  length;       // Number of contiguous characters decoded from the start of the TA
+	bool     override;     // TA header has changed, the decoded TA has to replace the stored one
+	char     text[LASTHEARD_TALKER_ALIAS_LENGTH];
+} talkerAliasDecoder_t;
+
+static talkerAliasDecoder_t taDecoder;
 static bool contactDefinedForTA = false; // lockout TA data storage until a valid DMR ID is received.
 
 static void announceChannelNameOrVFOFrequency(bool voicePromptWasPlaying, bool announceVFOName);
@@ -225,9 +272,9 @@ char *chomp(char *str)
 	return sp;
 }
 
-int32_t getFirstSpacePos(char *str)
+int32_t getFirstSpacePos(const char *str)
 {
-	char *p = str;
+	const char *p = str;
 
 	while(*p != '\0')
 	{
@@ -242,19 +289,236 @@ int32_t getFirstSpacePos(char *str)
 	return -1;
 }
 
+static void lastheardStringsInit(void)
+{
+	memset(&lastheardStrings, 0, sizeof(lastheardStrings_t));
+}
+
+static void lastheardStringRelease(uint8_t handle)
+{
+	if ((handle != 0) && (lastheardStrings.strings[handle].refCount > 0))
+	{
+		lastheardStrings.strings[handle].refCount--;
+	}
+}
+
+static void lastheardReleaseItemStrings(LinkItem_t *item)
+{
+	lastheardStringRelease(item->contact);
+	lastheardStringRelease(item->talkgroup);
+	lastheardStringRelease(item->talkerAlias);
+	item->contact = item->talkgroup = item->talkerAlias = 0;
+}
+
+// Moves all the live strings to the beginning of the arena
+static void lastheardStringsCompact(void)
+{
+	uint16_t readOffset = 0;
+	uint16_t writeOffset = 0;
+
+	while (readOffset < lastheardStrings.used)
+	{
+		uint8_t handle = lastheardStrings.arena[readOffset];
+		uint16_t blockLength = LASTHEARD_STRING_HEADER_LENGTH + (uint8_t)lastheardStrings.arena[readOffset + 1] + 1;
+
+		// A freed handle could have been reallocated somewhere else
+		if ((lastheardStrings.strings[handle].refCount > 0) && (lastheardStrings.strings[handle].offset == readOffset))
+		{
+			if (writeOffset != readOffset)
+			{
+				memmove(&lastheardStrings.arena[writeOffset], &lastheardStrings.arena[readOffset], blockLength);
+				lastheardStrings.strings[handle].offset = writeOffset;
+			}
+			writeOffset += blockLength;
+		}
+
+		readOffset += blockLength;
+	}
+
+	lastheardStrings.used = writeOffset;
+}
+
+// Drops the oldest entry in the list, apart from keepItem. Returns false if there is nothing to drop.
+static bool lastheardDropOldest(const LinkItem_t *keepItem)
+{
+	LinkItem_t *item = LinkHead;
+	LinkItem_t *oldest = NULL;
+
+	// Used entries are always at the top of the list
+	while ((item != NULL) && (item->id != 0))
+	{
+		if (item != keepItem)
+		{
+			oldest = item;
+		}
+		item = item->next;
+	}
+
+	if ((oldest == NULL) || ((oldest->next != NULL) && (oldest->next->id != 0)))
+	{
+		// keepItem is the last used entry, dropping the one before would leave a hole in the list
+		return false;
+	}
+
+	lastheardReleaseItemStrings(oldest);
+	oldest->id = 0;
+	oldest->talkGroupOrPcId = 0;
+
+	if (uiDataGlobal.lastHeardCount > 0)
+	{
+		uiDataGlobal.lastHeardCount--;
+	}
+
+	return true;
+}
+
+static uint8_t lastheardStringAcquire(const char *text, size_t maxLen, const LinkItem_t *item)
+{
+	size_t length = strnlen(text, SAFE_MIN(maxLen, 255));
+	uint8_t freeHandle;
+
+	if (length == 0)
+	{
+		return 0;
+	}
+
+	// Already in the pool ?
+	for (int handle = 1; handle < LASTHEARD_STRINGS_COUNT; handle++)
+	{
+		lastheardString_t *string = &lastheardStrings.strings[handle];
+
+		if ((string->refCount > 0) && (string->refCount < 255) && (string->length == length) &&
+				(memcmp(&lastheardStrings.arena[string->offset + LASTHEARD_STRING_HEADER_LENGTH], text, length) == 0))
+		{
+			string->refCount++;
+			return handle;
+		}
+	}
+
+	while (true)
+	{
+		uint16_t blockLength = LASTHEARD_STRING_HEADER_LENGTH + length + 1;
+
+		freeHandle = 0;
+		for (int handle = 1; handle < LASTHEARD_STRINGS_COUNT; handle++)
+		{
+			if (lastheardStrings.strings[handle].refCount == 0)
+			{
+				freeHandle = handle;
+				break;
+			}
+		}
+
+		if (freeHandle != 0)
+		{
+			if ((lastheardStrings.used + blockLength) > LASTHEARD_STRINGS_ARENA_SIZE)
+			{
+				lastheardStringsCompact();
+			}
+
+			if ((lastheardStrings.used + blockLength) <= LASTHEARD_STRINGS_ARENA_SIZE)
+			{
+				lastheardString_t *string = &lastheardStrings.strings[freeHandle];
+
+				string->offset = lastheardStrings.used;
+				string->length = length;
+				string->refCount = 1;
+
+				lastheardStrings.arena[string->offset] = freeHandle;
+				lastheardStrings.arena[string->offset + 1] = length;
+				memcpy(&lastheardStrings.arena[string->offset + LASTHEARD_STRING_HEADER_LENGTH], text, length);
+				lastheardStrings.arena[string->offset + LASTHEARD_STRING_HEADER_LENGTH + length] = 0;
+				lastheardStrings.used += blockLength;
+
+				return freeHandle;
+			}
+		}
+
+		if (lastheardDropOldest(item) == false)
+		{
+			return 0;
+		}
+	}
+}
+
+static const char *lastheardStringGet(uint8_t handle)
+{
+	if (handle == 0)
+	{
+		return "";
+	}
+
+	return &lastheardStrings.arena[lastheardStrings.strings[handle].offset + LASTHEARD_STRING_HEADER_LENGTH];
+}
+
+static void lastheardSetString(LinkItem_t *item, uint8_t *handle, const char *text, size_t maxLen)
+{
+	// Acquire first, so an unchanged text keeps its place in the pool
+	uint8_t newHandle = lastheardStringAcquire(text, maxLen, item);
+
+	lastheardStringRelease(*handle);
+	*handle = newHandle;
+}
+
+const char *lastheardGetContact(const LinkItem_t *item)
+{
+	return lastheardStringGet(item->contact);
+}
+
+const char *lastheardGetTalkgroup(const LinkItem_t *item)
+{
+	return lastheardStringGet(item->talkgroup);
+}
+
+const char *lastheardGetTalkerAlias(const LinkItem_t *item)
+{
+	return lastheardStringGet(item->talkerAlias);
+}
+
+void lastheardSetContact(LinkItem_t *item, const char *text)
+{
+	lastheardSetString(item, &item->contact, text, MAX_DMR_ID_CONTACT_TEXT_LENGTH);
+}
+
+static void lastheardSetTalkgroup(LinkItem_t *item, const char *text)
+{
+	lastheardSetString(item, &item->talkgroup, text, SCREEN_LINE_BUFFER_SIZE);
+}
+
+static void lastheardSetTalkerAlias(LinkItem_t *item, const char *text)
+{
+	lastheardSetString(item, &item->talkerAlias, text, (LASTHEARD_TALKER_ALIAS_LENGTH - 1));
+}
+
+// Location is returned in micro degrees
+bool lastheardGetLocation(const LinkItem_t *item, int32_t *latitude, int32_t *longitude)
+{
+	if (item->locationLat == LASTHEARD_NO_LOCATION)
+	{
+		return false;
+	}
+
+	*latitude = (int32_t)(((int64_t)item->locationLat * 90000000) / INT16_MAX);
+	*longitude = (int32_t)(((int64_t)item->locationLon * 180000000) / INT16_MAX);
+
+	return true;
+}
+
 void lastheardInitList(void)
 {
 	LinkHead = callsList;
 
+	lastheardStringsInit();
+
 	for(int i = 0; i < NUM_LASTHEARD_STORED; i++)
 	{
 		callsList[i].id = 0;
 		callsList[i].talkGroupOrPcId = 0;
-		callsList[i].contact[0] = 0;
-		callsList[i].talkgroup[0] = 0;
-		callsList[i].talkerAlias[0] = 0;
-		callsList[i].locationLat = NAN;
-		callsList[i].locationLon = NAN;
+		callsList[i].contact = 0;
+		callsList[i].talkgroup = 0;
+		callsList[i].talkerAlias = 0;
+		callsList[i].locationLat = LASTHEARD_NO_LOCATION;
+		callsList[i].locationLon = 0;
 		callsList[i].time = 0;
 		callsList[i].receivedTS = 0;
 		callsList[i].dmrMode = DMR_MODE_AUTO;
@@ -298,64 +562,33 @@ LinkItem_t *lastheardFindInList(uint32_t id)
 	return NULL;
 }
 
-// returns pointer to maidenheadBuffer
-uint8_t *coordsToMaidenhead(uint8_t *maidenheadBuffer, double latitude, double longitude)
+// returns pointer to maidenheadBuffer. Latitude and longitude are in micro degrees.
+uint8_t *coordsToMaidenhead(uint8_t *maidenheadBuffer, int32_t latitude, int32_t longitude)
 {
-	double l, l2;
-	uint8_t c;
-
-	l = longitude;
+	// Field is 20x10 degrees, square 2x1 degree, subsquare 1/12 x 1/24 degree
+	static const int32_t FIELD_SIZE[2]  = { 20000000, 10000000 };
+	static const int32_t SQUARE_SIZE[2] = {  2000000,  1000000 };
+	uint32_t v;
 
 	for (uint8_t i = 0; i < 2; i++)
 	{
-		l = l / ((i == 0) ? 20.0 : 10.0) + 9.0;
-		c = (uint8_t) l;
-		maidenheadBuffer[0 + i] = c + 'A';
-		l2 = c;
-		l -= l2;
-		l *= 10.0;
-		c = (uint8_t) l;
-		maidenheadBuffer[2 + i] = c + '0';
-		l2 = c;
-		l -= l2;
-		l *= 24.0;
-		c = (uint8_t) l;
-		maidenheadBuffer[4 + i] = c + 'A';
-
-#if 0
-		if (extended)
-		{
-			l2 = c;
-			l -= l2;
-			l *= 10.0;
-			c = (uint8_t) l;
-			maidenheadBuffer[6 + i] = c + '0';
-			l2 = c;
-			l -= l2;
-			l *= 24.0;
-			c = (uint8_t) l;
-			maidenheadBuffer[8 + i] = c + (extended ? 'A' : 'a');
-			l2 = c;
-			l -= l2;
-			l *= 10.0;
-			c = (uint8_t) l;
-			maidenheadBuffer[10 + i] = c + '0';
-			l2 = c;
-			l -= l2;
-			l *= 24.0;
-			c = (uint8_t) l;
-			maidenheadBuffer[12 + i] = c + (extended ? 'A' : 'a');
+		if (i == 0)
+		{
+			v = SAFE_MIN((uint32_t)(longitude + 180000000), (uint32_t)(360000000 - 1));
+		}
+		else
+		{
+			v = SAFE_MIN((uint32_t)(latitude + 90000000), (uint32_t)(180000000 - 1));
 		}
-#endif
 
-		l = latitude;
+		maidenheadBuffer[0 + i] = (v / FIELD_SIZE[i]) + 'A';
+		v %= FIELD_SIZE[i];
+		maidenheadBuffer[2 + i] = (v / SQUARE_SIZE[i]) + '0';
+		v %= SQUARE_SIZE[i];
+		maidenheadBuffer[4 + i] = ((v * 24) / SQUARE_SIZE[i]) + 'A';
 	}
 
-#if 0
-	maidenheadBuffer[extended ? 14 : 6] = '\0';
-#else
 	maidenheadBuffer[6] = '\0';
-#endif
 
 	return maidenheadBuffer;
 }
@@ -375,6 +608,13 @@ double latLongFixedToDouble(uint32_t fixedVal)
 	return inPart + (decimalPart / ((double)LOCATION_DECIMAL_PART_MULIPLIER));
 }
 
+int32_t latLongFixedToMicroDegrees(uint32_t fixedVal)
+{
+	int32_t value = (((fixedVal & 0x7FFFFFFF) >> 23) * 1000000) + ((fixedVal & 0x7FFFFF) * (1000000 / LOCATION_DECIMAL_PART_MULIPLIER));
+
+	return ((fixedVal & 0x80000000) ? -value : value);
+}
+
 uint32_t latLongDoubleToFixed(double value)
 {
 
@@ -388,142 +628,193 @@ uint32_t latLongDoubleToFixed(double value)
 	return fixedVal;
 }
 
-double distanceToLocation(double latitude, double longitude)
+static uint32_t isqrt64(uint64_t value)
 {
-	double lat1 = latitude;
-	double lon1 = longitude;
-	double lat2 = latLongFixedToDouble(nonVolatileSettings.locationLat);
-	double lon2 = latLongFixedToDouble(nonVolatileSettings.locationLon);
+	uint64_t result = 0;
+	uint64_t bit = 1ULL << 62;
 
-	double r = 6371; //radius of Earth (KM)
-	double p = 0.017453292519943295;//  Pi/180
-	double a = 0.5 - cos((lat2 - lat1)*p)/2 + cos(lat1 * p)*cos(lat2 * p) * (1 - cos((lon2 - lon1) * p )) / 2;
+	while (bit > value)
+	{
+		bit >>= 2;
+	}
 
-	double d = 2 * r * asin(sqrt(a));
-	return d;
-}
+	while (bit != 0)
+	{
+		if (value >= (result + bit))
+		{
+			value -= (result + bit);
+			result = (result >> 1) + bit;
+		}
+		else
+		{
+			result >>= 1;
+		}
+		bit >>= 2;
+	}
 
-static double roundPosition(double val)
-{
-	return ((double)((int)((val * 10000) + ((val > 0 ) ? 0.5:-0.5)))) / 10000;
+	return (uint32_t)result;
 }
-static void decodeGPSPosition(uint8_t *data, double *latitude, double *longitude)
+
+// Returns the distance (in km) between the given location (in micro degrees) and our location.
+// It uses the equirectangular projection, which is accurate enough for the QSO distances.
+uint32_t distanceToLocation(int32_t latitude, int32_t longitude)
 {
-#if 0
-	uint8_t errorI = (data[2U] & 0x0E) >> 1U;
-	const char* error;
-	switch (errorI) {
-	case 0U:
-		error = "< 2m";
-		break;
-	case 1U:
-		error = "< 20m";
-		break;
-	case 2U:
-		error = "< 200m";
-		break;
-	case 3U:
-		error = "< 2km";
-		break;
-	case 4U:
-		error = "< 20km";
-		break;
-	case 5U:
-		error = "< 200km";
-		break;
-	case 6U:
-		error = "> 200km";
-		break;
-	default:
-		error = "not known";
-		break;
+	int32_t lat2 = latLongFixedToMicroDegrees(nonVolatileSettings.locationLat);
+	int32_t lon2 = latLongFixedToMicroDegrees(nonVolatileSettings.locationLon);
+	int64_t dLat = lat2 - latitude;
+	int64_t dLon = lon2 - longitude;
+	// Mean latitude, in 1/100 degree
+	int64_t x = ((int64_t)latitude + lat2) / 20000;
+	// Bhaskara's approximation of cos(x), Q15
+	int64_t cosMeanLat = ((324000000 - (4 * x * x)) * 32768) / (324000000 + (x * x));
+
+	if (dLon > 180000000)
+	{
+		dLon -= 360000000;
 	}
-#endif
+	else if (dLon < -180000000)
+	{
+		dLon += 360000000;
+	}
+
+	dLon = (dLon * cosMeanLat) >> 15;
+
+	// 111.195 km per degree (Earth radius: 6371 km)
+	return (uint32_t)(((uint64_t)isqrt64((dLat * dLat) + (dLon * dLon)) * 111195) / 1000000000);
+}
 
+// Decodes the GPS embedded data directly to the packed last heard location format
+static void decodeGPSPosition(const uint8_t *data, int16_t *packedLatitude, int16_t *packedLongitude)
+{
+	// 25 bits longitude, in 360/2^25 degree units
 	int32_t longitudeI = ((data[2U] & 0x01U) << 31) | (data[3U] << 23) | (data[4U] << 15) | (data[5U] << 7);
 	longitudeI >>= 7;
 
+	// 24 bits latitude, in 180/2^24 degree units
 	int32_t latitudeI = (data[6U] << 24) | (data[7U] << 16) | (data[8U] << 8);
 	latitudeI >>= 8;
 
+	// Packed longitude is in 180/INT16_MAX degree units, and latitude in 90/INT16_MAX degree units
+	*packedLongitude = (int16_t)(((int64_t)longitudeI * INT16_MAX + ((longitudeI >= 0) ? (1 << 23) : -(1 << 23))) / (1 << 24));
+	*packedLatitude = (int16_t)(((int64_t)latitudeI * INT16_MAX + ((latitudeI >= 0) ? (1 << 22) : -(1 << 22))) / (1 << 23));
+}
 
-	double lon = ((double)longitudeI * 360.0F) / 33554432.0F;
-	double lat = ((double)latitudeI  * 180.0F) / 16777216.0F;
+static void talkerAliasDecoderReset(void)
+{
+	memset(&taDecoder, 0, sizeof(talkerAliasDecoder_t));
+}
 
-	*longitude = roundPosition(lon);
-	*latitude =  roundPosition(lat);
+static bool talkerAliasDecoderHasBytes(int firstByte, int lastByte)
+{
+	return (((taDecoder.blocks & (1 << (firstByte / TALKER_ALIAS_BLOCK_LENGTH))) != 0) &&
+			((taDecoder.blocks & (1 << (lastByte / TALKER_ALIAS_BLOCK_LENGTH))) != 0));
 }
 
-static uint8_t *decodeTA(uint8_t *TA)
+// Stores a TA block (ID 0..3) and decodes the characters that became available.
+// Returns true when new characters are appended to the decoded TA.
+static bool talkerAliasDecoderPushBlock(uint8_t blockID, const uint8_t *data)
 {
-	uint8_t *b;
-	uint8_t c;
-	int8_t j;
-	uint8_t i, t1, t2;
-	static uint8_t buffer[32];
-	uint8_t *talkerAlias = TA;
-	uint8_t TAformat = (talkerAlias[0] >> 6U) & 0x03U;
-	uint8_t TAsize   = (talkerAlias[0] >> 1U) & 0x1FU;
+	// The TA header has changed, restart the decoding
+	if ((blockID == 0) && ((taDecoder.blocks & 0x01) != 0) && (taDecoder.buffer[0] != data[0]))
+	{
+		talkerAliasDecoderReset();
+		taDecoder.override = true;
+	}
+
+	if ((taDecoder.blocks & (1 << blockID)) != 0)
+	{
+		return false;
+	}
+
+	memcpy(&taDecoder.buffer[blockID * TALKER_ALIAS_BLOCK_LENGTH], data, TALKER_ALIAS_BLOCK_LENGTH);
+	taDecoder.blocks |= (1 << blockID);
 
-	switch (TAformat)
+	// Format and length infos are in the header
+	if (((taDecoder.blocks & 0x01) == 0) || (taDecoder.buffer[0] == 0))
 	{
-	case 0U:		// 7 bit
-	memset(&buffer, 0, sizeof(buffer));
-	b = &talkerAlias[0];
-	t1 = 0U; t2 = 0U; c = 0U;
+		return false;
+	}
+
+	uint8_t format = (taDecoder.buffer[0] >> 6U) & 0x03U;
+	int size = (taDecoder.buffer[0] >> 1U) & 0x1FU;
+	int maxSize;
+
+	switch (format)
+	{
+		case 0U: // 7 bit, first character starts at bit 7
+			maxSize = (((TALKER_ALIAS_BUFFER_LENGTH * 8) - 7) / 7);
+			break;
+		case 1U: // ISO 8 bit
+		case 2U: // UTF8
+			maxSize = (TALKER_ALIAS_BUFFER_LENGTH - 1);
+			break;
+		default: // UTF16 poor man's conversion
+			maxSize = ((TALKER_ALIAS_BUFFER_LENGTH - 1) / 2);
+			break;
+	}
+	size = SAFE_MIN(size, SAFE_MIN(maxSize, (LASTHEARD_TALKER_ALIAS_LENGTH - 1)));
 
-	for (i = 0U; (i < 32U) && (t2 < TAsize); i++)
+	for (int i = 0; i < size; i++)
 	{
-		for (j = 7; j >= 0; j--)
+		if ((taDecoder.decodedChars & (1U << i)) != 0)
 		{
-			c = (c << 1U) | (b[i] >> j);
+			continue;
+		}
 
-			if (++t1 == 7U)
+		switch (format)
+		{
+			case 0U:
 			{
-				if (i > 0U)
+				int bitPos = 7 + (i * 7);
+				int byte = bitPos / 8;
+
+				if (talkerAliasDecoderHasBytes(byte, ((bitPos + 6) / 8)))
 				{
-					buffer[t2++] = c & 0x7FU;
-				}
+					uint16_t w = (taDecoder.buffer[byte] << 8) | (((byte + 1) < TALKER_ALIAS_BUFFER_LENGTH) ? taDecoder.buffer[byte + 1] : 0);
 
-				t1 = 0U;
-				c = 0U;
+					taDecoder.text[i] = (w >> (9 - (bitPos % 8))) & 0x7FU;
+					taDecoder.decodedChars |= (1U << i);
+				}
 			}
+			break;
+
+			case 1U:
+			case 2U:
+				if (talkerAliasDecoderHasBytes((1 + i), (1 + i)))
+				{
+					taDecoder.text[i] = taDecoder.buffer[1 + i];
+					taDecoder.decodedChars |= (1U << i);
+				}
+				break;
+
+			default:
+				if (talkerAliasDecoderHasBytes((1 + (2 * i)), (2 + (2 * i))))
+				{
+					taDecoder.text[i] = ((taDecoder.buffer[1 + (2 * i)] == 0) ? taDecoder.buffer[2 + (2 * i)] : '?');
+					taDecoder.decodedChars |= (1U << i);
+				}
+				break;
 		}
 	}
-	buffer[TAsize] = 0;
-	break;
 
-	case 1U:		// ISO 8 bit
-	case 2U:		// UTF8
-		memcpy(&buffer, talkerAlias + 1U, sizeof(buffer));
-		break;
+	int length = taDecoder.length;
+	while ((length < size) && ((taDecoder.decodedChars & (1U << length)) != 0))
+	{
+		length++;
+	}
 
-	case 3U:		// UTF16 poor man's conversion
-		t2=0;
-		memset(&buffer, 0, sizeof(buffer));
-		for (i = 0U; (i < 15U) && (t2 < TAsize); i++)
-		{
-			if (talkerAlias[2U * i + 1U] == 0)
-			{
-				buffer[t2++] = talkerAlias[2U * i + 2U];
-			}
-			else
-			{
-				buffer[t2++] = '?';
-			}
-		}
-		buffer[TAsize] = 0;
-		break;
+	if (length > taDecoder.length)
+	{
+		taDecoder.length = length;
+		return true;
 	}
 
-	return &buffer[0];
+	return false;
 }
 
 void lastHeardClearLastID(void)
 {
-	memset(bufferTA, 0, 32);// Clear any TA data in TA buffer (used for decode)
-	blocksTA = 0x00;
-	overrideTA = false;
+	talkerAliasDecoderReset();
 	contactDefinedForTA = false;
 	lastID = 0;
 }
@@ -533,6 +824,11 @@ static void updateLHItem(LinkItem_t *item)
 	static const int bufferLen = 33; // displayChannelNameOrRxFrequency() use 6x8 font
 	char buffer[bufferLen];// buffer passed to the DMR ID lookup function, needs to be large enough to hold worst case text length that is returned. Currently 16+1
 	dmrIdDataStruct_t currentRec;
+	char contact[MAX_DMR_ID_CONTACT_TEXT_LENGTH];
+	char talkgroup[SCREEN_LINE_BUFFER_SIZE];
+
+	contact[0] = 0;
+	talkgroup[0] = 0;
 
 	if ((item->talkGroupOrPcId >> 24) == PC_CALL_FLAG)
 	{
@@ -543,12 +839,12 @@ static void updateLHItem(LinkItem_t *item)
 		case CONTACT_DISPLAY_PRIO_TA_CC_DB:
 			if (contactIDLookup(item->id, CONTACT_CALLTYPE_PC, buffer) == true)
 			{
-				snprintf(item->contact, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
+				snprintf(contact, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
 			}
 			else
 			{
 				dmrIDLookup(item->id, &currentRec);
-				snprintf(item->contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
+				snprintf(contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
 			}
 			break;
 
@@ -556,17 +852,17 @@ static void updateLHItem(LinkItem_t *item)
 		case CONTACT_DISPLAY_PRIO_TA_DB_CC:
 			if (dmrIDLookup(item->id, &currentRec) == true)
 			{
-				snprintf(item->contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
+				snprintf(contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
 			}
 			else
 			{
 				if (contactIDLookup(item->id, CONTACT_CALLTYPE_PC, buffer) == true)
 				{
-					snprintf(item->contact, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
+					snprintf(contact, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
 				}
 				else
 				{
-					snprintf(item->contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
+					snprintf(contact, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
 				}
 			}
 			break;
@@ -576,12 +872,12 @@ static void updateLHItem(LinkItem_t *item)
 		{
 			if (contactIDLookup(item->talkGroupOrPcId & 0x00FFFFFF, CONTACT_CALLTYPE_PC, buffer) == true)
 			{
-				snprintf(item->talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
+				snprintf(talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
 			}
 			else
 			{
 				dmrIDLookup(item->talkGroupOrPcId & 0x00FFFFFF, &currentRec);
-				snprintf(item->talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
+				snprintf(talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", currentRec.text);
 			}
 		}
 	}
@@ -590,17 +886,17 @@ static void updateLHItem(LinkItem_t *item)
 		// TalkGroup
 		if (contactIDLookup(item->talkGroupOrPcId, CONTACT_CALLTYPE_TG, buffer) == true)
 		{
-			snprintf(item->talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
+			snprintf(talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", buffer);
 		}
 		else
 		{
 			if ((item->talkGroupOrPcId & 0x00FFFFFF) == ALL_CALL_VALUE)
 			{
-				snprintf(item->talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", currentLanguage->all_call);
+				snprintf(talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s", currentLanguage->all_call);
 			}
 			else
 			{
-				snprintf(item->talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s %u", currentLanguage->tg, (item->talkGroupOrPcId & 0x00FFFFFF));
+				snprintf(talkgroup, SCREEN_LINE_BUFFER_SIZE, "%s %u", currentLanguage->tg, (item->talkGroupOrPcId & 0x00FFFFFF));
 			}
 		}
 
@@ -610,12 +906,12 @@ static void updateLHItem(LinkItem_t *item)
 		case CONTACT_DISPLAY_PRIO_TA_CC_DB:
 			if (contactIDLookup(item->id, CONTACT_CALLTYPE_PC, buffer) == true)
 			{
-				snprintf(item->contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", buffer);
+				snprintf(contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", buffer);
 			}
 			else
 			{
 				dmrIDLookup((item->id & 0x00FFFFFF), &currentRec);
-				snprintf(item->contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
+				snprintf(contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
 			}
 			break;
 
@@ -623,29 +919,35 @@ static void updateLHItem(LinkItem_t *item)
 		case CONTACT_DISPLAY_PRIO_TA_DB_CC:
 			if (dmrIDLookup((item->id & 0x00FFFFFF), &currentRec) == true)
 			{
-				snprintf(item->contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
+				snprintf(contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
 			}
 			else
 			{
 				if (contactIDLookup(item->id, CONTACT_CALLTYPE_PC, buffer) == true)
 				{
-					snprintf(item->contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", buffer);
+					snprintf(contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", buffer);
 				}
 				else
 				{
-					snprintf(item->contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
+					snprintf(contact, MAX_DMR_ID_CONTACT_TEXT_LENGTH, "%s", currentRec.text);
 				}
 			}
 			break;
 		}
 	}
+
+	lastheardSetContact(item, contact);
+
+	// The talkgroup isn't updated on private calls to ourself
+	if (item->talkGroupOrPcId != (trxDMRID | (PC_CALL_FLAG << 24)))
+	{
+		lastheardSetTalkgroup(item, talkgroup);
+	}
 }
 
 void lastHeardClearWorkingTAData(void)
 {
-	memset(bufferTA, 0, 32);// Clear any TA data in TA buffer (used for decode)
-	blocksTA = 0x00;
-	overrideTA = false;
+	talkerAliasDecoderReset();
 	contactDefinedForTA = false;
 }
 bool lastHeardListUpdate(uint8_t *dmrDataBuffer, bool forceOnHotspot)
@@ -747,11 +1049,9 @@ bool lastHeardListUpdate(uint8_t *dmrDataBuffer, bool forceOnHotspot)
 						dmrRxAGCrxPeakAverage = item->rxAGCGain = DMR_RX_AGC_DEFAULT_PEAK_SAMPLES;
 						lastTG = talkGroupOrPcId;
 
-						memset(item->contact, 0, sizeof(item->contact)); // Clear contact's datas
-						memset(item->talkgroup, 0, sizeof(item->talkgroup));
-						memset(item->talkerAlias, 0, sizeof(item->talkerAlias));
-						item->locationLat = NAN;
-						item->locationLon = NAN;
+						lastheardReleaseItemStrings(item); // Clear contact's datas
+						item->locationLat = LASTHEARD_NO_LOCATION;
+						item->locationLon = 0;
 
 						updateLHItem(item);
 
@@ -801,88 +1101,51 @@ bool lastHeardListUpdate(uint8_t *dmrDataBuffer, bool forceOnHotspot)
 					if (blockID < 4) // ID 0x04..0x07: TA
 					{
 
-						// Already stored first byte in block TA Header has changed, lets clear other blocks too
-						if ((blockID == 0) && ((blocksTA & (1 << blockID)) != 0) &&
-								(bufferTA[0] != (forceOnHotspot ? dmrDataBuffer[2] : DMR_frame_buffer[2])))
+						if (talkerAliasDecoderPushBlock(blockID, (forceOnHotspot ? &dmrDataBuffer[2] : (uint8_t *)&DMR_frame_buffer[2])))
 						{
-							blocksTA &= ~(1 << 0);
-
-							// Clear all other blocks if they're already stored
-							if ((blocksTA & (1 << 1)) != 0)
-							{
-								blocksTA &= ~(1 << 1);
-								memset(bufferTA + 7, 0, 7); // Clear 2nd TA block
-							}
-							if ((blocksTA & (1 << 2)) != 0)
-							{
-								blocksTA &= ~(1 << 2);
-								memset(bufferTA + 14, 0, 7); // Clear 3rd TA block
-							}
-							if ((blocksTA & (1 << 3)) != 0)
+							// TAs doesn't match, update contact and screen.
+							if (taDecoder.override || (strlen(taDecoder.text) > strlen(lastheardGetTalkerAlias(LinkHead))))
 							{
-								blocksTA &= ~(1 << 3);
-								memset(bufferTA + 21, 0, 7); // Clear 4th TA block
-							}
-							overrideTA = true;
-						}
-
-						// We don't already have this TA block
-						if ((blocksTA & (1 << blockID)) == 0)
-						{
-							static const uint8_t blockLen = 7;
-							uint32_t blockOffset = blockID * blockLen;
+								char talkerAlias[LASTHEARD_TALKER_ALIAS_LENGTH];
 
-							blocksTA |= (1 << blockID);
+								memcpy(talkerAlias, taDecoder.text, LASTHEARD_TALKER_ALIAS_LENGTH);
 
-							if ((blockOffset + blockLen) < sizeof(bufferTA))
-							{
-								memcpy(bufferTA + blockOffset, (void *)(forceOnHotspot ? &dmrDataBuffer[2] : &DMR_frame_buffer[2]), blockLen);
-
-								// Format and length infos are available, we can decode now
-								if (bufferTA[0] != 0x0)
+								if ((taDecoder.blocks & (1 << 1)) != 0) // we already received the 2nd TA block, check for 'DMR ID:'
 								{
-									uint8_t *decodedTA;
+									char *p = NULL;
 
-									if ((decodedTA = decodeTA(&bufferTA[0])) != NULL)
+									// Get rid of 'DMR ID:xxxxxxx' part of the TA, sent by BM
+									if (((p = strstr(&talkerAlias[0], "DMR ID:")) != NULL) || ((p = strstr(&talkerAlias[0], "DMR I")) != NULL))
 									{
-										// TAs doesn't match, update contact and screen.
-										if (overrideTA || (strlen((const char *)decodedTA) > strlen((const char *)&LinkHead->talkerAlias)))
-										{
-											memcpy(&LinkHead->talkerAlias, decodedTA, 31);// Brandmeister seems to send callsign as 6 chars only
-
-											if ((blocksTA & (1 << 1)) != 0) // we already received the 2nd TA block, check for 'DMR ID:'
-											{
-												char *p = NULL;
-
-												// Get rid of 'DMR ID:xxxxxxx' part of the TA, sent by BM
-												if (((p = strstr(&LinkHead->talkerAlias[0], "DMR ID:")) != NULL) || ((p = strstr(&LinkHead->talkerAlias[0], "DMR I")) != NULL))
-												{
-													*p = 0;
-												}
-											}
-
-											overrideTA = false;
-											uiDataGlobal.displayQSOState = QSO_DISPLAY_CALLER_DATA;
-										}
+										*p = 0;
 									}
 								}
+
+								lastheardSetTalkerAlias(LinkHead, talkerAlias);
+
+								taDecoder.override = false;
+								uiDataGlobal.displayQSOState = QSO_DISPLAY_CALLER_DATA;
 							}
 						}
 					}
 					else if (blockID == 4) // ID 0x08: GPS
 					{
-						double longitude, latitude;
-						decodeGPSPosition((uint8_t *)(forceOnHotspot ? &dmrDataBuffer[0] : &DMR_frame_buffer[0]), &latitude,&longitude);
+						int16_t packedLatitude, packedLongitude;
+
+						decodeGPSPosition((forceOnHotspot ? &dmrDataBuffer[0] : (uint8_t *)&DMR_frame_buffer[0]), &packedLatitude, &packedLongitude);
 
-						if ((LinkHead->locationLat != latitude) || (LinkHead->locationLon != longitude))
+						if ((LinkHead->locationLat != packedLatitude) || (LinkHead->locationLon != packedLongitude))
 						{
-							LinkHead->locationLat = latitude;
-							LinkHead->locationLon = longitude;
+							LinkHead->locationLat = packedLatitude;
+							LinkHead->locationLon = packedLongitude;
 
 							// If we received the location but no TA text, then insert ID:xxxxx so that the rest of the QSO display system works and displays the maindenhead
-							if (LinkHead->talkerAlias[0] == 0x00)
+							if (LinkHead->talkerAlias == 0)
 							{
-								snprintf(LinkHead->talkerAlias, 16, "ID:%u", LinkHead->id);
+								char talkerAlias[16];
+
+								snprintf(talkerAlias, 16, "ID:%u", LinkHead->id);
+								lastheardSetTalkerAlias(LinkHead, talkerAlias);
 							}
 
 							uiDataGlobal.displayQSOState = QSO_DISPLAY_CALLER_DATA_UPDATE;
@@ -901,6 +1164,15 @@ static bool dmrIDReadContactInFlash(uint32_t contactOffset, uint8_t *data, uint3
 {
 	uint32_t address;
 
+	// Only the callsign index entries can span both storage locations
+	if ((contactOffset < dmrIdDataArea_1_Size) && ((contactOffset + len) > dmrIdDataArea_1_Size))
+	{
+		uint32_t firstLength = (dmrIdDataArea_1_Size - contactOffset);
+
+		return (dmrIDReadContactInFlash(contactOffset, data, firstLength) &&
+				dmrIDReadContactInFlash(dmrIdDataArea_1_Size, (data + firstLength), (len - firstLength)));
+	}
+
 	if (contactOffset >= dmrIdDataArea_1_Size)
 	{
 		address = dmrIDDatabaseMemoryLocation2 + (contactOffset - dmrIdDataArea_1_Size);
@@ -919,6 +1191,7 @@ void dmrIDCacheInit(void)
 
 	memset(&dmrIDsCache, 0, sizeof(dmrIDsCache_t));
 	memset(&headerBuf, 0, sizeof(headerBuf));
+	dmrIDsCacheIsReady = true;
 
 	SPI_Flash_read(DMRID_MEMORY_LOCATION_1, headerBuf, DMRID_HEADER_LENGTH);
 
@@ -977,6 +1250,16 @@ void dmrIDCacheInit(void)
 				dmrIDsCache.slices[i + 1] = dmrIDContact.id;
 			}
 		}
+
+		uint8_t indexHeader[DMRID_CALLSIGN_INDEX_HEADER_LENGTH];
+		uint32_t indexOffset = (dmrIDsCache.contactLength * dmrIDsCache.entries);
+
+		if (dmrIDReadContactInFlash(indexOffset, indexHeader, DMRID_CALLSIGN_INDEX_HEADER_LENGTH) &&
+				(memcmp(indexHeader, DMRID_CALLSIGN_INDEX_MAGIC, 4) == 0) &&
+				(((uint32_t)indexHeader[4] | (uint32_t)indexHeader[5] << 8 | (uint32_t)indexHeader[6] << 16 | (uint32_t)indexHeader[7] << 24) == dmrIDsCache.entries))
+		{
+			dmrIDsCache.callsignIndexOffset = indexOffset;
+		}
 	}
 }
 
@@ -1018,10 +1301,21 @@ static void dmrDbTextDecode(uint8_t *decompressedBufOut, uint8_t *compressedBufI
 	}
 }
 
+bool dmrIDCacheIsReady(void)
+{
+	return dmrIDsCacheIsReady;
+}
+
 bool dmrIDLookup(uint32_t targetId, dmrIdDataStruct_t *foundRecord)
 {
 	uint32_t targetIdBCD;
 
+	// Cache not ready yet, build it now (it's only a few Flash reads)
+	if (dmrIDsCacheIsReady == false)
+	{
+		dmrIDCacheInit();
+	}
+
 	if (DMRID_IdLength == 4U)
 	{
 		targetIdBCD = int2bcd(targetId);
@@ -1155,6 +1449,78 @@ bool dmrIDLookup(uint32_t targetId, dmrIdDataStruct_t *foundRecord)
 	return false;
 }
 
+// Reads the record at callsign index position, and returns its callsign (nameIndexReadName_t)
+static bool dmrIDCallsignIndexReadName(void *context, uint32_t position, char *name, int nameLength)
+{
+	dmrIdDataStruct_t *record = (dmrIdDataStruct_t *)context;
+	uint8_t compressedBuf[MAX_DMR_ID_CONTACT_TEXT_LENGTH];
+	uint8_t entryBuf[DMRID_CALLSIGN_INDEX_ENTRY_LENGTH];
+	uint32_t recordNumber;
+
+	if (dmrIDReadContactInFlash((dmrIDsCache.callsignIndexOffset + DMRID_CALLSIGN_INDEX_HEADER_LENGTH + (position * DMRID_CALLSIGN_INDEX_ENTRY_LENGTH)),
+			entryBuf, DMRID_CALLSIGN_INDEX_ENTRY_LENGTH) == false)
+	{
+		return false;
+	}
+
+	recordNumber = ((uint32_t)entryBuf[0] | (uint32_t)entryBuf[1] << 8 | (uint32_t)entryBuf[2] << 16);
+	if (recordNumber >= dmrIDsCache.entries)
+	{
+		return false;
+	}
+
+	record->id = 0;
+	memset(record->text, 0, sizeof(record->text));
+	if ((dmrIDReadContactInFlash((dmrIDsCache.contactLength * recordNumber), (uint8_t *)&record->id, DMRID_IdLength) == false) ||
+			(dmrIDReadContactInFlash((dmrIDsCache.contactLength * recordNumber) + DMRID_IdLength, compressedBuf, (dmrIDsCache.contactLength - DMRID_IdLength)) == false))
+	{
+		return false;
+	}
+
+	if (DMRID_IdLength == 3U)
+	{
+		dmrDbTextDecode((uint8_t *)record->text, compressedBuf, (dmrIDsCache.contactLength - DMRID_IdLength));
+	}
+	else
+	{
+		memcpy((uint8_t *)record->text, compressedBuf, (dmrIDsCache.contactLength - DMRID_IdLength));
+	}
+
+	for (int i = 0; (i < nameLength) && (record->text[i] != 0) && (record->text[i] != ' '); i++)
+	{
+		name[i] = record->text[i];
+	}
+
+	return true;
+}
+
+// Finds the first record (in callsign order) whose callsign starts with prefix, using the callsign index.
+// foundRecord->id is the DMR ID (not BCD encoded).
+bool dmrIDLookupByCallsignPrefix(const char *prefix, dmrIdDataStruct_t *foundRecord)
+{
+	char callsign[MAX_DMR_ID_CONTACT_TEXT_LENGTH];
+	int32_t position;
+
+	if (dmrIDsCacheIsReady == false)
+	{
+		dmrIDCacheInit();
+	}
+
+	if ((dmrIDsCache.callsignIndexOffset == 0) ||
+			((position = nameIndexSearchSorted(dmrIDsCache.entries, prefix, dmrIDCallsignIndexReadName, foundRecord)) < 0) ||
+			(dmrIDCallsignIndexReadName(foundRecord, position, callsign, (sizeof(callsign) - 1)) == false))
+	{
+		return false;
+	}
+
+	if (DMRID_IdLength == 4U)
+	{
+		foundRecord->id = bcd2int(foundRecord->id);
+	}
+
+	return true;
+}
+
 bool contactIDLookup(uint32_t id, uint32_t calltype, char *buffer)
 {
 	struct_codeplugContact_t contact;
@@ -1279,30 +1645,32 @@ static void displaySplitOrSpanText(uint8_t y, char *text)
  * We don't care if extra text is larger than 16 chars, ucPrint*() functions cut them.
  *.
  */
-static void displayContactTextInfos(char *text, size_t maxLen, bool isFromTalkerAlias)
+static void displayContactTextInfos(const char *text, size_t maxLen, bool isFromTalkerAlias)
 {
 	// Max for TalkerAlias is 37: TA 27 (in 7bit format) + ' [' + 6 (Maidenhead)  + ']' + NULL
 	// Max for DMRID Database is MAX_DMR_ID_CONTACT_TEXT_LENGTH (50 + NULL)
 	char buffer[MAX_DMR_ID_CONTACT_TEXT_LENGTH];
+	// The text may be stored in the last heard strings pool, never copy past its end
+	int32_t textLength = strnlen(text, SAFE_MIN(maxLen, sizeof(buffer)) - 1);
 
-	if (strlen(text) >= 5 && isFromTalkerAlias) // if it's Talker Alias and there is more text than just the callsign, split across 2 lines
+	if (textLength >= 5 && isFromTalkerAlias) // if it's Talker Alias and there is more text than just the callsign, split across 2 lines
 	{
 		char    *pbuf;
 		int32_t  cpos;
 
 		// User prefers to not span the TA info over two lines, check it that could fit
 		if ((nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY) ||
-				((nonVolatileSettings.splitContact == SPLIT_CONTACT_AUTO) && (strlen(text) <= 16)))
+				((nonVolatileSettings.splitContact == SPLIT_CONTACT_AUTO) && (textLength <= 16)))
 		{
-			memcpy(buffer, text, 16);
-			buffer[16] = 0;
+			memcpy(buffer, text, SAFE_MIN(textLength, 16));
+			buffer[SAFE_MIN(textLength, 16)] = 0;
 
 			uiUtilityDisplayInformation(chomp(buffer), DISPLAY_INFO_CHANNEL, -1);
 			displayChannelNameOrRxFrequency(buffer, (sizeof(buffer) / sizeof(buffer[0])));
 			return;
 		}
 
-		if ((cpos = getFirstSpacePos(text)) != -1)
+		if (((cpos = getFirstSpacePos(text)) != -1) && (cpos < textLength))
 		{
 			// Callsign found
 			memcpy(buffer, text, cpos);
@@ -1310,8 +1678,8 @@ static void displayContactTextInfos(char *text, size_t maxLen, bool isFromTalker
 
 			uiUtilityDisplayInformation(chomp(buffer), DISPLAY_INFO_CHANNEL, -1);
 
-			memcpy(buffer, text + (cpos + 1), (maxLen - (cpos + 1)));
-			buffer[(maxLen - (cpos + 1))] = 0;
+			memcpy(buffer, text + (cpos + 1), (textLength - (cpos + 1)));
+			buffer[(textLength - (cpos + 1))] = 0;
 
 			pbuf = chomp(buffer);
 
@@ -1327,13 +1695,20 @@ static void displayContactTextInfos(char *text, size_t maxLen, bool isFromTalker
 		else
 		{
 			// No space found, use a chainsaw
-			memcpy(buffer, text, 16);
-			buffer[16] = 0;
+			memcpy(buffer, text, SAFE_MIN(textLength, 16));
+			buffer[SAFE_MIN(textLength, 16)] = 0;
 
 			uiUtilityDisplayInformation(chomp(buffer), DISPLAY_INFO_CHANNEL, -1);
 
-			memcpy(buffer, text + 16, (maxLen - 16));
-			buffer[(strlen(text) - 16)] = 0;
+			if (textLength > 16)
+			{
+				memcpy(buffer, text + 16, (textLength - 16));
+				buffer[(textLength - 16)] = 0;
+			}
+			else
+			{
+				buffer[0] = 0;
+			}
 
 			pbuf = chomp(buffer);
 
@@ -1349,8 +1724,8 @@ static void displayContactTextInfos(char *text, size_t maxLen, bool isFromTalker
 	}
 	else
 	{
-		memcpy(buffer, text, 16);
-		buffer[16] = 0;
+		memcpy(buffer, text, SAFE_MIN(textLength, 16));
+		buffer[SAFE_MIN(textLength, 16)] = 0;
 
 		uiUtilityDisplayInformation(chomp(buffer), DISPLAY_INFO_CHANNEL, -1);
 		displayChannelNameOrRxFrequency(buffer, (sizeof(buffer) / sizeof(buffer[0])));
@@ -1477,24 +1852,25 @@ void uiUtilityRenderQSOData(void)
 		if ((LinkHead->talkGroupOrPcId >> 24) == PC_CALL_FLAG) // &&  (LinkHead->id & 0xFFFFFF) != (trxTalkGroupOrPcId & 0xFFFFFF))
 		{
 			// Its a Private call
-			displayPrintCentered(16, LinkHead->contact, FONT_SIZE_3);
+			displayPrintCentered(16, lastheardGetContact(LinkHead), FONT_SIZE_3);
 
 			displayPrintCentered(DISPLAY_Y_POS_CHANNEL_FIRST_LINE, currentLanguage->private_call, FONT_SIZE_3);
 
 			if (LinkHead->talkGroupOrPcId != (trxDMRID | (PC_CALL_FLAG << 24)))
 			{
-				uiUtilityDisplayInformation((((LinkHead->talkGroupOrPcId & 0x00FFFFFF) == ALL_CALL_VALUE) ? currentLanguage->all_call : LinkHead->talkgroup), DISPLAY_INFO_ZONE, -1);
+				uiUtilityDisplayInformation((((LinkHead->talkGroupOrPcId & 0x00FFFFFF) == ALL_CALL_VALUE) ? currentLanguage->all_call : lastheardGetTalkgroup(LinkHead)), DISPLAY_INFO_ZONE, -1);
 				displayPrintAt(1, DISPLAY_Y_POS_ZONE, "=>", FONT_SIZE_1);
 			}
 		}
 		else
 		{
 			// Group call
+			int32_t latitude, longitude;
 			bool different = (((LinkHead->talkGroupOrPcId & 0xFFFFFF) != trxTalkGroupOrPcId ) ||
 					(((trxDMRModeRx != DMR_MODE_DMO) && (dmrMonitorCapturedTS != -1)) && (dmrMonitorCapturedTS != trxGetDMRTimeSlot())) ||
 					(trxGetDMRColourCode() != currentChannelData->txColor));
 
-			uiUtilityDisplayInformation(LinkHead->talkgroup, different ? DISPLAY_INFO_CONTACT_INVERTED : DISPLAY_INFO_CONTACT, -1);
+			uiUtilityDisplayInformation(lastheardGetTalkgroup(LinkHead), different ? DISPLAY_INFO_CONTACT_INVERTED : DISPLAY_INFO_CONTACT, -1);
 
 			// If voice prompt feedback is enabled. Play a short beep to indicate the inverse video display showing the TG / TS / CC does not match the current Tx config
 			if (different && nonVolatileSettings.audioPromptMode >= AUDIO_PROMPT_MODE_VOICE_LEVEL_2)
@@ -1507,54 +1883,54 @@ void uiUtilityRenderQSOData(void)
 			case CONTACT_DISPLAY_PRIO_CC_DB_TA:
 			case CONTACT_DISPLAY_PRIO_DB_CC_TA:
 				// No contact found in codeplug and DMRIDs, use TA as fallback, if any.
-				if ((strncmp(LinkHead->contact, "ID:", 3) == 0) && (LinkHead->talkerAlias[0] != 0x00))
+				if ((strncmp(lastheardGetContact(LinkHead), "ID:", 3) == 0) && (LinkHead->talkerAlias != 0))
 				{
-					if (LinkHead->locationLat <= 90)
+					if (lastheardGetLocation(LinkHead, &latitude, &longitude))
 					{
 						char tmpBufferTA[37]; // TA + ' [' + Maidenhead + ']' + NULL
 
 						memset(tmpBufferTA, 0, sizeof(tmpBufferTA));
 						char maidenheadBuffer[8];
 
-						coordsToMaidenhead((uint8_t *)maidenheadBuffer, LinkHead->locationLat, LinkHead->locationLon);
-						snprintf(tmpBufferTA, 37, "%s [%s]", LinkHead->talkerAlias, maidenheadBuffer);
+						coordsToMaidenhead((uint8_t *)maidenheadBuffer, latitude, longitude);
+						snprintf(tmpBufferTA, 37, "%s [%s]", lastheardGetTalkerAlias(LinkHead), maidenheadBuffer);
 						displayContactTextInfos(tmpBufferTA, sizeof(tmpBufferTA), true);
 					}
 					else
 					{
-						displayContactTextInfos(LinkHead->talkerAlias, sizeof(LinkHead->talkerAlias), !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
+						displayContactTextInfos(lastheardGetTalkerAlias(LinkHead), LASTHEARD_TALKER_ALIAS_LENGTH, !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
 					}
 				}
 				else
 				{
-					displayContactTextInfos(LinkHead->contact, sizeof(LinkHead->contact), !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
+					displayContactTextInfos(lastheardGetContact(LinkHead), MAX_DMR_ID_CONTACT_TEXT_LENGTH, !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
 				}
 				break;
 
 			case CONTACT_DISPLAY_PRIO_TA_CC_DB:
 			case CONTACT_DISPLAY_PRIO_TA_DB_CC:
 				// Talker Alias have the priority here
-				if (LinkHead->talkerAlias[0] != 0x00)
+				if (LinkHead->talkerAlias != 0)
 				{
-					if (LinkHead->locationLat <= 90)
+					if (lastheardGetLocation(LinkHead, &latitude, &longitude))
 					{
 						char tmpBufferTA[37]; // TA + ' [' + Maidenhead + ']' + NULL
 
 						memset(tmpBufferTA, 0, sizeof(tmpBufferTA));
 						char maidenheadBuffer[8];
 
-						coordsToMaidenhead((uint8_t *)maidenheadBuffer, LinkHead->locationLat, LinkHead->locationLon);
-						snprintf(tmpBufferTA, 37, "%s [%s]", LinkHead->talkerAlias, maidenheadBuffer);
+						coordsToMaidenhead((uint8_t *)maidenheadBuffer, latitude, longitude);
+						snprintf(tmpBufferTA, 37, "%s [%s]", lastheardGetTalkerAlias(LinkHead), maidenheadBuffer);
 						displayContactTextInfos(tmpBufferTA, sizeof(tmpBufferTA), true);
 					}
 					else
 					{
-						displayContactTextInfos(LinkHead->talkerAlias, sizeof(LinkHead->talkerAlias), !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
+						displayContactTextInfos(lastheardGetTalkerAlias(LinkHead), LASTHEARD_TALKER_ALIAS_LENGTH, !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
 					}
 				}
 				else // No TA, then use the one extracted from Codeplug or DMRIdDB
 				{
-					displayContactTextInfos(LinkHead->contact, sizeof(LinkHead->contact), !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
+					displayContactTextInfos(lastheardGetContact(LinkHead), MAX_DMR_ID_CONTACT_TEXT_LENGTH, !(nonVolatileSettings.splitContact == SPLIT_CONTACT_SINGLE_LINE_ONLY));
 				}
 				break;
 			}
@@ -1885,9 +2261,9 @@ void uiUtilityDrawRSSIBarGraph(void)
 
 void uiUtilityDrawFMMicLevelBarGraph(void)
 {
-	trxReadVoxAndMicStrength();
+	trxRadioStatusSampleIfOlderThan(TRX_RADIO_STATUS_VOX_MIC, TRX_RADIO_STATUS_MIC_MAX_AGE);
 
-	uint8_t micdB = (trxTxMic >> 1); // trxTxMic is in 0.5dB unit, displaying 50dB .. 100dB
+	uint8_t micdB = (trxRadioStatusGet()->mic >> 1); // mic is in 0.5dB unit, displaying 50dB .. 100dB
 	// display from 50dB to 100dB, span over 128pix
 	int barWidth = ((uint16_t)(((float)DISPLAY_SIZE_X / 50.0) * ((float)micdB - 50.0)));
 	drawHeaderBar(&barWidth, 3);
@@ -2583,9 +2959,9 @@ void uiUtilityBuildTgOrPCDisplayName(char *nameBuf, int bufferLen)
 			{
 				// check LastHeard for TA data.
 				LinkItem_t *item = lastheardFindInList(id);
-				if ((item != NULL) && (strlen(item->talkerAlias) != 0))
+				if ((item != NULL) && (item->talkerAlias != 0))
 				{
-					strncpy(nameBuf, item->talkerAlias, bufferLen);
+					strncpy(nameBuf, lastheardGetTalkerAlias(item), bufferLen);
 				}
 				else
 				{
@@ -3014,9 +3014,9 @@ static void sweepScanStep(void)
 
 		if (uiDataGlobal.Scan.sweepSampleIndex < VFO_SWEEP_NUM_SAMPLES)
 		{
-			radioReadRSSIAndNoise();
+			trxRadioStatusSample(TRX_RADIO_STATUS_RSSI_NOISE);
 
-			vfoSweepSamples[uiDataGlobal.Scan.sweepSampleIndex] = trxRxSignal;// Need to save the samples so for when the freq is changed and we need to scroll the display
+			vfoSweepSamples[uiDataGlobal.Scan.sweepSampleIndex] = trxRadioStatusGet()->rssi;// Need to save the samples so for when the freq is changed and we need to scroll the display
 
 			vfoSweepDrawSample(uiDataGlobal.Scan.sweepSampleIndex);
 
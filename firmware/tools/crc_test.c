@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2020-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host check of the CRC service (table driven backend): check vectors, streaming updates against a bitwise
+ * reference, and throughput.
+ *
+ * Build and run (from the firmware directory):
+ *   gcc -O2 -DCRC_SOFTWARE_BACKEND -Iinclude tools/crc_test.c source/interfaces/crc.c -o crc_test && ./crc_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "interfaces/crc.h"
+
+#define BENCHMARK_BUFFER_SIZE    (64 * 1024)
+#define BENCHMARK_LOOPS          256
+
+static int failures = 0;
+
+static void check(const char *name, uint32_t value, uint32_t expected)
+{
+	if (value != expected)
+	{
+		printf("FAIL %-40s 0x%08X (expected 0x%08X)\n", name, value, expected);
+		failures++;
+	}
+	else
+	{
+		printf("ok   %-40s 0x%08X\n", name, value);
+	}
+}
+
+static uint32_t referenceCCITT16(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFF;
+
+	while (length--)
+	{
+		crc ^= ((uint32_t)*data++ << 8);
+		for (int i = 0; i < 8; i++)
+		{
+			crc = ((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1)) & 0xFFFF;
+		}
+	}
+
+	return crc;
+}
+
+static uint32_t referenceCRC32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	while (length--)
+	{
+		crc ^= *data++;
+		for (int i = 0; i < 8; i++)
+		{
+			crc = ((crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1));
+		}
+	}
+
+	return (crc ^ 0xFFFFFFFF);
+}
+
+// Computes the CRC in chunks of chunkLength bytes
+static uint32_t crcComputeChunked(crcType_t type, const uint8_t *data, uint32_t length, uint32_t chunkLength)
+{
+	crcContext_t context;
+
+	crcStart(&context, type);
+	while (length > 0)
+	{
+		uint32_t n = ((length < chunkLength) ? length : chunkLength);
+
+		crcUpdate(&context, data, n);
+		data += n;
+		length -= n;
+	}
+
+	return crcFinish(&context);
+}
+
+static void checkVectors(void)
+{
+	const uint8_t checkString[] = "123456789";
+	// Embedded LC of a group call to TG 91 from ID 2345678
+	const uint8_t embeddedLC[9] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x5B, 0x23, 0xCA, 0xCE };
+	uint8_t data[1031];
+	char name[64];
+
+	check("CCITT16 \"123456789\"", crcCompute(CRC_TYPE_CCITT16, checkString, 9), 0x29B1);
+	check("CRC32 \"123456789\"", crcCompute(CRC_TYPE_CRC32, checkString, 9), 0xCBF43926);
+	check("CCITT16 empty", crcCompute(CRC_TYPE_CCITT16, checkString, 0), 0xFFFF);
+	check("CRC32 empty", crcCompute(CRC_TYPE_CRC32, checkString, 0), 0x00000000);
+	check("DMR embedded LC checksum", crcDMREmbeddedLCChecksum(embeddedLC), ((0x5B + 0x23 + 0xCA + 0xCE) % 31));
+
+	srand(1);
+	for (uint32_t i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (uint8_t)rand();
+	}
+
+	// Odd chunk lengths, as the hardware backend feeds 32 bits words and handles the remaining bytes separately
+	const uint32_t chunkLengths[] = { 1, 2, 3, 4, 5, 7, 64, 1031 };
+
+	for (uint32_t i = 0; i < (sizeof(chunkLengths) / sizeof(chunkLengths[0])); i++)
+	{
+		snprintf(name, sizeof(name), "CCITT16 1031 bytes, chunks of %u", chunkLengths[i]);
+		check(name, crcComputeChunked(CRC_TYPE_CCITT16, data, sizeof(data), chunkLengths[i]), referenceCCITT16(data, sizeof(data)));
+		snprintf(name, sizeof(name), "CRC32 1031 bytes, chunks of %u", chunkLengths[i]);
+		check(name, crcComputeChunked(CRC_TYPE_CRC32, data, sizeof(data), chunkLengths[i]), referenceCRC32(data, sizeof(data)));
+	}
+
+	// Interleaved computations
+	crcContext_t context16;
+	crcContext_t context32;
+
+	crcStart(&context16, CRC_TYPE_CCITT16);
+	crcStart(&context32, CRC_TYPE_CRC32);
+	for (uint32_t i = 0; i < sizeof(data); i += 100)
+	{
+		uint32_t n = (((sizeof(data) - i) < 100) ? (sizeof(data) - i) : 100);
+
+		crcUpdate(&context16, &data[i], n);
+		crcUpdate(&context32, &data[i], n);
+	}
+	check("CCITT16 interleaved", crcFinish(&context16), referenceCCITT16(data, sizeof(data)));
+	check("CRC32 interleaved", crcFinish(&context32), referenceCRC32(data, sizeof(data)));
+}
+
+static double benchmark(const char *name, crcType_t type, uint32_t (*function)(crcType_t, const uint8_t *, uint32_t), const uint8_t *data)
+{
+	volatile uint32_t result = 0;
+	clock_t start = clock();
+
+	for (int i = 0; i < BENCHMARK_LOOPS; i++)
+	{
+		result ^= function(type, data, BENCHMARK_BUFFER_SIZE);
+	}
+
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+	double mbPerSecond = (((double)BENCHMARK_BUFFER_SIZE * BENCHMARK_LOOPS) / (1024.0 * 1024.0)) / ((seconds > 0.0) ? seconds : 1e-9);
+
+	printf("%-24s %8.1f MB/s\n", name, mbPerSecond);
+
+	return mbPerSecond;
+}
+
+static uint32_t referenceCompute(crcType_t type, const uint8_t *data, uint32_t length)
+{
+	return ((type == CRC_TYPE_CRC32) ? referenceCRC32(data, length) : referenceCCITT16(data, length));
+}
+
+int main(void)
+{
+	static uint8_t buffer[BENCHMARK_BUFFER_SIZE];
+
+	checkVectors();
+
+	for (uint32_t i = 0; i < sizeof(buffer); i++)
+	{
+		buffer[i] = (uint8_t)(i * 31 + 7);
+	}
+
+	printf("\nThroughput (%u KB x %d):\n", (BENCHMARK_BUFFER_SIZE / 1024), BENCHMARK_LOOPS);
+	benchmark("CCITT16 table", CRC_TYPE_CCITT16, crcCompute, buffer);
+	benchmark("CCITT16 bitwise", CRC_TYPE_CCITT16, referenceCompute, buffer);
+	benchmark("CRC32 table", CRC_TYPE_CRC32, crcCompute, buffer);
+	benchmark("CRC32 bitwise", CRC_TYPE_CRC32, referenceCompute, buffer);
+
+	printf("\n%s (%d failure%s)\n", ((failures == 0) ? "PASS" : "FAIL"), failures, ((failures == 1) ? "" : "s"));
+
+	return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host generator of the language packs (see uiLocalisation.h for the format), built from the language headers
+ * of the firmware. English and Japanese are built in the firmware and have no pack.
+ *
+ * Build (from the firmware directory):
+ *   gcc -O2 -Iinclude tools/language_pack_generator.c -o language_pack_generator
+ *
+ * Usage:
+ *   language_pack_generator [-block] <output directory>
+ *
+ * One <language>.oglp file is written per language. With -block, each file starts with the header of the
+ * SPI Flash custom data block (type CODEPLUG_CUSTOM_DATA_TYPE_LANGUAGE_PACK, then the pack length, both as
+ * 32 bits little endian), ready to be appended to the custom data area by the CPS.
+ * Identical strings are only stored once. A pack whose texts don't fit in LANGUAGE_PACK_TEXTS_MAX_LENGTH
+ * is not written, and the program then exits with an error.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "user_interface/uiLocalisation.h"
+#include "user_interface/languages/catalan.h"
+#include "user_interface/languages/croatian.h"
+#include "user_interface/languages/czech.h"
+#include "user_interface/languages/danish.h"
+#include "user_interface/languages/dutch.h"
+#include "user_interface/languages/finnish.h"
+#include "user_interface/languages/french.h"
+#include "user_interface/languages/german.h"
+#include "user_interface/languages/hungarian.h"
+#include "user_interface/languages/italian.h"
+#include "user_interface/languages/polish.h"
+#include "user_interface/languages/portugues_brazil.h"
+#include "user_interface/languages/portuguese.h"
+#include "user_interface/languages/slovenian.h"
+#include "user_interface/languages/spanish.h"
+#include "user_interface/languages/swedish.h"
+#include "user_interface/languages/turkish.h"
+
+#define CUSTOM_DATA_TYPE_LANGUAGE_PACK    4 // CODEPLUG_CUSTOM_DATA_TYPE_LANGUAGE_PACK (codeplug.h)
+
+typedef struct
+{
+	languageId_t          id;
+	const stringsTable_t *table;
+	const char           *fileName;
+} languageSource_t;
+
+static const languageSource_t LANGUAGES[] =
+{
+	{ LANGUAGE_ID_CATALAN,           &catalanLanguage,         "catalan" },
+	{ LANGUAGE_ID_CROATIAN,          &croatianLanguage,        "croatian" },
+	{ LANGUAGE_ID_CZECH,             &czechLanguage,           "czech" },
+	{ LANGUAGE_ID_DANISH,            &danishLanguage,          "danish" },
+	{ LANGUAGE_ID_DUTCH,             &dutchLanguage,           "dutch" },
+	{ LANGUAGE_ID_FINNISH,           &finnishLanguage,         "finnish" },
+	{ LANGUAGE_ID_FRENCH,            &frenchLanguage,          "french" },
+	{ LANGUAGE_ID_GERMAN,            &germanLanguage,          "german" },
+	{ LANGUAGE_ID_HUNGARIAN,         &hungarianLanguage,       "hungarian" },
+	{ LANGUAGE_ID_ITALIAN,           &italianLanguage,         "italian" },
+	{ LANGUAGE_ID_POLISH,            &polishLanguage,          "polish" },
+	{ LANGUAGE_ID_PORTUGUESE_BRAZIL, &portuguesBrazilLanguage, "portuguese_brazil" },
+	{ LANGUAGE_ID_PORTUGUESE,        &portuguesLanguage,       "portuguese" },
+	{ LANGUAGE_ID_SLOVENIAN,         &slovenianLanguage,       "slovenian" },
+	{ LANGUAGE_ID_SPANISH,           &spanishLanguage,         "spanish" },
+	{ LANGUAGE_ID_SWEDISH,           &swedishLanguage,         "swedish" },
+	{ LANGUAGE_ID_TURKISH,           &turkishLanguage,         "turkish" },
+};
+
+static void putUint16(uint8_t *buf, uint32_t value)
+{
+	buf[0] = (value & 0xFF);
+	buf[1] = ((value >> 8) & 0xFF);
+}
+
+static void putUint32(uint8_t *buf, uint32_t value)
+{
+	putUint16(buf, value);
+	putUint16(&buf[2], (value >> 16));
+}
+
+// Builds the pack in buf, returns its length, or 0 if the texts are too long
+static int languagePackBuild(const languageSource_t *language, uint8_t *buf)
+{
+	const char * const *strings = (const char * const *)language->table;
+	uint8_t *offsets = &buf[sizeof(languagePackHeader_t)];
+	char *texts = (char *)&offsets[LANGUAGE_STRINGS_COUNT * sizeof(uint16_t)];
+	uint16_t stringOffsets[LANGUAGE_STRINGS_COUNT];
+	int textsLength = 0;
+
+	for (unsigned int i = 0; i < LANGUAGE_STRINGS_COUNT; i++)
+	{
+		const char *string = ((strings[i] != NULL) ? strings[i] : "");
+		int length = strlen(string) + 1;
+		unsigned int j;
+
+		// Same text as a previous string
+		for (j = 0; j < i; j++)
+		{
+			if (strcmp(&texts[stringOffsets[j]], string) == 0)
+			{
+				stringOffsets[i] = stringOffsets[j];
+				break;
+			}
+		}
+
+		if (j == i)
+		{
+			if ((textsLength + length) > LANGUAGE_PACK_TEXTS_MAX_LENGTH)
+			{
+				fprintf(stderr, "%s: texts longer than %d bytes\n", language->fileName, LANGUAGE_PACK_TEXTS_MAX_LENGTH);
+				return 0;
+			}
+
+			memcpy(&texts[textsLength], string, length);
+			stringOffsets[i] = textsLength;
+			textsLength += length;
+		}
+
+		putUint16(&offsets[i * sizeof(uint16_t)], stringOffsets[i]);
+	}
+
+	memcpy(buf, LANGUAGE_PACK_MAGIC, 4);
+	buf[4] = language->id;
+	buf[5] = 0; // reserved
+	putUint16(&buf[6], LANGUAGE_STRINGS_COUNT);
+	putUint16(&buf[8], textsLength);
+
+	return (sizeof(languagePackHeader_t) + (LANGUAGE_STRINGS_COUNT * sizeof(uint16_t)) + textsLength);
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t buf[8 + sizeof(languagePackHeader_t) + (LANGUAGE_STRINGS_COUNT * sizeof(uint16_t)) + LANGUAGE_PACK_TEXTS_MAX_LENGTH];
+	const char *outputDirectory;
+	bool withBlockHeader = false;
+	int errors = 0;
+
+	if ((argc == 3) && (strcmp(argv[1], "-block") == 0))
+	{
+		withBlockHeader = true;
+		outputDirectory = argv[2];
+	}
+	else if (argc == 2)
+	{
+		outputDirectory = argv[1];
+	}
+	else
+	{
+		fprintf(stderr, "Usage: %s [-block] <output directory>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (sizeof(languagePackHeader_t) != 10)
+	{
+		fprintf(stderr, "Unexpected languagePackHeader_t size\n");
+		return EXIT_FAILURE;
+	}
+
+	for (unsigned int l = 0; l < (sizeof(LANGUAGES) / sizeof(LANGUAGES[0])); l++)
+	{
+		int headerLength = (withBlockHeader ? 8 : 0);
+		int packLength = languagePackBuild(&LANGUAGES[l], &buf[headerLength]);
+		char fileName[1024];
+		FILE *f;
+
+		if (packLength == 0)
+		{
+			errors++;
+			continue;
+		}
+
+		if (withBlockHeader)
+		{
+			putUint32(&buf[0], CUSTOM_DATA_TYPE_LANGUAGE_PACK);
+			putUint32(&buf[4], packLength);
+		}
+
+		snprintf(fileName, sizeof(fileName), "%s/%s.oglp", outputDirectory, LANGUAGES[l].fileName);
+		if (((f = fopen(fileName, "wb")) == NULL) || (fwrite(buf, 1, (headerLength + packLength), f) != (size_t)(headerLength + packLength)))
+		{
+			perror(fileName);
+			errors++;
+		}
+		else
+		{
+			printf("%-40s id %2d, %4d bytes (texts %4d)\n", fileName, LANGUAGES[l].id, packLength,
+					(packLength - (int)(sizeof(languagePackHeader_t) + (LANGUAGE_STRINGS_COUNT * sizeof(uint16_t)))));
+		}
+
+		if (f != NULL)
+		{
+			fclose(f);
+		}
+	}
+
+	return ((errors == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
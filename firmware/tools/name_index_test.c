@@ -0,0 +1,398 @@
+/*
+ * Copyright (C) 2020-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host check and benchmark of the name index module:
+ *  - contacts keypad prefix index (as used by the contacts cache): random inserts, updates and removes
+ *    of 1024 contacts, every query checked against a linear reference, then queries timed against a linear walk;
+ *  - DMR ID database callsign index search: 120000 records sorted by callsign, prefix queries checked against
+ *    a linear reference, with the number of record reads (flash reads on the radio) per query.
+ *
+ * Build and run (from the firmware directory):
+ *   gcc -O2 -Iinclude tools/name_index_test.c source/functions/nameIndex.c -o name_index_test && ./name_index_test
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include "functions/nameIndex.h"
+
+#define CONTACTS_MAX           1024
+#define CONTACTS_GROUPS           3 // TG, PC, ALL
+#define CONTACT_NAME_LENGTH      16
+#define CONTACTS_OPERATIONS   20000
+#define CONTACTS_QUERIES     200000
+
+#define IDS_COUNT            120000
+#define CALLSIGN_LENGTH           8
+#define IDS_QUERIES           20000
+
+typedef struct
+{
+	bool     used;
+	uint32_t group;
+	char     name[CONTACT_NAME_LENGTH]; // 0xFF filled, as in the codeplug
+} contact_t;
+
+static contact_t contacts[CONTACTS_MAX + 1]; // Contacts indexes are 1..1024
+static uint32_t indexEntries[CONTACTS_MAX];
+static nameIndex_t contactsIndex;
+static int failures = 0;
+
+static void randomName(char *name)
+{
+	static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789 -_.";
+	int length = (rand() % (CONTACT_NAME_LENGTH + 1));
+
+	memset(name, 0xFF, CONTACT_NAME_LENGTH);
+	for (int i = 0; i < length; i++)
+	{
+		// Few different first characters, so the prefixes collide
+		name[i] = ((i == 0) ? ("ABTWabtw0 "[rand() % 10]) : chars[rand() % (sizeof(chars) - 1)]);
+	}
+}
+
+// Reference keypad key, independent of nameIndexCharToKey(): 0xF after the end of the name
+static int referenceKey(const char *name, int i)
+{
+	static const char *keypad[10] = { " ", "", "ABC", "DEF", "GHI", "JKL", "MNO", "PQRS", "TUV", "WXYZ" };
+
+	for (int n = 0; n <= i; n++)
+	{
+		if ((name[n] == 0) || ((uint8_t)name[n] == 0xFF))
+		{
+			return 0xF;
+		}
+	}
+
+	char c = name[i];
+
+	if ((c >= '0') && (c <= '9'))
+	{
+		return (c - '0');
+	}
+
+	if ((c >= 'a') && (c <= 'z'))
+	{
+		c -= ('a' - 'A');
+	}
+
+	for (int k = 0; k < 10; k++)
+	{
+		if ((c != 0) && (strchr(keypad[k], c) != NULL))
+		{
+			return k;
+		}
+	}
+
+	return 1;
+}
+
+// First contact of the group whose name keys start with keys, ordered by (4 keys, contact index), or -1
+static int referenceFindByKeys(uint32_t group, const char *keys, int numKeys)
+{
+	int best = -1;
+	uint32_t bestOrder = 0;
+
+	for (int id = 1; id <= CONTACTS_MAX; id++)
+	{
+		if ((contacts[id].used == false) || (contacts[id].group != group))
+		{
+			continue;
+		}
+
+		uint32_t order = 0;
+		bool matches = true;
+
+		for (int i = 0; i < NAME_INDEX_KEYS_MAX; i++)
+		{
+			int key = referenceKey(contacts[id].name, i);
+
+			if ((i < numKeys) && (key != (keys[i] - '0')))
+			{
+				matches = false;
+				break;
+			}
+			order = (order << 4) | key;
+		}
+		order = (order << 11) | id;
+
+		if (matches && ((best == -1) || (order < bestOrder)))
+		{
+			best = id;
+			bestOrder = order;
+		}
+	}
+
+	return best;
+}
+
+static void randomKeys(char *keys, int *numKeys)
+{
+	*numKeys = 1 + (rand() % NAME_INDEX_KEYS_MAX);
+	for (int i = 0; i < *numKeys; i++)
+	{
+		keys[i] = '0' + (rand() % 10);
+	}
+}
+
+static void checkContacts(void)
+{
+	int checks = 0;
+
+	srand(1);
+	nameIndexInit(&contactsIndex, indexEntries, CONTACTS_MAX);
+
+	for (int op = 0; op < CONTACTS_OPERATIONS; op++)
+	{
+		int id = 1 + (rand() % CONTACTS_MAX);
+
+		if (contacts[id].used && ((rand() % 3) == 0))
+		{
+			// Remove
+			nameIndexRemove(&contactsIndex, id);
+			contacts[id].used = false;
+		}
+		else
+		{
+			// Insert, or update (remove then add, as the contacts cache does)
+			if (contacts[id].used)
+			{
+				nameIndexRemove(&contactsIndex, id);
+			}
+			contacts[id].used = true;
+			contacts[id].group = (rand() % CONTACTS_GROUPS);
+			randomName(contacts[id].name);
+
+			if (nameIndexAdd(&contactsIndex, contacts[id].group, contacts[id].name, id) == false)
+			{
+				printf("FAIL add of contact %d\n", id);
+				failures++;
+			}
+		}
+
+		for (int q = 0; q < 4; q++)
+		{
+			char keys[NAME_INDEX_KEYS_MAX];
+			int numKeys;
+			uint32_t group = (rand() % CONTACTS_GROUPS);
+
+			randomKeys(keys, &numKeys);
+
+			int found = nameIndexFindByKeys(&contactsIndex, group, keys, numKeys);
+			int expected = referenceFindByKeys(group, keys, numKeys);
+
+			if (found != expected)
+			{
+				if (failures < 10)
+				{
+					printf("FAIL group %u keys %.*s: %d (expected %d)\n", group, numKeys, keys, found, expected);
+				}
+				failures++;
+			}
+			checks++;
+		}
+	}
+
+	int used = 0;
+
+	for (int id = 1; id <= CONTACTS_MAX; id++)
+	{
+		used += (contacts[id].used ? 1 : 0);
+	}
+
+	if (contactsIndex.count != used)
+	{
+		printf("FAIL index holds %d entries, %d contacts\n", contactsIndex.count, used);
+		failures++;
+	}
+
+	printf("Contacts: %d operations, %d queries checked against the linear reference\n", CONTACTS_OPERATIONS, checks);
+}
+
+static void benchmarkContacts(void)
+{
+	// Fill all the contacts
+	nameIndexInit(&contactsIndex, indexEntries, CONTACTS_MAX);
+	for (int id = 1; id <= CONTACTS_MAX; id++)
+	{
+		contacts[id].used = true;
+		contacts[id].group = (rand() % CONTACTS_GROUPS);
+		randomName(contacts[id].name);
+		nameIndexAdd(&contactsIndex, contacts[id].group, contacts[id].name, id);
+	}
+
+	static char keys[CONTACTS_QUERIES][NAME_INDEX_KEYS_MAX];
+	static int numKeys[CONTACTS_QUERIES];
+	volatile int sink = 0;
+
+	for (int q = 0; q < CONTACTS_QUERIES; q++)
+	{
+		randomKeys(keys[q], &numKeys[q]);
+	}
+
+	clock_t start = clock();
+	for (int q = 0; q < CONTACTS_QUERIES; q++)
+	{
+		sink += nameIndexFindByKeys(&contactsIndex, (q % CONTACTS_GROUPS), keys[q], numKeys[q]);
+	}
+	double indexSeconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	start = clock();
+	for (int q = 0; q < (CONTACTS_QUERIES / 100); q++)
+	{
+		sink += referenceFindByKeys((q % CONTACTS_GROUPS), keys[q], numKeys[q]);
+	}
+	double linearSeconds = ((double)(clock() - start) / CLOCKS_PER_SEC) * 100;
+
+	printf("Contacts: %d prefix queries over %d contacts: index %.3f us/query, linear walk %.3f us/query\n", CONTACTS_QUERIES, CONTACTS_MAX,
+			(indexSeconds * 1e6) / CONTACTS_QUERIES, (linearSeconds * 1e6) / CONTACTS_QUERIES);
+	(void)sink;
+}
+
+typedef struct
+{
+	char     (*callsigns)[CALLSIGN_LENGTH + 1]; // Records, in DMR ID order
+	uint32_t *sortedRecords;                    // Records numbers in callsign order (the on-flash index)
+	uint32_t  reads;
+} idsDatabase_t;
+
+static idsDatabase_t ids;
+
+static int compareRecordsCallsigns(const void *a, const void *b)
+{
+	return strcasecmp(ids.callsigns[*(const uint32_t *)a], ids.callsigns[*(const uint32_t *)b]);
+}
+
+static bool idsReadName(void *context, uint32_t position, char *name, int nameLength)
+{
+	idsDatabase_t *db = (idsDatabase_t *)context;
+
+	db->reads += 2; // Index entry, then the record
+	strncpy(name, db->callsigns[db->sortedRecords[position]], nameLength);
+
+	return true;
+}
+
+static int32_t idsReferenceSearch(const char *prefix)
+{
+	for (uint32_t i = 0; i < IDS_COUNT; i++)
+	{
+		if (strncasecmp(ids.callsigns[ids.sortedRecords[i]], prefix, strlen(prefix)) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void checkIDs(void)
+{
+	static const char *prefixes[] = { "", "A", "B", "D", "E", "F", "G", "I", "J", "K", "M", "N", "O", "P", "S", "V", "W", "Z" };
+	uint32_t maxReads = 0;
+	uint64_t totalReads = 0;
+	int checks = 0;
+
+	ids.callsigns = malloc(IDS_COUNT * sizeof(ids.callsigns[0]));
+	ids.sortedRecords = malloc(IDS_COUNT * sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < IDS_COUNT; i++)
+	{
+		// Prefix (1 or 2 chars), digit, suffix (1 to 3 letters)
+		const char *prefix = prefixes[1 + (rand() % ((sizeof(prefixes) / sizeof(prefixes[0])) - 1))];
+		int suffixLength = 1 + (rand() % 3);
+		int n = snprintf(ids.callsigns[i], (CALLSIGN_LENGTH + 1), "%s%s%d", prefix, (((rand() % 2) == 0) ? "" : prefixes[1 + (rand() % 17)]), (rand() % 10));
+
+		for (int s = 0; (s < suffixLength) && (n < CALLSIGN_LENGTH); s++)
+		{
+			ids.callsigns[i][n++] = 'A' + (rand() % 26);
+		}
+		ids.callsigns[i][n] = 0;
+		ids.sortedRecords[i] = i;
+	}
+
+	qsort(ids.sortedRecords, IDS_COUNT, sizeof(uint32_t), compareRecordsCallsigns);
+
+	clock_t start = clock();
+	for (int q = 0; q < IDS_QUERIES; q++)
+	{
+		char prefix[CALLSIGN_LENGTH + 1];
+		const char *callsign = ids.callsigns[rand() % IDS_COUNT];
+		int length = 1 + (rand() % strlen(callsign));
+
+		strncpy(prefix, callsign, length);
+		prefix[length] = 0;
+		if ((q % 4) == 0)
+		{
+			prefix[length - 1] = 'Q'; // Often no match
+		}
+
+		ids.reads = 0;
+		int32_t found = nameIndexSearchSorted(IDS_COUNT, prefix, idsReadName, &ids);
+
+		totalReads += ids.reads;
+		if (ids.reads > maxReads)
+		{
+			maxReads = ids.reads;
+		}
+
+		if ((q % 20) == 0)
+		{
+			int32_t expected = idsReferenceSearch(prefix);
+
+			if (found != expected)
+			{
+				printf("FAIL callsign prefix %s: %d (expected %d)\n", prefix, found, expected);
+				failures++;
+			}
+			checks++;
+		}
+	}
+	double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+	printf("DMR IDs: %d records, %d prefix queries (%d checked against the linear reference)\n", IDS_COUNT, IDS_QUERIES, checks);
+	printf("DMR IDs: %.1f flash reads per query on average, %u max (host time %.3f ms/query, linear checks included)\n",
+			((double)totalReads / IDS_QUERIES), maxReads, ((seconds * 1e3) / IDS_QUERIES));
+	printf("DMR IDs: callsign index size %u bytes\n", (8 + (IDS_COUNT * 3)));
+
+	free(ids.callsigns);
+	free(ids.sortedRecords);
+}
+
+int main(void)
+{
+	checkContacts();
+	benchmarkContacts();
+	checkIDs();
+
+	printf("\n%s (%d failure%s)\n", ((failures == 0) ? "PASS" : "FAIL"), failures, ((failures == 1) ? "" : "s"));
+
+	return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
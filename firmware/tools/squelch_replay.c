@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2020-2023 Roger Clark, VK3KYY / G4KYF
+ *
+ *
+ * Redistribution and use in source and binary forms, with or without modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following disclaimer
+ *    in the documentation and/or other materials provided with the distribution.
+ *
+ * 3. Neither the name of the copyright holder nor the names of its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * 4. Use of this source code or binary releases for commercial purposes is strictly forbidden. This includes, without limitation,
+ *    incorporation in a commercial product or incorporation into a product or project which allows commercial use.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ * ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/*
+ * Host replay of the squelch module: feeds a recorded radio status trace to squelchUpdate(), and to the
+ * previous plain threshold (noise < level) for comparison, then prints the open latency and chatter counts.
+ *
+ * Build (from the firmware directory):
+ *   gcc -O2 -Iinclude tools/squelch_replay.c source/functions/squelch.c -o squelch_replay
+ *
+ * Usage:
+ *   squelch_replay <level> <trace.csv>    replays a recorded trace
+ *   squelch_replay <level> -synthetic     replays a generated trace (noisy carrier around the level)
+ *
+ * Trace format, one sample per line ('#' starts a comment):
+ *   time_ms,noise,rssi,signal
+ * noise and rssi are the AT1846S 0x1b register values (rssi is only reported, the squelch doesn't use it),
+ * signal is 1 while a carrier is known to be present (ground truth), 0 otherwise.
+ *
+ * Reported per decoder:
+ *   opens/closes   squelch transitions
+ *   latency        time from a carrier start to the squelch opening (average and max, ms)
+ *   missed         carriers during which the squelch never opened
+ *   chatter        extra transitions: closes while the carrier is present, opens while it isn't
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "functions/squelch.h"
+
+#define TRACE_MAX_SAMPLES    200000
+
+typedef struct
+{
+	uint32_t time;
+	uint8_t  noise;
+	uint8_t  rssi;
+	bool     signal;
+} traceSample_t;
+
+typedef struct
+{
+	const char *name;
+	bool        open;
+	uint32_t    opens;
+	uint32_t    closes;
+	uint32_t    chatter;
+	uint32_t    carriers;
+	uint32_t    missed;
+	uint32_t    latencySum;
+	uint32_t    latencyMax;
+	uint32_t    carrierStart;
+	bool        openedInCarrier;
+} replayStats_t;
+
+static traceSample_t trace[TRACE_MAX_SAMPLES];
+static int traceLength = 0;
+
+static bool traceLoad(const char *filename)
+{
+	FILE *f = fopen(filename, "r");
+	char line[128];
+
+	if (f == NULL)
+	{
+		perror(filename);
+		return false;
+	}
+
+	while ((fgets(line, sizeof(line), f) != NULL) && (traceLength < TRACE_MAX_SAMPLES))
+	{
+		unsigned int time, noise, rssi, signal;
+
+		if ((line[0] == '#') || (sscanf(line, "%u,%u,%u,%u", &time, &noise, &rssi, &signal) != 4))
+		{
+			continue;
+		}
+
+		trace[traceLength].time = time;
+		trace[traceLength].noise = (uint8_t)((noise > 255) ? 255 : noise);
+		trace[traceLength].rssi = (uint8_t)((rssi > 255) ? 255 : rssi);
+		trace[traceLength].signal = (signal != 0);
+		traceLength++;
+	}
+
+	fclose(f);
+
+	return (traceLength > 0);
+}
+
+// Carriers of various strengths, some of them close to the level, sampled every 10ms
+static void traceGenerate(uint8_t level)
+{
+	const int carrierNoise[] = { -30, -12, -6, -3, -1, -6, -20, -4 };
+	uint32_t time = 0;
+
+	srand(1);
+	for (int c = 0; c < (int)(sizeof(carrierNoise) / sizeof(carrierNoise[0])); c++)
+	{
+		for (int phase = 0; phase < 2; phase++)
+		{
+			bool signal = (phase == 1);
+			int samples = (signal ? 150 : 100);
+
+			for (int i = 0; (i < samples) && (traceLength < TRACE_MAX_SAMPLES); i++)
+			{
+				int noise = level + (signal ? carrierNoise[c] : 15) + ((rand() % 13) - 6);
+
+				trace[traceLength].time = time;
+				trace[traceLength].noise = (uint8_t)((noise < 0) ? 0 : ((noise > 255) ? 255 : noise));
+				trace[traceLength].rssi = (uint8_t)(signal ? (100 - noise / 2) : 40);
+				trace[traceLength].signal = signal;
+				traceLength++;
+				time += 10;
+			}
+		}
+	}
+}
+
+static void replayStatsUpdate(replayStats_t *stats, const traceSample_t *sample, bool previousSignal, bool open)
+{
+	if (sample->signal && (previousSignal == false))
+	{
+		stats->carriers++;
+		stats->carrierStart = sample->time;
+		stats->openedInCarrier = stats->open; // Already open, no latency
+	}
+	else if ((sample->signal == false) && previousSignal && (stats->openedInCarrier == false))
+	{
+		stats->missed++;
+	}
+
+	if (open != stats->open)
+	{
+		if (open)
+		{
+			stats->opens++;
+
+			if (sample->signal == false)
+			{
+				stats->chatter++;
+			}
+			else if (stats->openedInCarrier == false)
+			{
+				uint32_t latency = sample->time - stats->carrierStart;
+
+				stats->latencySum += latency;
+				if (latency > stats->latencyMax)
+				{
+					stats->latencyMax = latency;
+				}
+			}
+			else
+			{
+				stats->chatter++; // Reopened after a close during the same carrier
+			}
+
+			if (sample->signal)
+			{
+				stats->openedInCarrier = true;
+			}
+		}
+		else
+		{
+			stats->closes++;
+
+			if (sample->signal)
+			{
+				stats->chatter++;
+			}
+		}
+
+		stats->open = open;
+	}
+}
+
+static void replayStatsPrint(const replayStats_t *stats)
+{
+	uint32_t opened = stats->carriers - stats->missed;
+
+	printf("%-12s opens %5u  closes %5u  latency avg %5u ms max %5u ms  missed %3u/%-3u  chatter %5u\n",
+			stats->name, stats->opens, stats->closes, ((opened > 0) ? (stats->latencySum / opened) : 0), stats->latencyMax,
+			stats->missed, stats->carriers, stats->chatter);
+}
+
+int main(int argc, char **argv)
+{
+	replayStats_t filteredStats = { .name = "filtered" };
+	replayStats_t thresholdStats = { .name = "threshold" };
+	squelchState_t sq;
+	bool previousSignal = false;
+	uint8_t level;
+
+	if (argc != 3)
+	{
+		fprintf(stderr, "Usage: %s <level> <trace.csv | -synthetic>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	level = (uint8_t)atoi(argv[1]);
+
+	if (strcmp(argv[2], "-synthetic") == 0)
+	{
+		traceGenerate(level);
+	}
+	else if (traceLoad(argv[2]) == false)
+	{
+		fprintf(stderr, "No samples in %s\n", argv[2]);
+		return EXIT_FAILURE;
+	}
+
+	squelchInit(&sq);
+
+	for (int i = 0; i < traceLength; i++)
+	{
+		bool filteredOpen = squelchUpdate(&sq, trace[i].noise, level);
+		bool thresholdOpen = (trace[i].noise < level);
+
+		replayStatsUpdate(&filteredStats, &trace[i], previousSignal, filteredOpen);
+		replayStatsUpdate(&thresholdStats, &trace[i], previousSignal, thresholdOpen);
+		previousSignal = trace[i].signal;
+	}
+
+	// A carrier still present at the end of the trace
+	if (previousSignal)
+	{
+		traceSample_t end = trace[traceLength - 1];
+
+		end.signal = false;
+		replayStatsUpdate(&filteredStats, &end, true, filteredStats.open);
+		replayStatsUpdate(&thresholdStats, &end, true, thresholdStats.open);
+	}
+
+	printf("%d samples, %u ms, level %u\n", traceLength, (trace[traceLength - 1].time - trace[0].time), level);
+	replayStatsPrint(&filteredStats);
+	replayStatsPrint(&thresholdStats);
+
+	return EXIT_SUCCESS;
+}